@@ -0,0 +1,148 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <getopt.h>
+
+#include "iohints-event-trace.h"
+
+// Names and categories of the event types, in the order of enum event_type
+static const char *event_type_names[] = {"read", "fadvise", "ladvise", "aio", "io_uring", "madvise", "write", "sync_file_range", "fdatasync"};
+static const char *event_type_categories[] = {"read", "hint", "hint", "hint", "hint", "hint", "write", "hint", "write"};
+
+enum output_format {
+    OUTPUT_FORMAT_CSV,
+    OUTPUT_FORMAT_CHROME,
+};
+
+// Read a whole event trace, and return how many events it holds
+static uint64_t event_trace_load(const char *path, struct event_record **records);
+
+// One event per line, timestamps in us from the first event
+static void print_csv(FILE *output_file, const struct event_record *records, uint64_t record_count, uint64_t origin_ns);
+
+// Chrome trace event format (chrome://tracing, Perfetto): one process per configuration, one track per thread
+static void print_chrome(FILE *output_file, const struct event_record *records, uint64_t record_count, uint64_t origin_ns);
+
+static void print_usage(const char *program){
+    printf("Usage: %s [options] TRACE\n"
+        "  -f, --format=FORMAT             csv or chrome (default: csv)\n"
+        "  -o, --output=PATH               output file (default: standard output)\n"
+        "  -h, --help                      print this help\n",
+        program);
+}
+
+static const struct option long_options[] = {
+    {"format", required_argument, 0, 'f'},
+    {"output", required_argument, 0, 'o'},
+    {"help", no_argument, 0, 'h'},
+    {0, 0, 0, 0}
+};
+
+int main(int argc, char **argv){
+    enum output_format format = OUTPUT_FORMAT_CSV;
+    const char *output_file_path = NULL;
+    int option;
+    while((option = getopt_long(argc, argv, "f:o:h", long_options, NULL)) != -1){
+        switch(option){
+            case 'f':
+                if(strcmp(optarg, "csv")==0) format = OUTPUT_FORMAT_CSV;
+                else if(strcmp(optarg, "chrome")==0) format = OUTPUT_FORMAT_CHROME;
+                else{
+                    printf("Unknown format \"%s\", expected csv or chrome\n", optarg);
+                    exit(0);
+                }
+                break;
+            case 'o':
+                output_file_path = optarg;
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                exit(0);
+            default:
+                exit(0);
+        }
+    }
+    if(optind!=argc-1){
+        print_usage(argv[0]);
+        exit(0);
+    }
+
+    struct event_record *records;
+    uint64_t record_count = event_trace_load(argv[optind], &records);
+    FILE *output_file = stdout;
+    if(output_file_path){
+        output_file = fopen(output_file_path, "w");
+        if(output_file == NULL){
+            printf("Error opening file \"%s\": %s\n", output_file_path, strerror(errno));
+            exit(0);
+        }
+    }
+
+    // Threads flush their events separately, so the earliest event is not necessarily the first one of the file
+    uint64_t origin_ns = UINT64_MAX;
+    for(uint64_t r = 0; r<record_count; r++) if(records[r].start_ns<origin_ns) origin_ns = records[r].start_ns;
+    if(format==OUTPUT_FORMAT_CSV) print_csv(output_file, records, record_count, origin_ns);
+    else print_chrome(output_file, records, record_count, origin_ns);
+    if(output_file!=stdout) fclose(output_file);
+    free(records);
+}
+
+// Read a whole event trace, and return how many events it holds
+static uint64_t event_trace_load(const char *path, struct event_record **records){
+    FILE *fp = fopen(path, "rb");
+    if(fp == NULL){
+        printf("Error opening file \"%s\": %s\n", path, strerror(errno));
+        exit(0);
+    }
+    char magic[8];
+    if(fread(magic, sizeof(char), 8, fp)!=8 || memcmp(magic, EVENT_TRACE_MAGIC, 8)!=0){
+        printf("\"%s\" is not an event trace\n", path);
+        exit(0);
+    }
+    fseek(fp, 0, SEEK_END);
+    uint64_t record_count = (ftell(fp)-8)/sizeof(struct event_record);
+    fseek(fp, 8, SEEK_SET);
+    *records = malloc(sizeof(struct event_record)*(record_count>0 ? record_count : 1));
+    if(fread(*records, sizeof(struct event_record), record_count, fp)!=record_count){
+        printf("Error reading file \"%s\": %s\n", path, strerror(errno));
+        exit(0);
+    }
+    fclose(fp);
+    for(uint64_t r = 0; r<record_count; r++){
+        if((*records)[r].type>=EVENT_TYPE_COUNT){
+            printf("Unknown event type %u in \"%s\"\n", (*records)[r].type, path);
+            exit(0);
+        }
+    }
+    return record_count;
+}
+
+// One event per line, timestamps in us from the first event
+static void print_csv(FILE *output_file, const struct event_record *records, uint64_t record_count, uint64_t origin_ns){
+    fprintf(output_file, "configuration,thread,type,start_us,end_us,duration_us,offset,size,result\n");
+    for(uint64_t r = 0; r<record_count; r++){
+        const struct event_record *record = &records[r];
+        fprintf(output_file, "%u,%u,%s,%.3f,%.3f,%.3f,%llu,%llu,%lld\n", record->configuration, record->thread, event_type_names[record->type],
+            (record->start_ns-origin_ns)*1e-3, (record->end_ns-origin_ns)*1e-3, (record->end_ns-record->start_ns)*1e-3,
+            (unsigned long long)record->offset, (unsigned long long)record->size, (long long)record->result);
+    }
+}
+
+// Chrome trace event format (chrome://tracing, Perfetto): one process per configuration, one track per thread
+static void print_chrome(FILE *output_file, const struct event_record *records, uint64_t record_count, uint64_t origin_ns){
+    fprintf(output_file, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    for(uint64_t r = 0; r<record_count; r++){
+        const struct event_record *record = &records[r];
+        fprintf(output_file, "%s{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": %u, \"tid\": %u, "
+            "\"args\": {\"offset\": %llu, \"size\": %llu, \"result\": %lld}}", r>0 ? ",\n" : "",
+            event_type_names[record->type], event_type_categories[record->type], (record->start_ns-origin_ns)*1e-3,
+            (record->end_ns-record->start_ns)*1e-3, record->configuration, record->thread,
+            (unsigned long long)record->offset, (unsigned long long)record->size, (long long)record->result);
+    }
+    fprintf(output_file, "\n]}\n");
+}
@@ -0,0 +1,34 @@
+#ifndef IOHINTS_EVENT_TRACE_H
+#define IOHINTS_EVENT_TRACE_H
+
+#include <stdint.h>
+
+// Format of the event traces the benchmarks write with --event-trace, and event-trace-decoder reads. Trace files start with these
+// 8 bytes, followed by native-endian struct event_record
+#define EVENT_TRACE_MAGIC "IOHEVENT"
+
+// Kinds of events of the event trace
+enum event_type {
+    EVENT_READ,          // A read of the benchmark, from its submission (or when it was due, for paced reads) to its completion
+    EVENT_HINT_FADVISE,  // The hints below span the call that issued them, not the I/O they trigger
+    EVENT_HINT_LADVISE,
+    EVENT_HINT_AIO,
+    EVENT_HINT_IO_URING,
+    EVENT_HINT_MADVISE,
+    EVENT_WRITE,                 // A write of the write benchmark, timed like reads
+    EVENT_HINT_SYNC_FILE_RANGE,
+    EVENT_FDATASYNC,             // The final flush of a write experiment
+    EVENT_TYPE_COUNT
+};
+
+// A single event of the event trace, as written to the trace file
+struct event_record {
+    uint64_t start_ns, end_ns;
+    uint64_t offset, size;
+    int64_t result; // Bytes returned by reads, return value of hints
+    uint32_t configuration; // Row of the configuration in the output file, starting at 1
+    uint16_t thread; // 0 for the main thread, then 1 + the index of the reader thread
+    uint16_t type; // enum event_type
+};
+
+#endif
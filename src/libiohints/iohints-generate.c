@@ -0,0 +1,131 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+#include "iohints-generate.h"
+
+// A writer thread of the file generator, which writes every thread_count-th chunk of the file starting from its id
+struct iohints_generate_thread {
+    pthread_t thread;
+    int id, thread_count;
+    int direct_fd, buffered_fd; // direct_fd is -1 when the file system does not support O_DIRECT
+    uint64_t file_size, block_size;
+    int error; // errno of the write that failed, 0 when every write succeeded
+};
+
+// Size of the logical blocks direct I/Os must be aligned on, from the block device of the file when it has one
+static uint64_t iohints_generate_block_size(int fd){
+    struct stat st;
+    if(fstat(fd, &st)<0) return sysconf(_SC_PAGESIZE);
+
+    // The queue directory only exists for whole disks, so partitions have to look at their parent
+    const char *candidates[] = {"/sys/dev/block/%u:%u/queue/logical_block_size", "/sys/dev/block/%u:%u/../queue/logical_block_size"};
+    for(int i = 0; i<2; i++){
+        char path[128];
+        snprintf(path, sizeof(path), candidates[i], major(st.st_dev), minor(st.st_dev));
+        FILE *fp = fopen(path, "r");
+        if(fp == NULL) continue;
+        unsigned long long block_size = 0;
+        int ret = fscanf(fp, "%llu", &block_size);
+        fclose(fp);
+        if(ret == 1 && block_size > 0) return block_size;
+    }
+
+    // Network file systems (Lustre, GPFS...) have no backing block device, but accept page aligned direct I/Os
+    return sysconf(_SC_PAGESIZE);
+}
+
+// Fill a buffer with the content iohints_generate_file writes at an offset (a multiple of 8)
+void iohints_generate_fill(uint64_t *buffer, uint64_t offset, uint64_t length){
+    for(uint64_t w = 0; w<(length+7)/8; w++){
+        uint64_t z = IOHINTS_GENERATE_SEED+(offset/8+w)*0x9e3779b97f4a7c15ull; // splitmix64 of the word index
+        z = (z^(z >> 30))*0xbf58476d1ce4e5b9ull;
+        z = (z^(z >> 27))*0x94d049bb133111ebull;
+        buffer[w] = z^(z >> 31);
+    }
+}
+
+// Body of a writer thread of the file generator
+static void *iohints_generate_thread_main(void *arg){
+    struct iohints_generate_thread *generator = arg;
+    uint64_t *buffer;
+    generator->error = posix_memalign((void **)&buffer, sysconf(_SC_PAGESIZE), IOHINTS_GENERATE_WRITE_SIZE);
+    if(generator->error) return NULL;
+    for(uint64_t offset = generator->id*(uint64_t)IOHINTS_GENERATE_WRITE_SIZE; offset<generator->file_size; offset += generator->thread_count*(uint64_t)IOHINTS_GENERATE_WRITE_SIZE){
+        uint64_t length = generator->file_size-offset<IOHINTS_GENERATE_WRITE_SIZE ? generator->file_size-offset : IOHINTS_GENERATE_WRITE_SIZE;
+        iohints_generate_fill(buffer, offset, length);
+
+        // Direct writes must cover whole logical blocks, so an unaligned tail goes through the page cache
+        int fd = generator->direct_fd>=0 && length%generator->block_size==0 ? generator->direct_fd : generator->buffered_fd;
+        for(uint64_t done = 0; done<length;){
+            ssize_t ret = pwrite(fd, (char *)buffer+done, length-done, offset+done);
+            if(ret<0){
+                generator->error = errno;
+                free(buffer);
+                return NULL;
+            }
+            done += ret;
+        }
+    }
+    free(buffer);
+    return NULL;
+}
+
+// Create a file with fallocate, and fill its first file_size bytes with deterministic content from several threads using large
+// direct writes, or buffered ones when the file system does not support O_DIRECT. Returns the number of threads that wrote the
+// file, or -1 with errno set
+int iohints_generate_file(const char *path, uint64_t file_size){
+    int buffered_fd = open(path, O_WRONLY | O_CREAT, 0644);
+    if(buffered_fd<0) return -1;
+
+    // Allocating every block up front fails early when the disk is too small, and keeps the file contiguous. File systems
+    // without fallocate allocate the blocks as they are written
+    if(fallocate(buffered_fd, 0, 0, file_size)<0 && errno!=EOPNOTSUPP){
+        int error = errno;
+        close(buffered_fd);
+        errno = error;
+        return -1;
+    }
+    int direct_fd = open(path, O_WRONLY | O_DIRECT);
+
+    // Filling the file from several threads, each writing its own chunks
+    int thread_count = sysconf(_SC_NPROCESSORS_ONLN);
+    if(thread_count>IOHINTS_GENERATE_MAX_THREADS) thread_count = IOHINTS_GENERATE_MAX_THREADS;
+    if((uint64_t)thread_count>(file_size+IOHINTS_GENERATE_WRITE_SIZE-1)/IOHINTS_GENERATE_WRITE_SIZE) thread_count = (file_size+IOHINTS_GENERATE_WRITE_SIZE-1)/IOHINTS_GENERATE_WRITE_SIZE;
+    if(thread_count<1) thread_count = 1;
+    struct iohints_generate_thread *generators = calloc(thread_count, sizeof(struct iohints_generate_thread));
+    uint64_t block_size = iohints_generate_block_size(buffered_fd);
+    int error = 0, started_count;
+    for(started_count = 0; started_count<thread_count; started_count++){
+        struct iohints_generate_thread *generator = &generators[started_count];
+        generator->id = started_count;
+        generator->thread_count = thread_count;
+        generator->direct_fd = direct_fd;
+        generator->buffered_fd = buffered_fd;
+        generator->file_size = file_size;
+        generator->block_size = block_size;
+        error = pthread_create(&generator->thread, NULL, iohints_generate_thread_main, generator);
+        if(error) break;
+    }
+    for(int t = 0; t<started_count; t++){
+        pthread_join(generators[t].thread, NULL);
+        if(error==0) error = generators[t].error;
+    }
+    if(error==0 && fsync(buffered_fd)<0) error = errno;
+    if(direct_fd>=0) close(direct_fd);
+    close(buffered_fd);
+    free(generators);
+    if(error){
+        errno = error;
+        return -1;
+    }
+    return thread_count;
+}
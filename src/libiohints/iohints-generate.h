@@ -0,0 +1,21 @@
+#ifndef IOHINTS_GENERATE_H
+#define IOHINTS_GENERATE_H
+
+#include <stdint.h>
+
+// Size of each direct write of the file generator, and how many threads issue them at most (each has its own buffer)
+#define IOHINTS_GENERATE_WRITE_SIZE (16*1024*1024) // 16 MB
+#define IOHINTS_GENERATE_MAX_THREADS 16
+
+// Seed of the content of generated files. Every 8 bytes word is derived from its offset, so that any block can be recomputed
+#define IOHINTS_GENERATE_SEED 0x243f6a8885a308d3ull
+
+// Fill a buffer with the content iohints_generate_file writes at an offset (a multiple of 8)
+void iohints_generate_fill(uint64_t *buffer, uint64_t offset, uint64_t length);
+
+// Create a file with fallocate, and fill its first file_size bytes with deterministic content from several threads using large
+// direct writes, or buffered ones when the file system does not support O_DIRECT. Returns the number of threads that wrote the
+// file, or -1 with errno set
+int iohints_generate_file(const char *path, uint64_t file_size);
+
+#endif
@@ -0,0 +1,471 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "iohints.h"
+
+// LD_PRELOAD interposer giving prefetch hints to unmodified applications. read, pread, fread and lseek calls are followed
+// per file descriptor, and once a stream of accesses is found to go forward, backward or with a constant stride, the
+// data it is about to read is hinted ahead of it. Closing a file descriptor, through close, fclose, dup2, dup3 or
+// close_range, forgets its streams and cancels its asynchronous prefetches. Configured through the environment:
+//   IOHINTS_PRELOAD_HINT=none|fadvise|aio|readahead  hint given to the streams (default: fadvise). none only follows them
+//   IOHINTS_PRELOAD_WINDOW=SIZE                      how far ahead of a stream data is hinted, K/M/G suffixes (default: 16M)
+//   IOHINTS_PRELOAD_VERBOSE=1                        print how many calls were intercepted and hints given at exit
+
+// File descriptors above this one are not followed
+#define PRELOAD_MAX_FDS 4096
+
+// Streams followed at the same time on a single file descriptor, enough for the interleaved pattern of the benchmarks.
+// When more streams read the file, the least recently used one is forgotten
+#define PRELOAD_STREAMS_PER_FD 16
+
+// Accesses following the same stride before a stream is hinted
+#define PRELOAD_MIN_RUN 2
+
+// Default distance ahead of a stream that is hinted, as the online strategies of the trace replay. Streams start with a
+// smaller window, which doubles with every access that follows them
+#define PRELOAD_WINDOW_SIZE (16*1024*1024) // 16 MB
+
+// A stream hints at most this many non contiguous ranges at once, so that a long stride of small accesses does not
+// flood the page cache with hints
+#define PRELOAD_MAX_RANGES 64
+
+// Asynchronous prefetches a file descriptor holds the handles of at most. Once they are all taken, those that are over are
+// given back, or the oldest one is waited for
+#define PRELOAD_PREFETCHES_PER_FD 64
+
+#ifndef CLOSE_RANGE_CLOEXEC
+#define CLOSE_RANGE_CLOEXEC (1U << 2)
+#endif
+
+enum preload_hint {
+    PRELOAD_HINT_NONE,
+    PRELOAD_HINT_FADVISE,
+    PRELOAD_HINT_AIO,
+    PRELOAD_HINT_READAHEAD,
+};
+static const char *preload_hint_names[] = {"none", "fadvise", "aio", "readahead"};
+
+// Accesses of a file descriptor that follow each other with a constant stride
+struct preload_stream {
+    uint64_t last_offset, last_size;
+    bool forward; // Each access starts where the previous one ended
+    int64_t stride; // Between the starts of two accesses of other streams, 0 until the second one
+    uint64_t run; // Accesses that followed the stream in a row
+    uint64_t hinted_until; // Forward streams: end of the hinted window
+    int64_t next_hint; // Other streams: start of the next access to hint
+    uint64_t last_use;
+};
+
+// What is known of a file descriptor. Only regular files opened for reading without O_DIRECT are followed. The mutexes
+// are left zeroed, which glibc takes as PTHREAD_MUTEX_INITIALIZER
+struct preload_fd {
+    pthread_mutex_t mutex;
+    bool checked, followed;
+    uint64_t file_size;
+    uint64_t position; // File offset of read, as moved by read and lseek
+    uint64_t generation; // Bumped by lseek and when the descriptor is forgotten, so that reads in flight leave the new position alone
+    uint64_t use_count;
+    struct preload_stream streams[PRELOAD_STREAMS_PER_FD];
+    struct iohints_prefetch *prefetches[PRELOAD_PREFETCHES_PER_FD]; // Asynchronous prefetches that may still be reading the file
+    int prefetch_count;
+};
+static struct preload_fd preload_fds[PRELOAD_MAX_FDS];
+
+static enum preload_hint preload_hint = PRELOAD_HINT_FADVISE;
+static uint64_t preload_window_size = PRELOAD_WINDOW_SIZE;
+
+// Counters printed at exit in verbose mode
+static uint64_t preload_call_count = 0, preload_stream_count = 0, preload_hint_count = 0, preload_hinted_bytes = 0;
+
+// The functions of the C library this one stands in front of
+static int (*real_open)(const char *, int, ...) = NULL;
+static int (*real_open64)(const char *, int, ...) = NULL;
+static int (*real_close)(int) = NULL;
+static int (*real_dup2)(int, int) = NULL;
+static int (*real_dup3)(int, int, int) = NULL;
+static int (*real_close_range)(unsigned int, unsigned int, int) = NULL;
+static ssize_t (*real_read)(int, void *, size_t) = NULL;
+static ssize_t (*real_pread)(int, void *, size_t, off_t) = NULL;
+static ssize_t (*real_pread64)(int, void *, size_t, off64_t) = NULL;
+static off_t (*real_lseek)(int, off_t, int) = NULL;
+static off64_t (*real_lseek64)(int, off64_t, int) = NULL;
+static size_t (*real_fread)(void *, size_t, size_t, FILE *) = NULL;
+static int (*real_fclose)(FILE *) = NULL;
+
+// Look up the functions of the C library, and read the configuration. Also done lazily, as other constructors may read files before this one runs
+static void preload_init();
+
+// Lock the state of a file descriptor, checking whether it is worth following the first time. Returns NULL when it is not followed
+static inline struct preload_fd *preload_fd_acquire(int fd);
+
+// Unlock the state of a file descriptor
+static inline void preload_fd_release(struct preload_fd *state);
+
+// Forget a file descriptor, which is being closed or reused. Its asynchronous prefetches are cancelled and waited for, as
+// they would otherwise keep reading whatever file the descriptor refers to next
+static inline void preload_fd_forget(int fd);
+
+// Record an access of size bytes at offset, and hint what the stream it belongs to reads next
+static inline void preload_access(int fd, struct preload_fd *state, uint64_t offset, uint64_t size);
+
+// Give the configured hint on a range
+static inline void preload_hint_range(int fd, struct preload_fd *state, uint64_t offset, uint64_t length);
+
+// Parse a size with an optional K, M or G suffix
+static uint64_t preload_parse_size(const char *value);
+
+// Print the counters, in verbose mode
+static void preload_fini();
+
+int open(const char *path, int flags, ...){
+    preload_init();
+    mode_t mode = 0;
+    if((flags & O_CREAT) || (flags & O_TMPFILE)==O_TMPFILE){
+        va_list args;
+        va_start(args, flags);
+        mode = va_arg(args, int);
+        va_end(args);
+    }
+    int fd = real_open(path, flags, mode);
+    if(fd>=0) preload_fd_forget(fd);
+    return fd;
+}
+
+int open64(const char *path, int flags, ...){
+    preload_init();
+    mode_t mode = 0;
+    if((flags & O_CREAT) || (flags & O_TMPFILE)==O_TMPFILE){
+        va_list args;
+        va_start(args, flags);
+        mode = va_arg(args, int);
+        va_end(args);
+    }
+    int fd = real_open64(path, flags, mode);
+    if(fd>=0) preload_fd_forget(fd);
+    return fd;
+}
+
+int close(int fd){
+    preload_init();
+    preload_fd_forget(fd);
+    return real_close(fd);
+}
+
+// dup2 and dup3 close the new file descriptor when it is open, and close_range closes a whole range of them
+int dup2(int fd, int new_fd){
+    preload_init();
+    if(fd!=new_fd) preload_fd_forget(new_fd);
+    return real_dup2(fd, new_fd);
+}
+
+int dup3(int fd, int new_fd, int flags){
+    preload_init();
+    if(fd!=new_fd) preload_fd_forget(new_fd);
+    return real_dup3(fd, new_fd, flags);
+}
+
+int close_range(unsigned int first_fd, unsigned int last_fd, int flags){
+    preload_init();
+    if(!(flags & CLOSE_RANGE_CLOEXEC)){
+        for(unsigned int fd = first_fd; fd<=last_fd && fd<PRELOAD_MAX_FDS; fd++) preload_fd_forget(fd);
+    }
+    return real_close_range(first_fd, last_fd, flags);
+}
+
+ssize_t read(int fd, void *buffer, size_t count){
+    preload_init();
+    struct preload_fd *state = preload_fd_acquire(fd);
+    if(state==NULL) return real_read(fd, buffer, count);
+
+    // The hints go before the read, so that they are in flight while it waits. The position moves past the whole read right
+    // away, so that concurrent reads hint what comes next, and moves back once a short read returns
+    preload_access(fd, state, state->position, count);
+    state->position += count;
+    uint64_t generation = state->generation;
+    preload_fd_release(state);
+    ssize_t ret = real_read(fd, buffer, count);
+    if(ret<(ssize_t)count){
+        state = preload_fd_acquire(fd);
+        if(state==NULL) return ret;
+        if(state->generation==generation) state->position -= count-(ret>0 ? ret : 0);
+        preload_fd_release(state);
+    }
+    return ret;
+}
+
+ssize_t pread(int fd, void *buffer, size_t count, off_t offset){
+    preload_init();
+    struct preload_fd *state = preload_fd_acquire(fd);
+    if(state!=NULL){
+        preload_access(fd, state, offset, count);
+        preload_fd_release(state);
+    }
+    return real_pread(fd, buffer, count, offset);
+}
+
+ssize_t pread64(int fd, void *buffer, size_t count, off64_t offset){
+    preload_init();
+    struct preload_fd *state = preload_fd_acquire(fd);
+    if(state!=NULL){
+        preload_access(fd, state, offset, count);
+        preload_fd_release(state);
+    }
+    return real_pread64(fd, buffer, count, offset);
+}
+
+off_t lseek(int fd, off_t offset, int whence){
+    preload_init();
+    struct preload_fd *state = preload_fd_acquire(fd);
+    off_t ret = real_lseek(fd, offset, whence);
+    if(state!=NULL){
+        if(ret>=0) state->position = ret;
+        state->generation++;
+        preload_fd_release(state);
+    }
+    return ret;
+}
+
+off64_t lseek64(int fd, off64_t offset, int whence){
+    preload_init();
+    struct preload_fd *state = preload_fd_acquire(fd);
+    off64_t ret = real_lseek64(fd, offset, whence);
+    if(state!=NULL){
+        if(ret>=0) state->position = ret;
+        state->generation++;
+        preload_fd_release(state);
+    }
+    return ret;
+}
+
+// The C library reads the file for stdio through internal calls, so stream accesses are followed at the position of the stream
+size_t fread(void *buffer, size_t size, size_t count, FILE *stream){
+    preload_init();
+    int fd = fileno(stream);
+    struct preload_fd *state = fd>=0 ? preload_fd_acquire(fd) : NULL;
+    if(state!=NULL){
+        off_t offset = ftello(stream);
+        if(offset>=0) preload_access(fd, state, offset, size*count);
+        preload_fd_release(state);
+    }
+    return real_fread(buffer, size, count, stream);
+}
+
+// fclose closes the file descriptor through an internal call as well
+int fclose(FILE *stream){
+    preload_init();
+    preload_fd_forget(fileno(stream));
+    return real_fclose(stream);
+}
+
+// Look up the functions of the C library, and read the configuration
+__attribute__((constructor)) static void preload_init(){
+    if(__atomic_load_n(&real_fclose, __ATOMIC_ACQUIRE)!=NULL) return;
+    real_open = dlsym(RTLD_NEXT, "open");
+    real_open64 = dlsym(RTLD_NEXT, "open64");
+    real_close = dlsym(RTLD_NEXT, "close");
+    real_dup2 = dlsym(RTLD_NEXT, "dup2");
+    real_dup3 = dlsym(RTLD_NEXT, "dup3");
+    real_close_range = dlsym(RTLD_NEXT, "close_range");
+    real_read = dlsym(RTLD_NEXT, "read");
+    real_pread = dlsym(RTLD_NEXT, "pread");
+    real_pread64 = dlsym(RTLD_NEXT, "pread64");
+    real_lseek = dlsym(RTLD_NEXT, "lseek");
+    real_lseek64 = dlsym(RTLD_NEXT, "lseek64");
+    real_fread = dlsym(RTLD_NEXT, "fread");
+
+    const char *hint = getenv("IOHINTS_PRELOAD_HINT");
+    if(hint!=NULL){
+        for(int h = 0; h<(int)(sizeof(preload_hint_names)/sizeof(preload_hint_names[0])); h++){
+            if(strcmp(hint, preload_hint_names[h])==0) preload_hint = h;
+        }
+    }
+    const char *window = getenv("IOHINTS_PRELOAD_WINDOW");
+    if(window!=NULL && preload_parse_size(window)>0) preload_window_size = preload_parse_size(window);
+    __atomic_store_n(&real_fclose, (int (*)(FILE *))dlsym(RTLD_NEXT, "fclose"), __ATOMIC_RELEASE);
+}
+
+// Lock the state of a file descriptor
+static inline struct preload_fd *preload_fd_acquire(int fd){
+    if(fd<0 || fd>=PRELOAD_MAX_FDS) return NULL;
+    struct preload_fd *state = &preload_fds[fd];
+    pthread_mutex_lock(&state->mutex);
+    if(!state->checked){
+        // Hints would be pointless on anything but a regular file read through the page cache
+        struct stat st;
+        int flags = fcntl(fd, F_GETFL);
+        state->checked = true;
+        state->followed = flags>=0 && (flags & O_ACCMODE)!=O_WRONLY && !(flags & O_DIRECT) && fstat(fd, &st)==0 && S_ISREG(st.st_mode);
+        if(state->followed){
+            off64_t position = real_lseek64(fd, 0, SEEK_CUR);
+            state->file_size = st.st_size;
+            state->position = position>0 ? position : 0;
+        }
+    }
+    if(state->followed){
+        __atomic_add_fetch(&preload_call_count, 1, __ATOMIC_RELAXED);
+        return state;
+    }
+    pthread_mutex_unlock(&state->mutex);
+    return NULL;
+}
+
+// Unlock the state of a file descriptor
+static inline void preload_fd_release(struct preload_fd *state){
+    pthread_mutex_unlock(&state->mutex);
+}
+
+// Forget a file descriptor
+static inline void preload_fd_forget(int fd){
+    if(fd<0 || fd>=PRELOAD_MAX_FDS) return;
+    struct preload_fd *state = &preload_fds[fd];
+    pthread_mutex_lock(&state->mutex);
+    for(int p = 0; p<state->prefetch_count; p++) iohints_prefetch_cancel(state->prefetches[p]);
+    for(int p = 0; p<state->prefetch_count; p++){
+        iohints_prefetch_wait(state->prefetches[p]);
+        iohints_prefetch_release(state->prefetches[p]);
+    }
+    state->prefetch_count = 0;
+    memset(state->streams, 0, sizeof(state->streams));
+    state->checked = false;
+    state->followed = false;
+    state->use_count = 0;
+    state->generation++;
+    pthread_mutex_unlock(&state->mutex);
+}
+
+// Record an access, and hint what its stream reads next
+static inline void preload_access(int fd, struct preload_fd *state, uint64_t offset, uint64_t size){
+    if(size==0 || offset>=state->file_size) return;
+    state->use_count++;
+
+    // The access continues the stream that predicted it, or starts a new one in place of the least recently used stream.
+    // Accesses starting where the previous one ended continue a forward stream whatever their size. A new stream guesses
+    // its stride from the last access when it started a stream of its own, which the next access confirms or not: the
+    // stream of that access is left alone, in case it is the start of one of several interleaved streams
+    struct preload_stream *stream = NULL, *oldest = &state->streams[0], *newest = &state->streams[0];
+    for(int s = 0; s<PRELOAD_STREAMS_PER_FD && stream==NULL; s++){
+        struct preload_stream *candidate = &state->streams[s];
+        if(candidate->last_use==0) continue;
+        if(candidate->last_offset+candidate->last_size==offset){
+            stream = candidate;
+            if(!stream->forward) stream->run = 0;
+            stream->forward = true;
+        }else if(!candidate->forward && candidate->stride!=0 && candidate->last_offset+candidate->stride==offset) stream = candidate;
+        if(candidate->last_use<oldest->last_use) oldest = candidate;
+        if(candidate->last_use>newest->last_use) newest = candidate;
+    }
+    if(stream!=NULL) stream->run++;
+    else{
+        int64_t stride = newest->last_use!=0 && newest->run==0 && newest->last_offset!=offset ? (int64_t)(offset-newest->last_offset) : 0;
+        for(int s = 0; s<PRELOAD_STREAMS_PER_FD; s++) if(state->streams[s].last_use==0){ oldest = &state->streams[s]; break; }
+        stream = oldest;
+        memset(stream, 0, sizeof(struct preload_stream));
+        stream->stride = stride;
+        stream->run = stride!=0;
+    }
+    stream->last_offset = offset;
+    stream->last_size = size;
+    stream->last_use = state->use_count;
+    if(stream->run<PRELOAD_MIN_RUN || preload_hint==PRELOAD_HINT_NONE) return;
+    if(stream->run==PRELOAD_MIN_RUN) __atomic_add_fetch(&preload_stream_count, 1, __ATOMIC_RELAXED);
+
+    // The window doubles with each access that follows the stream, as kernel readahead does, so that streams found by
+    // chance do not hint much
+    uint64_t window_size = stream->run<24 && (size<<stream->run)<preload_window_size ? size<<stream->run : preload_window_size;
+
+    // Forward streams: the window is hinted again once the stream went through half of it
+    if(stream->forward){
+        if(stream->hinted_until<offset+size) stream->hinted_until = offset+size;
+        if(stream->hinted_until-offset>=window_size/2 || stream->hinted_until>=state->file_size) return;
+        uint64_t end = offset+size+window_size<state->file_size ? offset+size+window_size : state->file_size;
+        preload_hint_range(fd, state, stream->hinted_until, end-stream->hinted_until);
+        stream->hinted_until = end;
+        return;
+    }
+
+    // Other streams: the coming accesses are hinted until a window worth of them is, again once half of them were read.
+    // Accesses that touch each other are hinted as a single range
+    if(stream->run==PRELOAD_MIN_RUN || (stream->stride>0 ? stream->next_hint<(int64_t)offset+stream->stride : stream->next_hint>(int64_t)offset+stream->stride)){
+        stream->next_hint = offset+stream->stride;
+    }
+    if((uint64_t)((stream->next_hint-(int64_t)offset)/stream->stride-1)*size>=window_size/2) return;
+    uint64_t range_start = 0, range_end = 0;
+    int range_count = 0;
+    while(stream->next_hint>=0 && (uint64_t)stream->next_hint<state->file_size && (uint64_t)((stream->next_hint-(int64_t)offset)/stream->stride-1)*size<window_size){
+        uint64_t start = stream->next_hint, end = start+size<state->file_size ? start+size : state->file_size;
+        if(range_end>range_start && start<=range_end && end>=range_start){
+            if(start<range_start) range_start = start;
+            if(end>range_end) range_end = end;
+        }else{
+            if(range_end>range_start) preload_hint_range(fd, state, range_start, range_end-range_start);
+            if(++range_count>PRELOAD_MAX_RANGES) return;
+            range_start = start;
+            range_end = end;
+        }
+        stream->next_hint += stream->stride;
+    }
+    if(range_end>range_start) preload_hint_range(fd, state, range_start, range_end-range_start);
+}
+
+// Give the configured hint on a range, through the same calls as the benchmarks. The handles of asynchronous prefetches are
+// kept with the file descriptor, so that closing it cancels them
+static inline void preload_hint_range(int fd, struct preload_fd *state, uint64_t offset, uint64_t length){
+    __atomic_add_fetch(&preload_hint_count, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&preload_hinted_bytes, length, __ATOMIC_RELAXED);
+    switch(preload_hint){
+        case PRELOAD_HINT_FADVISE: iohints_client_prefetch(fd, offset, length); break;
+        case PRELOAD_HINT_AIO: {
+            if(state->prefetch_count==PRELOAD_PREFETCHES_PER_FD){
+                int kept_count = 0;
+                for(int p = 0; p<state->prefetch_count; p++){
+                    if(iohints_prefetch_poll(state->prefetches[p])==EINPROGRESS) state->prefetches[kept_count++] = state->prefetches[p];
+                    else iohints_prefetch_release(state->prefetches[p]);
+                }
+                state->prefetch_count = kept_count;
+            }
+            if(state->prefetch_count==PRELOAD_PREFETCHES_PER_FD){
+                iohints_prefetch_wait(state->prefetches[0]);
+                iohints_prefetch_release(state->prefetches[0]);
+                memmove(state->prefetches, state->prefetches+1, sizeof(struct iohints_prefetch *)*--state->prefetch_count);
+            }
+            struct iohints_prefetch *prefetch;
+            if(iohints_aio_prefetch(fd, offset, length, &prefetch)==0) state->prefetches[state->prefetch_count++] = prefetch;
+            break;
+        }
+        case PRELOAD_HINT_READAHEAD: readahead(fd, offset, length); break;
+        default: break;
+    }
+}
+
+// Parse a size with an optional K, M or G suffix
+static uint64_t preload_parse_size(const char *value){
+    char *end;
+    uint64_t size = strtoull(value, &end, 10);
+    switch(*end){
+        case 'k': case 'K': return size << 10;
+        case 'm': case 'M': return size << 20;
+        case 'g': case 'G': return size << 30;
+        default: return size;
+    }
+}
+
+// Print the counters, in verbose mode
+__attribute__((destructor)) static void preload_fini(){
+    const char *verbose = getenv("IOHINTS_PRELOAD_VERBOSE");
+    if(verbose==NULL || strcmp(verbose, "0")==0) return;
+    fprintf(stderr, "iohints-preload: hint=%s, calls=%llu, streams=%llu, hints=%llu, hinted_bytes=%llu\n", preload_hint_names[preload_hint],
+        (unsigned long long)preload_call_count, (unsigned long long)preload_stream_count, (unsigned long long)preload_hint_count,
+        (unsigned long long)preload_hinted_bytes);
+}
@@ -0,0 +1,40 @@
+#define _GNU_SOURCE
+
+#include <stddef.h>
+#include <fcntl.h>
+#include <stdint.h>
+
+#include "iohints-strategy.h"
+
+// Example of strategy module: readahead(2) the reads coming next, as an oracle. Built as libiohints-strategy-readahead.so, and
+// loaded with --strategy-modules=libiohints-strategy-readahead.so
+
+// Number of reads hinted ahead of the one being read: the lookahead depth in the random benchmark, and as many reads as fit in
+// the prefetch size in the sequential one
+static uint64_t readahead_depth(struct iohints_strategy_run *run){
+    return run->lookahead_depth!=0 ? run->lookahead_depth : run->prefetch_size/run->io_size;
+}
+
+// Hint the first reads
+static void readahead_pre_read(struct iohints_strategy_run *run){
+    uint64_t depth = readahead_depth(run);
+    for(uint64_t read = 0; read<depth && read<run->read_count; read++) readahead(run->fd, run->offsets[read], run->io_size);
+}
+
+// Keep the reads depth reads ahead hinted
+static void readahead_on_read(struct iohints_strategy_run *run, uint64_t read, uint64_t offset, uint64_t length){
+    uint64_t depth = readahead_depth(run);
+    if(read+depth<run->read_count) readahead(run->fd, run->offsets[read+depth], run->io_size);
+}
+
+static const struct iohints_strategy readahead_strategy = {
+    "example/readahead", "Example module", "readahead oracle", "The next reads are prefetched using readahead",
+    IOHINTS_STRATEGY_PREFETCH_SIZES | IOHINTS_STRATEGY_LOOKAHEAD_DEPTHS, NULL, NULL, NULL, readahead_pre_read, readahead_on_read, NULL
+};
+
+static const struct iohints_strategy *const readahead_strategies[] = {&readahead_strategy, NULL};
+
+const struct iohints_strategy *const *iohints_strategy_module_init(unsigned api_version){
+    if(api_version!=IOHINTS_STRATEGY_API_VERSION) return NULL;
+    return readahead_strategies;
+}
@@ -0,0 +1,60 @@
+#define _GNU_SOURCE
+
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <dlfcn.h>
+
+#include "iohints-strategy.h"
+
+// Strategies registered so far, followed by NULL
+static const struct iohints_strategy *iohints_strategies[IOHINTS_STRATEGY_MAX_REGISTERED+1];
+static int iohints_strategy_count = 0;
+
+// Add a strategy to the registry. Returns 0, or -1 with errno set: EINVAL when it lacks a "category/strategy" name, a category
+// or a label, EEXIST when its name is already registered, ENOSPC when IOHINTS_STRATEGY_MAX_REGISTERED are
+int iohints_strategy_register(const struct iohints_strategy *strategy){
+    if(strategy->name==NULL || strchr(strategy->name, '/')==NULL || strategy->category==NULL || strategy->label==NULL){
+        errno = EINVAL;
+        return -1;
+    }
+    for(int i = 0; i<iohints_strategy_count; i++){
+        if(strcmp(iohints_strategies[i]->name, strategy->name)==0){
+            errno = EEXIST;
+            return -1;
+        }
+    }
+    if(iohints_strategy_count==IOHINTS_STRATEGY_MAX_REGISTERED){
+        errno = ENOSPC;
+        return -1;
+    }
+    iohints_strategies[iohints_strategy_count++] = strategy;
+    return 0;
+}
+
+// The registered strategies, in the order they were registered, followed by NULL
+const struct iohints_strategy *const *iohints_strategy_registry(void){
+    return iohints_strategies;
+}
+
+// Load a strategy module with dlopen, and return the NULL-terminated array of strategies its init function returns, for the
+// caller to register. Returns NULL with errno set: ENOEXEC when the module cannot be loaded or has no init function (dlerror
+// tells why), ENOTSUP when it does not support IOHINTS_STRATEGY_API_VERSION
+const struct iohints_strategy *const *iohints_strategy_module_load(const char *path){
+    void *module = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if(module == NULL){
+        errno = ENOEXEC;
+        return NULL;
+    }
+    iohints_strategy_module_init_t init = (iohints_strategy_module_init_t)dlsym(module, IOHINTS_STRATEGY_MODULE_INIT);
+    if(init == NULL){
+        errno = ENOEXEC;
+        return NULL;
+    }
+    const struct iohints_strategy *const *strategies = init(IOHINTS_STRATEGY_API_VERSION);
+    if(strategies == NULL){
+        errno = ENOTSUP;
+        return NULL;
+    }
+    return strategies;
+}
@@ -0,0 +1,89 @@
+#ifndef IOHINTS_STRATEGY_H
+#define IOHINTS_STRATEGY_H
+
+#include <stdint.h>
+
+// Version of the structures below. Bumped whenever they change, so that modules built against another version are refused
+#define IOHINTS_STRATEGY_API_VERSION 2
+
+// The strategy is run once per prefetch size: every I/O size of the sweep bigger than the one read (sequential benchmark)
+#define IOHINTS_STRATEGY_PREFETCH_SIZES 0x1
+
+// The strategy is run once per lookahead depth of the sweep (random benchmark)
+#define IOHINTS_STRATEGY_LOOKAHEAD_DEPTHS 0x2
+
+// The strategy is run once per prefetch delay of the sweep: the first read comes that long after the prefetch hook, which may
+// still be loading the file by then, so that its residency is not checked
+#define IOHINTS_STRATEGY_PREFETCH_DELAYS 0x4
+
+// The file is opened with O_DIRECT and read through io_uring, once per queue depth of the sweep. Reads are rounded up to
+// whole logical blocks
+#define IOHINTS_STRATEGY_DIRECT_IO 0x8
+
+// The prefetch and evict hooks leave the whole file in the client page cache, which is checked before the first read.
+// Otherwise, none of it is expected to be there
+#define IOHINTS_STRATEGY_CACHED 0x10
+
+// Strategies the registry holds at most, the built-in ones of the benchmark included
+#define IOHINTS_STRATEGY_MAX_REGISTERED 256
+
+// Name of the function a strategy module exports, see iohints_strategy_module_init
+#define IOHINTS_STRATEGY_MODULE_INIT "iohints_strategy_module_init"
+
+// A configuration of a strategy: the file read, and how it is read. Every experiment reads the same offsets, in order
+struct iohints_strategy_run {
+    int fd; // Opened for this configuration only, and read with buffered reads, or direct ones with IOHINTS_STRATEGY_DIRECT_IO
+    uint64_t file_size;
+    uint64_t io_size; // Size of the reads, rounded up to whole logical blocks with IOHINTS_STRATEGY_DIRECT_IO
+    uint64_t prefetch_size; // 0 unless the strategy sweeps IOHINTS_STRATEGY_PREFETCH_SIZES
+    uint64_t lookahead_depth; // 0 unless the strategy sweeps IOHINTS_STRATEGY_LOOKAHEAD_DEPTHS
+    uint64_t prefetch_delay; // In us, 0 unless the strategy sweeps IOHINTS_STRATEGY_PREFETCH_DELAYS
+    unsigned queue_depth; // Reads in flight, 1 unless the strategy has IOHINTS_STRATEGY_DIRECT_IO
+    uint64_t read_count;
+    const uint64_t *offsets; // Offset of each read, known in advance as an oracle would
+    void *data; // Left to the strategy, e.g. allocated by prepare and freed by teardown
+};
+
+// A strategy: its name and output columns, and the hooks the benchmark calls. Any hook may be NULL
+struct iohints_strategy {
+    const char *name; // As given to --strategies, "category/strategy"
+    const char *category, *label, *description; // Columns of the output rows
+    unsigned flags; // IOHINTS_STRATEGY_* flags above
+
+    // Called once per configuration, before its experiments and out of the timed section. Returning non zero skips it
+    int (*prepare)(struct iohints_strategy_run *run);
+
+    // Called at the start of each experiment once the file was evicted, out of the timed section, e.g. to load the file
+    void (*prefetch)(struct iohints_strategy_run *run);
+
+    // Called right after prefetch, out of the timed section, to evict some of what it loaded from the client or server cache
+    void (*evict)(struct iohints_strategy_run *run);
+
+    // Called at the start of each experiment, after evict, before the first read. Timed with the reads
+    void (*pre_read)(struct iohints_strategy_run *run);
+
+    // Called before each read, timed with the reads but not with the latency of the read
+    void (*on_read)(struct iohints_strategy_run *run, uint64_t read, uint64_t offset, uint64_t length);
+
+    // Called once the configuration is over
+    void (*teardown)(struct iohints_strategy_run *run);
+};
+
+// Function every strategy module exports, called once the module is loaded. Returns a NULL-terminated array of strategies that
+// stays valid until the program exits, or NULL when the module does not support api_version
+typedef const struct iohints_strategy *const *(*iohints_strategy_module_init_t)(unsigned api_version);
+const struct iohints_strategy *const *iohints_strategy_module_init(unsigned api_version);
+
+// Add a strategy to the registry. Returns 0, or -1 with errno set: EINVAL when it lacks a "category/strategy" name, a category
+// or a label, EEXIST when its name is already registered, ENOSPC when IOHINTS_STRATEGY_MAX_REGISTERED are
+int iohints_strategy_register(const struct iohints_strategy *strategy);
+
+// The registered strategies, in the order they were registered, followed by NULL
+const struct iohints_strategy *const *iohints_strategy_registry(void);
+
+// Load a strategy module with dlopen, and return the NULL-terminated array of strategies its init function returns, for the
+// caller to register. Returns NULL with errno set: ENOEXEC when the module cannot be loaded or has no init function (dlerror
+// tells why), ENOTSUP when it does not support IOHINTS_STRATEGY_API_VERSION
+const struct iohints_strategy *const *iohints_strategy_module_load(const char *path);
+
+#endif
@@ -0,0 +1,126 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <aio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "iohints.h"
+#include "iohints-generate.h"
+
+// Size of the file the prefetches read: several chunks, so that a cancelled prefetch stops before the end of it
+#define TEST_FILE_SIZE (16*IOHINTS_PREFETCH_CHUNK_SIZE)
+
+// Default file to prefetch, created then deleted by the test
+#define TEST_FILE "iohints-test.bin"
+
+static int failure_count = 0;
+
+// Count a failure when a condition does not hold
+static void check(bool condition, const char *description){
+    if(!condition){
+        printf("FAILED: %s\n", description);
+        failure_count++;
+    }
+}
+
+// Start a prefetch of the whole file that hands out its handle, and exit when it cannot be started
+static struct iohints_prefetch *prefetch_start(int fd){
+    struct iohints_prefetch *prefetch = NULL;
+    if(iohints_aio_prefetch(fd, 0, TEST_FILE_SIZE, &prefetch)<0 || prefetch==NULL){
+        printf("Error starting a prefetch: %s\n", strerror(errno));
+        exit(1);
+    }
+    return prefetch;
+}
+
+// A prefetch is polled until it read the whole file, and its handle is given back
+static void test_poll(int fd){
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    struct iohints_prefetch *prefetch = prefetch_start(fd);
+    int status;
+    while((status = iohints_prefetch_poll(prefetch))==EINPROGRESS) usleep(100);
+    check(status==0, "a prefetch that is over polls as 0");
+    check(iohints_prefetch_bytes(prefetch)==TEST_FILE_SIZE, "a prefetch that is over read the whole file");
+    check(iohints_prefetch_wait(prefetch)==0, "waiting for a prefetch that is over returns at once, with 0");
+    check(iohints_prefetch_cancel(prefetch)==AIO_ALLDONE, "cancelling a prefetch that is over does nothing");
+    check(iohints_prefetch_poll(prefetch)==0, "cancelling a prefetch that is over keeps its status");
+    iohints_prefetch_release(prefetch);
+}
+
+// A cancelled prefetch stops reading, and is over once waited for
+static void test_cancel(int fd){
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    struct iohints_prefetch *prefetch = prefetch_start(fd);
+    iohints_prefetch_cancel(prefetch);
+    int status = iohints_prefetch_wait(prefetch);
+    uint64_t bytes = iohints_prefetch_bytes(prefetch);
+
+    // The prefetch may have been over before the cancellation, on a fast enough disk
+    check(status==ECANCELED || status==0, "a cancelled prefetch ends with ECANCELED");
+    check(status!=ECANCELED || bytes<TEST_FILE_SIZE, "a cancelled prefetch stops before the end of the file");
+    check(status!=0 || bytes==TEST_FILE_SIZE, "a prefetch over before its cancellation read the whole file");
+    check(iohints_prefetch_poll(prefetch)==status, "polling a cancelled prefetch returns what waiting for it returned");
+    usleep(10000);
+    check(iohints_prefetch_bytes(prefetch)==bytes, "a cancelled prefetch reads nothing once over");
+    iohints_prefetch_release(prefetch);
+}
+
+// Handles held by the caller are not handed out again until released, and released ones are
+static void test_release(int fd){
+    static struct iohints_prefetch *prefetches[IOHINTS_PREFETCH_MAX_REQUESTS];
+    for(int p = 0; p<IOHINTS_PREFETCH_MAX_REQUESTS; p++){
+        if(iohints_aio_prefetch(fd, 0, 0, &prefetches[p])<0){
+            printf("Error starting prefetch %d: %s\n", p, strerror(errno));
+            exit(1);
+        }
+    }
+    struct iohints_prefetch *prefetch = NULL;
+    int ret = iohints_aio_prefetch(fd, 0, 0, &prefetch);
+    check(ret==-1 && errno==EAGAIN, "no prefetch starts while the caller holds every handle");
+    iohints_prefetch_release(prefetches[0]);
+    ret = iohints_aio_prefetch(fd, 0, 0, &prefetch);
+    check(ret==0 && prefetch==prefetches[0], "a released handle is handed out again");
+    if(ret==0) prefetches[0] = prefetch;
+    for(int p = 0; p<IOHINTS_PREFETCH_MAX_REQUESTS; p++) iohints_prefetch_release(prefetches[p]);
+
+    // A handle released while the prefetch is in flight comes back once the prefetch is over
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    iohints_prefetch_release(prefetch_start(fd));
+    for(int p = 0; p<IOHINTS_PREFETCH_MAX_REQUESTS; p++){
+        if(iohints_aio_prefetch(fd, 0, 0, &prefetches[p])<0){
+            printf("Error starting prefetch %d after a detached one: %s\n", p, strerror(errno));
+            exit(1);
+        }
+    }
+    for(int p = 0; p<IOHINTS_PREFETCH_MAX_REQUESTS; p++) iohints_prefetch_release(prefetches[p]);
+}
+
+int main(int argc, char **argv){
+    const char *path = argc>1 ? argv[1] : TEST_FILE;
+    if(iohints_generate_file(path, TEST_FILE_SIZE)<0){
+        printf("Error generating file \"%s\": %s\n", path, strerror(errno));
+        return 1;
+    }
+    int fd = open(path, O_RDONLY);
+    if(fd<0){
+        printf("Error opening file \"%s\": %s\n", path, strerror(errno));
+        return 1;
+    }
+    test_poll(fd);
+    test_cancel(fd);
+    test_release(fd);
+    close(fd);
+    unlink(path);
+    if(failure_count>0){
+        printf("%d checks failed\n", failure_count);
+        return 1;
+    }
+    printf("Every check passed\n");
+    return 0;
+}
@@ -0,0 +1,224 @@
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <aio.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#ifdef WITH_LUSTRE
+#include "lustre/lustreapi.h"
+#endif
+
+#include "iohints.h"
+
+// An asynchronous prefetch: the range left to read, and the control block of the chunk in flight
+struct iohints_prefetch {
+    bool used; // Handed out, and not released yet
+    bool detached; // Released while still in flight, so it frees itself when over
+    bool cancelled;
+    int status; // As returned by iohints_prefetch_poll
+    uint64_t offset, length; // What is left to read
+    uint64_t bytes;
+    struct aiocb request; // glibc keeps using it until the read completes, so it cannot live on the stack
+};
+
+// Handles of the asynchronous prefetches. Their state is only touched with the mutex held, and the condition is signaled
+// whenever a prefetch is over or a handle is released
+static struct iohints_prefetch iohints_prefetches[IOHINTS_PREFETCH_MAX_REQUESTS];
+static pthread_mutex_t iohints_prefetch_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t iohints_prefetch_condition = PTHREAD_COND_INITIALIZER;
+
+// Scratch buffer every asynchronous prefetch reads into. Aligned, so that O_DIRECT file descriptors can be prefetched too
+static char *iohints_prefetch_buffer = 0;
+static pthread_once_t iohints_prefetch_buffer_once = PTHREAD_ONCE_INIT;
+
+// Allocate the scratch buffer. Done once, even when prefetches are started from several threads
+static void iohints_prefetch_buffer_alloc();
+
+// Start reading the next chunk of a prefetch. Returns what aio_read returns
+static int iohints_prefetch_submit(struct iohints_prefetch *prefetch);
+
+// Completion of a chunk, run by glibc in a thread of its own: start the next chunk or end the prefetch
+static void iohints_prefetch_chunk_done(union sigval value);
+
+// Mark a prefetch as over, and free its handle if it was detached. Called with the mutex held
+static void iohints_prefetch_finish(struct iohints_prefetch *prefetch, int status);
+
+// Use fadvise to evict some data from the client page cache
+int iohints_client_evict(int fd, uint64_t offset, uint64_t length){
+    return posix_fadvise(fd, offset, length, POSIX_FADV_DONTNEED);
+}
+
+// Use fadvise to prefetch some data to the client page cache
+int iohints_client_prefetch(int fd, uint64_t offset, uint64_t length){
+    return posix_fadvise(fd, offset, length, POSIX_FADV_WILLNEED);
+}
+
+#ifdef WITH_LUSTRE
+// Use lla_ladvise to evict some data from the server page cache
+int iohints_server_evict(int fd, uint64_t offset, uint64_t length){
+    struct llapi_lu_ladvise advises;
+    memset(&advises, 0, sizeof(struct llapi_lu_ladvise));
+    advises.lla_advice = LU_LADVISE_DONTNEED;
+    advises.lla_start = offset;
+    advises.lla_end = offset+length;
+    return llapi_ladvise(fd, 0, 1, &advises);
+}
+
+// Use lla_ladvise to prefetch some data to the server page cache
+int iohints_server_prefetch(int fd, uint64_t offset, uint64_t length){
+    struct llapi_lu_ladvise advises;
+    memset(&advises, 0, sizeof(struct llapi_lu_ladvise));
+    advises.lla_advice = LU_LADVISE_WILLREAD;
+    advises.lla_start = offset;
+    advises.lla_end = offset+length;
+    return llapi_ladvise(fd, 0, 1, &advises);
+}
+#endif
+
+// Use asynchronous I/O to forcefully prefetch some data
+int iohints_aio_prefetch(int fd, uint64_t offset, uint64_t length, struct iohints_prefetch **prefetch){
+    pthread_once(&iohints_prefetch_buffer_once, iohints_prefetch_buffer_alloc);
+    if(iohints_prefetch_buffer == NULL){
+        errno = ENOMEM;
+        return -1;
+    }
+    pthread_mutex_lock(&iohints_prefetch_mutex);
+
+    // Taking a free handle, or waiting for a prefetch in flight to free one. Handles of prefetches that are over but held
+    // by the caller only come back when released, so there is no point waiting for them
+    struct iohints_prefetch *free_prefetch = NULL;
+    while(true){
+        int in_flight_count = 0;
+        for(int i = 0; i<IOHINTS_PREFETCH_MAX_REQUESTS && free_prefetch == NULL; i++){
+            if(!iohints_prefetches[i].used) free_prefetch = &iohints_prefetches[i];
+            else if(iohints_prefetches[i].status==EINPROGRESS) in_flight_count++;
+        }
+        if(free_prefetch != NULL || in_flight_count==0) break;
+        pthread_cond_wait(&iohints_prefetch_condition, &iohints_prefetch_mutex);
+    }
+    if(free_prefetch == NULL){
+        pthread_mutex_unlock(&iohints_prefetch_mutex);
+        errno = EAGAIN;
+        return -1;
+    }
+
+    memset(free_prefetch, 0, sizeof(struct iohints_prefetch));
+    free_prefetch->used = true;
+    free_prefetch->detached = prefetch == NULL;
+    free_prefetch->status = EINPROGRESS;
+    free_prefetch->offset = offset;
+    free_prefetch->length = length;
+    free_prefetch->request.aio_fildes = fd;
+    int ret = 0;
+    if(length==0) iohints_prefetch_finish(free_prefetch, 0);
+    else{
+        ret = iohints_prefetch_submit(free_prefetch);
+        if(ret<0){
+            int error = errno;
+            free_prefetch->used = false;
+            pthread_mutex_unlock(&iohints_prefetch_mutex);
+            errno = error;
+            return -1;
+        }
+    }
+    if(prefetch != NULL) *prefetch = free_prefetch;
+    pthread_mutex_unlock(&iohints_prefetch_mutex);
+    return ret;
+}
+
+// Return the state of a prefetch
+int iohints_prefetch_poll(struct iohints_prefetch *prefetch){
+    pthread_mutex_lock(&iohints_prefetch_mutex);
+    int status = prefetch->status;
+    pthread_mutex_unlock(&iohints_prefetch_mutex);
+    return status;
+}
+
+// Wait for the prefetch to be over
+int iohints_prefetch_wait(struct iohints_prefetch *prefetch){
+    pthread_mutex_lock(&iohints_prefetch_mutex);
+    while(prefetch->status==EINPROGRESS) pthread_cond_wait(&iohints_prefetch_condition, &iohints_prefetch_mutex);
+    int status = prefetch->status;
+    pthread_mutex_unlock(&iohints_prefetch_mutex);
+    return status;
+}
+
+// Number of bytes the prefetch read so far
+uint64_t iohints_prefetch_bytes(struct iohints_prefetch *prefetch){
+    pthread_mutex_lock(&iohints_prefetch_mutex);
+    uint64_t bytes = prefetch->bytes;
+    pthread_mutex_unlock(&iohints_prefetch_mutex);
+    return bytes;
+}
+
+// Stop the prefetch. A cancelled chunk still completes, with ECANCELED, which ends the prefetch
+int iohints_prefetch_cancel(struct iohints_prefetch *prefetch){
+    pthread_mutex_lock(&iohints_prefetch_mutex);
+    int ret = AIO_ALLDONE;
+    if(prefetch->status==EINPROGRESS){
+        prefetch->cancelled = true;
+        ret = aio_cancel(prefetch->request.aio_fildes, &prefetch->request);
+    }
+    pthread_mutex_unlock(&iohints_prefetch_mutex);
+    return ret;
+}
+
+// Give the handle back
+void iohints_prefetch_release(struct iohints_prefetch *prefetch){
+    pthread_mutex_lock(&iohints_prefetch_mutex);
+    if(prefetch->status==EINPROGRESS) prefetch->detached = true;
+    else{
+        prefetch->used = false;
+        pthread_cond_broadcast(&iohints_prefetch_condition);
+    }
+    pthread_mutex_unlock(&iohints_prefetch_mutex);
+}
+
+// Allocate the scratch buffer. Done once, even when prefetches are started from several threads
+static void iohints_prefetch_buffer_alloc(){
+    void *buffer;
+    if(posix_memalign(&buffer, 4096, IOHINTS_PREFETCH_CHUNK_SIZE)==0) iohints_prefetch_buffer = buffer;
+}
+
+// Start reading the next chunk of a prefetch
+static int iohints_prefetch_submit(struct iohints_prefetch *prefetch){
+    struct aiocb *aiocbp = &prefetch->request;
+    aiocbp->aio_buf = iohints_prefetch_buffer;
+    aiocbp->aio_nbytes = prefetch->length<IOHINTS_PREFETCH_CHUNK_SIZE ? prefetch->length : IOHINTS_PREFETCH_CHUNK_SIZE;
+    aiocbp->aio_offset = prefetch->offset; // No need to lseek
+    aiocbp->aio_sigevent.sigev_notify = SIGEV_THREAD;
+    aiocbp->aio_sigevent.sigev_notify_function = iohints_prefetch_chunk_done;
+    aiocbp->aio_sigevent.sigev_value.sival_ptr = prefetch;
+    return aio_read(aiocbp);
+}
+
+// Completion of a chunk: start the next chunk or end the prefetch
+static void iohints_prefetch_chunk_done(union sigval value){
+    struct iohints_prefetch *prefetch = value.sival_ptr;
+    pthread_mutex_lock(&iohints_prefetch_mutex);
+    int error = aio_error(&prefetch->request);
+    ssize_t ret = aio_return(&prefetch->request);
+    if(error!=0) iohints_prefetch_finish(prefetch, error);
+    else{
+        prefetch->bytes += ret;
+        prefetch->offset += ret;
+        prefetch->length -= (uint64_t)ret<prefetch->length ? (uint64_t)ret : prefetch->length;
+        if(ret==0 || prefetch->length==0) iohints_prefetch_finish(prefetch, 0);
+        else if(prefetch->cancelled) iohints_prefetch_finish(prefetch, ECANCELED);
+        else if(iohints_prefetch_submit(prefetch)<0) iohints_prefetch_finish(prefetch, errno);
+    }
+    pthread_mutex_unlock(&iohints_prefetch_mutex);
+}
+
+// Mark a prefetch as over
+static void iohints_prefetch_finish(struct iohints_prefetch *prefetch, int status){
+    prefetch->status = status;
+    if(prefetch->detached) prefetch->used = false;
+    pthread_cond_broadcast(&iohints_prefetch_condition);
+}
@@ -0,0 +1,53 @@
+#ifndef IOHINTS_H
+#define IOHINTS_H
+
+#include <stdint.h>
+
+// Number of asynchronous prefetches that may be in flight or held by the caller at the same time
+#define IOHINTS_PREFETCH_MAX_REQUESTS 1024
+
+// Asynchronous prefetches read their range one chunk at a time, into a single scratch buffer of this size shared by all of
+// them: the data is only read to bring it in the page cache, and is never looked at
+#define IOHINTS_PREFETCH_CHUNK_SIZE (4*1024*1024)
+
+// An asynchronous prefetch, owned by the library
+struct iohints_prefetch;
+
+// Use fadvise to evict some data from the client page cache. Returns what posix_fadvise returns
+int iohints_client_evict(int fd, uint64_t offset, uint64_t length);
+
+// Use fadvise to prefetch some data to the client page cache. Returns what posix_fadvise returns
+int iohints_client_prefetch(int fd, uint64_t offset, uint64_t length);
+
+#ifdef WITH_LUSTRE
+// Use lla_ladvise to evict some data from the server page cache. Returns what llapi_ladvise returns
+int iohints_server_evict(int fd, uint64_t offset, uint64_t length);
+
+// Use lla_ladvise to prefetch some data to the server page cache. Returns what llapi_ladvise returns
+int iohints_server_prefetch(int fd, uint64_t offset, uint64_t length);
+#endif
+
+// Use asynchronous I/O to forcefully prefetch some data. The file descriptor must stay open until the prefetch is over.
+// When prefetch is not NULL, it receives a handle to poll, wait for or cancel the prefetch, which must be released once
+// done with. Otherwise the prefetch is detached and releases itself when over. When all the handles are taken, waits for
+// a prefetch in flight to be over. Returns 0, or -1 with errno set (EAGAIN when all the handles are held by the caller)
+int iohints_aio_prefetch(int fd, uint64_t offset, uint64_t length, struct iohints_prefetch **prefetch);
+
+// Return EINPROGRESS while the prefetch is in flight, then 0 once the whole range (or up to the end of the file) was read,
+// ECANCELED if it was cancelled before that, or the error of the read that failed, as aio_error does
+int iohints_prefetch_poll(struct iohints_prefetch *prefetch);
+
+// Wait for the prefetch to be over, and return as iohints_prefetch_poll
+int iohints_prefetch_wait(struct iohints_prefetch *prefetch);
+
+// Number of bytes the prefetch read so far
+uint64_t iohints_prefetch_bytes(struct iohints_prefetch *prefetch);
+
+// Stop the prefetch: the chunk being read is cancelled if it has not started yet, and no other chunk is read. The prefetch
+// is over once iohints_prefetch_poll no longer returns EINPROGRESS. Returns what aio_cancel returns
+int iohints_prefetch_cancel(struct iohints_prefetch *prefetch);
+
+// Give the handle back. A prefetch still in flight is detached, and keeps going
+void iohints_prefetch_release(struct iohints_prefetch *prefetch);
+
+#endif
@@ -13,19 +13,68 @@
 #include <sys/time.h>
 #include <aio.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <time.h>
+#include <pthread.h>
+#include <getopt.h>
+#include <ctype.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+#include <dlfcn.h>
+
+// The cachestat syscall (Linux 6.5) is not wrapped by the C library yet
+#ifndef __NR_cachestat
+#define __NR_cachestat 451
+#endif
+struct cachestat_range {
+    uint64_t off, len;
+};
+struct cachestat {
+    uint64_t nr_cache, nr_dirty, nr_writeback, nr_evicted, nr_recently_evicted;
+};
+
+// Older C libraries do not know about MADV_POPULATE_READ (Linux 5.14)
+#ifndef MADV_POPULATE_READ
+#define MADV_POPULATE_READ 22
+#endif
 
 #define RANDOM_SEED 154645134u
 
-#ifdef WITH_LUSTRE
-#include "lustre/lustreapi.h"
-#endif
+// Random offsets are multiples of this many bytes. 0 aligns them to the I/O size, 1 leaves them unaligned
+#define OFFSET_ALIGNMENT 0
 
-#define nsleep(nanoseconds) nanosleep((const struct timespec[]){{0, nanoseconds}}, NULL);
+// Exponent of the Zipfian distribution: the k-th most accessed place of the file is accessed about 1/k^ZIPF_EXPONENT as often as the first
+#define ZIPF_EXPONENT 0.99
+
+// The hotspot distribution sends HOTSPOT_ACCESS_FRACTION of the accesses to the first HOTSPOT_DATA_FRACTION of the file
+#define HOTSPOT_ACCESS_FRACTION 0.9
+#define HOTSPOT_DATA_FRACTION 0.1
+
+// Each access of the Gaussian locality distribution lands at a normally distributed distance from the previous one, with this
+// standard deviation (as a fraction of the file size)
+#define GAUSSIAN_LOCALITY_STDDEV 0.01
+
+#include "iohints.h"
+#include "iohints-strategy.h"
+#include "iohints-event-trace.h"
+#include "iohints-generate.h"
 
 // How many time we do the same measure in a row to increase precision
 #define DURATION_PER_EXPERIMENT_US (15*(uint64_t)1e6)
 
+// Configurations stop repeating earlier once the 95% confidence interval of their per-experiment throughput is narrower than
+// this fraction of its mean, in both directions. 0 always runs them for DURATION_PER_EXPERIMENT_US
+#define REPETITION_CI_WIDTH 0.02
+
+// Bounds on the number of experiments of each configuration: the confidence interval is not trusted below the minimum, and
+// 0 leaves the maximum to the duration
+#define REPETITION_MIN_COUNT 5
+#define REPETITION_MAX_COUNT 0
+
 // Dropping the cache might be asynchronous (or not, we don't know). As such, we sleep for the duration below after a cache drop, just to be sure.
 #define CACHE_DROP_DELAY_SECONDS 0
 
@@ -41,31 +90,390 @@
 #define SECONDARY_IO_COUNT 1024 // For a total of 4 GB, which is the size of GPFS page cache
 #endif
 
+// Default output csv
+#ifdef WITH_LUSTRE
+#define OUTPUT_FILE "output-lustre.csv"
+#else
+#define OUTPUT_FILE "output.csv"
+#endif
+
+// How many times the file is evicted with fadvise before falling back to dropping the whole page cache
+#define CACHE_EVICT_ATTEMPTS 3
+
+// Resident page count returned when it could not be measured (neither cachestat nor mincore worked)
+#define RESIDENT_PAGES_UNKNOWN UINT64_MAX
+
+// A timed loop counts as starting cold below this resident fraction of its range, and warm above one minus it
+#define RESIDENCY_TOLERANCE 0.01
+
+// Maximal number of values of each swept parameter
+#define MAX_SWEEP_VALUES 64
+
+// Multiples of the page cache capacity --memory-ratios sweeps when given no list: from a working set fitting comfortably in memory to 4 times bigger
+#define MEMORY_RATIOS "0.25,0.5,1,2,4"
+
 // Whether or not a "desc" field should be included in the output csv
 #define OUTPUT_EXPERIMENT_DESCRIPTION false
 
 // Individual file sizes to be tested
-static const uint64_t file_sizes[] = {1024*1024*1024}; //{64*1024*1024, 1024*1024*1024, 16ul*1024*1024*1024};
-static const int file_size_count = 1;
+static uint64_t file_sizes[MAX_SWEEP_VALUES] = {1024*1024*1024}; //{64*1024*1024, 1024*1024*1024, 16ul*1024*1024*1024};
+static int file_size_count = 1;
 
 // Individual I/O sizes to be tested
-static const uint64_t io_sizes[] = {4*1024, 16*1024, 64*1024, 1024*1024, 16*1024*1024, 256*1024*1024};
-static const int io_size_count = 6;
+static uint64_t io_sizes[MAX_SWEEP_VALUES] = {4*1024, 16*1024, 64*1024, 1024*1024, 16*1024*1024, 256*1024*1024};
+static int io_size_count = 6;
 
 // Individual delays for just in time prefetch (in us)
 static const uint64_t jit_prefetch_delays[] = {0, 1000, 10000, 100000, 1000000};
 static const int jit_prefetch_delay_count = 5;
 
 // Individual inter arrival times between I/Os (in ns)
-static const uint64_t io_interarrival_times[] = {0, 100, 10000, 1000000};
-static const int io_interarrival_time_count = 1;
+static uint64_t io_interarrival_times[MAX_SWEEP_VALUES] = {0, 100, 10000, 1000000};
+static int io_interarrival_time_count = 1;
+
+// Arrival schedules of the paced reads. Both are open loop: when a read is due does not depend on when the previous one completed
+enum arrival_schedule {
+    ARRIVAL_CONSTANT, // One read every inter arrival time
+    ARRIVAL_POISSON,  // Exponentially distributed gaps, averaging the inter arrival time
+};
+static const char *arrival_schedule_names[] = {"constant", "poisson"};
+static enum arrival_schedule arrival_schedule = ARRIVAL_CONSTANT;
+
+// Waits longer than this are slept through up to this much, and the rest is spun on the clock (in ns)
+#define PACER_SPIN_THRESHOLD_NS 50000
+
+// Seed of the Poisson arrival schedules, so that campaigns are reproducible
+#define PACER_SEED 0x9e3779b97f4a7c15ull
+
+// Individual numbers of upcoming accesses the oracle lookahead strategies keep hinted ahead of the reader
+static uint64_t oracle_lookahead_depths[MAX_SWEEP_VALUES] = {1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024};
+static int oracle_lookahead_depth_count = 11;
+
+// Individual numbers of O_DIRECT reads kept in flight
+static unsigned direct_io_queue_depths[MAX_SWEEP_VALUES] = {1, 4, 16, 64};
+static int direct_io_queue_depth_count = 4;
+
+// Upper bound on the memory used by the O_DIRECT buffer pool. Bigger io_size x queue depth combinations are skipped
+#define DIRECT_IO_MAX_POOL_SIZE (1024ul*1024*1024) // 1 GB
+
+// Number of events each thread keeps between two flushes of the event trace. Past that, the oldest ones are overwritten
+#define EVENT_TRACE_RING_CAPACITY (1u << 20)
+
+// How long the SQ polling thread may stay idle before going to sleep (in ms)
+#define IO_URING_SQPOLL_IDLE_MS 1000
+
+// Latency histograms have 2^LATENCY_HISTOGRAM_SUB_BUCKET_BITS linear sub-buckets per power of two, i.e. a relative precision of 1/32
+#define LATENCY_HISTOGRAM_SUB_BUCKET_BITS 5
+#define LATENCY_HISTOGRAM_BUCKET_COUNT ((65-LATENCY_HISTOGRAM_SUB_BUCKET_BITS) << LATENCY_HISTOGRAM_SUB_BUCKET_BITS)
+
+// Log-bucketed (HDR-style) histogram of per-I/O latencies, in ns. Recording a value is a couple of shifts and an increment
+struct latency_histogram {
+    uint64_t counts[LATENCY_HISTOGRAM_BUCKET_COUNT];
+    uint64_t count, max;
+};
+
+// State the client page cache is expected to be in when a timed loop starts
+enum residency_precondition {
+    RESIDENCY_ANY,
+    RESIDENCY_COLD,
+    RESIDENCY_WARM
+};
+static const char *residency_precondition_names[] = {"any", "cold", "warm"};
+
+// Resident fractions of the target range before and after the timed loops of a configuration, and how many experiments did not start as expected
+struct residency_record {
+    enum residency_precondition precondition;
+    double before_sum, after_sum;
+    int before_count, after_count, failure_count;
+};
+
+// Distributions of the random offsets. The whole campaign is run once per selected distribution
+enum offset_distribution {
+    OFFSET_DISTRIBUTION_UNIFORM,
+    OFFSET_DISTRIBUTION_ZIPF,
+    OFFSET_DISTRIBUTION_HOTSPOT,
+    OFFSET_DISTRIBUTION_GAUSSIAN,
+    OFFSET_DISTRIBUTION_COUNT
+};
+static const char *offset_distribution_names[] = {"uniform", "zipf", "hotspot", "gaussian"};
+static enum offset_distribution offset_distributions[OFFSET_DISTRIBUTION_COUNT] = {OFFSET_DISTRIBUTION_UNIFORM};
+static int offset_distribution_count = 1;
+static enum offset_distribution offset_distribution = OFFSET_DISTRIBUTION_UNIFORM; // The one being run
+
+// State of a xoshiro256** generator. rand() only has 31 bits, which cannot address files bigger than 2 GB
+struct random_generator {
+    uint64_t state[4];
+};
+
+// Per-experiment throughputs of a configuration, used to decide when to stop repeating it
+struct repetition {
+    uint64_t start_us;
+    uint64_t last_volume, last_read_duration; // Totals of the loop at the end of the previous experiment
+    uint64_t count;
+    double mean, m2; // Running moments of the throughputs (Welford), in GB/s
+};
+
+// Events of a thread since the last flush. Recording an event is a store in this ring, the trace file is only written by flushes
+struct event_ring {
+    struct event_record *records;
+    uint64_t head; // Events recorded since the last flush, including overwritten ones
+    uint16_t thread;
+};
+
+// Schedule of the reads of a paced loop
+struct pacer {
+    uint64_t interarrival_ns;
+    uint64_t due_ns; // When the next read is due, 0 before the first one
+    uint64_t rng_state; // Gaps of the Poisson schedule
+};
+
+// A minimal io_uring instance with registered buffers and a single registered file, driven through raw syscalls
+struct io_uring_engine {
+    int ring_fd;
+    bool sqpoll;
+    unsigned entries, inflight, queued, next_buffer;
+    unsigned *sq_head, *sq_tail, *sq_mask, *sq_flags, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sq_ring, *cq_ring;
+    size_t sq_ring_size, cq_ring_size;
+    struct iovec *buffers;
+    unsigned buffer_count;
+    uint64_t buffer_size;
+};
+
+// Strategies available to each reader thread of the multi-threaded benchmark. Hints only ever target the region of the thread
+enum reader_strategy {
+    READER_STRATEGY_NOT_CACHED,
+    READER_STRATEGY_SEQUENTIAL,
+    READER_STRATEGY_RANDOM,
+    READER_STRATEGY_OFFLINE_PREFETCH,
+    READER_STRATEGY_COUNT
+};
+static const char *reader_strategy_labels[] = {
+    "Not cached",
+    "Not cached but marked as sequential",
+    "Not cached but marked as random",
+    "Offline prefetch\\n(sync read)",
+};
+static const char *reader_strategy_names[] = {
+    "multithreaded/not_cached",
+    "multithreaded/sequential",
+    "multithreaded/random",
+    "multithreaded/offline_prefetch",
+};
+
+// Hints given by the mmap reader on its mapping, which is then read through page faults instead of read()
+enum mmap_strategy {
+    MMAP_STRATEGY_NO_HINT,
+    MMAP_STRATEGY_SEQUENTIAL,
+    MMAP_STRATEGY_RANDOM,
+    MMAP_STRATEGY_WILLNEED,
+    MMAP_STRATEGY_POPULATE_READ,
+    MMAP_STRATEGY_HUGEPAGE,
+    MMAP_STRATEGY_COUNT
+};
+static const char *mmap_strategy_labels[] = {
+    "mmap without hint",
+    "mmap marked as sequential",
+    "mmap marked as random",
+    "mmap WILLNEED prefetch of the whole mapping",
+    "mmap POPULATE_READ prefault of the whole mapping",
+    "mmap marked as HUGEPAGE",
+};
+static const char *mmap_strategy_names[] = {
+    "mmap/no_hint",
+    "mmap/sequential",
+    "mmap/random",
+    "mmap/willneed",
+    "mmap/populate_read",
+    "mmap/hugepage",
+};
+
+// Every strategy of this benchmark with a benchmark loop of its own, as named on the command line. The others are registered,
+// see builtin_strategies
+static const char *strategy_names[] = {
+    "mmap/no_hint",
+    "mmap/sequential",
+    "mmap/random",
+    "mmap/willneed",
+    "mmap/populate_read",
+    "mmap/hugepage",
+    "multithreaded/not_cached",
+    "multithreaded/sequential",
+    "multithreaded/random",
+    "multithreaded/offline_prefetch",
+    NULL
+};
+
+// Campaign state: which strategies were selected, whether we only count configurations, and how many were counted
+static char *target_file_path = TARGET_FILE;
+static uint64_t target_file_size = 0;
+static char *output_file_path = OUTPUT_FILE;
+static uint64_t duration_per_experiment_us = DURATION_PER_EXPERIMENT_US;
+static uint64_t campaign_budget_us = 0; // 0 means unbounded
+static uint64_t campaign_start_us = 0; // When the campaign started running, which the budget counts from
+static uint64_t planned_configuration_count = 0; // Configurations counted by the estimate, which share the budget
+static uint64_t requested_duration_us = DURATION_PER_EXPERIMENT_US; // --duration, before configurations are shrunk to fit in the budget
+static uint64_t budget_skipped_count = 0; // Configurations that did not run, the budget being spent
+static double repetition_ci_width = REPETITION_CI_WIDTH;
+static uint64_t repetition_min_count = REPETITION_MIN_COUNT, repetition_max_count = REPETITION_MAX_COUNT;
+static char *event_trace_path = NULL; // NULL disables the event trace
+static uint64_t offset_alignment = OFFSET_ALIGNMENT;
+static double zipf_exponent = ZIPF_EXPONENT, gaussian_locality_stddev = GAUSSIAN_LOCALITY_STDDEV;
+static double hotspot_access_fraction = HOTSPOT_ACCESS_FRACTION, hotspot_data_fraction = HOTSPOT_DATA_FRACTION;
+static uint64_t page_cache_capacity = 0; // 0 unless --memory-ratios sized the files after it
+static char *selected_strategies[MAX_SWEEP_VALUES];
+static int selected_strategy_count = 0; // 0 means every strategy
+static bool dry_run = false;
+static bool list_strategies = false;
+static bool generate_target = false;
+static uint64_t configuration_count = 0;
+static uint64_t cache_drop_count = 0, cache_drop_fallback_count = 0;
+
+// Asynchronous prefetches the benchmark holds the handles of. They are cancelled before each cache drop, as they would otherwise
+// keep reading into the next experiment
+static struct iohints_prefetch *aio_prefetches[IOHINTS_PREFETCH_MAX_REQUESTS];
+static int aio_prefetch_count = 0;
+static pthread_mutex_t aio_prefetch_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// State of a reader thread of the multi-threaded benchmark
+struct reader_thread {
+    pthread_t thread;
+    pthread_barrier_t *barrier;
+    FILE *fp;
+    int id;
+    enum reader_strategy strategy;
+    uint64_t region_offset, region_size, io_size, io_interarrival_time_ns;
+    uint64_t read_duration, volume; // Last experiment
+    uint64_t total_read_duration, total_volume; // Whole campaign
+    struct latency_histogram histogram; // Whole campaign
+};
 
 // Used for throughput instrumentation 
 static inline uint64_t get_timestamp_us();
 
-// Use /proc/sys/vm/drop_caches to drop the client page cache 
+// Used for per-I/O latency instrumentation
+static inline uint64_t get_timestamp_ns();
+
+// Wait until a timestamp given by get_timestamp_ns
+static inline void sleep_until_ns(uint64_t due_ns);
+
+// Start a new schedule of reads, one every interarrival_ns on average. Streams of the same schedule draw different gaps
+static inline void pacer_reset(struct pacer *pacer, uint64_t interarrival_ns, uint64_t stream);
+
+// When the next read should have started. Latencies measured from there include the time the read spent waiting for the previous ones
+static inline uint64_t pacer_intended_start(struct pacer *pacer);
+
+// Wait for the next read to be due. Late reads are not waited for, and the schedule does not shift to make up for them
+static inline void pacer_wait(struct pacer *pacer);
+
+// Print the arrival schedule column of paced configurations
+static inline void arrival_schedule_fprint(FILE *output_file, uint64_t interarrival_ns);
+
+// Start repeating a configuration
+static inline void repetition_reset(struct repetition *repetition);
+
+// Record the experiment that just ended from the running totals of the loop, and tell whether another one is needed
+static inline bool repetition_continue(struct repetition *repetition, uint64_t volume, uint64_t read_duration);
+
+// Half width of the 95% confidence interval of the mean throughput
+static inline double repetition_ci(const struct repetition *repetition);
+
+// Print the repetition columns of a configuration
+static inline void repetition_fprint(FILE *output_file, const struct repetition *repetition);
+
+// Create the event trace file, and start recording the events of the main thread
+static void event_trace_open(const char *path);
+
+// Flush the events of the main thread and close the event trace file
+static void event_trace_close();
+
+// Start recording the events of the calling thread, if the event trace is enabled
+static void event_trace_thread_start(uint16_t thread);
+
+// Flush the events of the calling thread and stop recording them
+static void event_trace_thread_stop();
+
+// Timestamp to start an event with, only taken when the calling thread records events
+static inline uint64_t event_trace_now();
+
+// Record an event that started at start_ns and ends now, if the calling thread records events
+static inline void event_trace_record(enum event_type type, uint64_t start_ns, uint64_t offset, uint64_t size, int64_t result);
+
+// Seed a xoshiro256** generator, expanding the seed with splitmix64
+static inline void random_generator_seed(struct random_generator *generator, uint64_t seed);
+
+// Next 64 random bits of a xoshiro256** generator
+static inline uint64_t random_generator_next(struct random_generator *generator);
+
+// Uniform random number in [0, 1)
+static inline double random_generator_uniform(struct random_generator *generator);
+
+// Uniform random integer in [0, bound)
+static inline uint64_t random_generator_bounded(struct random_generator *generator, uint64_t bound);
+
+// Zipfian random integer in [1, n], by rejection-inversion (Hörmann and Derflinger)
+static inline uint64_t random_generator_zipf(struct random_generator *generator, uint64_t n, double exponent);
+
+// Print the distribution column of a configuration
+static inline void offset_distribution_fprint(FILE *output_file);
+
+// Print the size of the file relative to the page cache capacity as a column, when --memory-ratios sized the files
+static inline void memory_ratio_fprint(FILE *output_file, uint64_t file_size);
+
+// Number of random accesses of io_size bytes in a configuration: enough to read 10% of the file, or the size of the whole file when
+// --memory-ratios sized it, so that data gets accessed again and the sweep shows when the file stops fitting in the page cache
+static inline uint64_t random_access_count(uint64_t file_size, uint64_t io_size);
+
+// Alignment of the random offsets of accesses of io_size bytes
+static inline uint64_t random_offset_alignment(uint64_t io_size);
+
+// Fill offsets with count random offsets of io_size accesses, following the current distribution and multiples of alignment. Accesses
+// never go past the end of the file, and the same stream always gives the same offsets
+static inline void random_offsets_generate(uint64_t *offsets, uint64_t count, uint64_t file_size, uint64_t io_size, uint64_t alignment, uint64_t stream);
+
+// Write the events recorded by the calling thread to the event trace file. Only call it outside of timed regions
+static void event_trace_flush();
+
+// Empty a latency histogram
+static inline void latency_histogram_reset(struct latency_histogram *histogram);
+
+// Record a single latency, in ns
+static inline void latency_histogram_record(struct latency_histogram *histogram, uint64_t latency_ns);
+
+// Add every value of source to destination
+static inline void latency_histogram_merge(struct latency_histogram *destination, const struct latency_histogram *source);
+
+// Print the p50/p90/p99/p99.9/max latency columns (in us), and end the output line
+static inline void latency_histogram_fprint(FILE *output_file, const struct latency_histogram *histogram);
+
+// Evict a file from the client page cache, falling back to /proc/sys/vm/drop_caches only when some of it stays resident
 static inline void client_cache_drop(int fd);
 
+// Use /proc/sys/vm/drop_caches to drop the whole client page cache 
+static inline void client_cache_drop_global(int fd);
+
+// Count the pages of a range that are resident in the client page cache, using cachestat or mincore on older kernels. A length of 0 means up to the end of the file.
+// Returns RESIDENT_PAGES_UNKNOWN when they could not be counted
+static inline uint64_t client_cache_resident_pages(int fd, uint64_t offset, uint64_t length);
+
+// Fraction of the pages of a range that are resident in the client page cache, -1 when it could not be measured
+static inline double client_cache_resident_fraction(int fd, uint64_t offset, uint64_t length);
+
+// Start recording the residency of a new configuration, whose timed loops should start in the given state
+static inline void residency_record_reset(struct residency_record *record, enum residency_precondition precondition);
+
+// Snapshot the residency of a range right before a timed loop, and check the precondition
+static inline void residency_record_before(struct residency_record *record, int fd, uint64_t offset, uint64_t length);
+
+// Snapshot the residency of a range right after a timed loop
+static inline void residency_record_after(struct residency_record *record, int fd, uint64_t offset, uint64_t length);
+
+// Print the mean resident fractions (-1 when none could be measured) and the precondition failures as columns
+static inline void residency_record_fprint(FILE *output_file, const struct residency_record *record);
+
 // Use fadvise to evict some data from the client page cache 
 static inline void client_cache_evict(int fd, uint64_t offset, uint64_t length);
 
@@ -82,540 +490,602 @@ static inline void client_cache_prefetch(int fd, uint64_t offset, uint64_t lengt
 static inline void server_cache_prefetch(int fd, uint64_t offset, uint64_t length);
 #endif
 
-void perform_baseline_benchmark(char *target_file, FILE *output_file){
+// Use asynchronous I/O to forcefully prefetch some data 
+static inline void aio_prefetch(int fd, uint64_t offset, uint64_t length);
+
+// Give back the handles of the asynchronous prefetches that are over, or wait for the oldest one when none is. Called with aio_prefetch_mutex held
+static inline void aio_prefetches_reap();
+
+// Cancel the asynchronous prefetches still in flight and wait for them to be over
+static inline void aio_prefetches_cancel();
+
+// Run the experiments of a configuration of a registered strategy, and print its row
+static void registered_strategy_run(const struct iohints_strategy *strategy, struct iohints_strategy_run *run, uint64_t block_size, char *target_file, FILE *output_file, uint64_t io_size, uint64_t io_interarrival_time_ns);
+
+// Hooks of the built-in strategies driven by perform_registered_benchmark
+static int baseline_sequential_prepare(struct iohints_strategy_run *run);
+static int baseline_random_prepare(struct iohints_strategy_run *run);
+static int offline_prepare(struct iohints_strategy_run *run);
+static void offline_prefetch(struct iohints_strategy_run *run);
+#ifdef WITH_LUSTRE
+static void offline_ladvise_evict(struct iohints_strategy_run *run);
+#endif
+static void offline_drop_cache_evict(struct iohints_strategy_run *run);
+static void offline_fadvise_evict(struct iohints_strategy_run *run);
+static void oracle_fadvise_pre_read(struct iohints_strategy_run *run);
+static void oracle_fadvise_read(struct iohints_strategy_run *run, uint64_t read, uint64_t offset, uint64_t length);
+static void oracle_aio_pre_read(struct iohints_strategy_run *run);
+static void oracle_aio_read(struct iohints_strategy_run *run, uint64_t read, uint64_t offset, uint64_t length);
+#ifdef WITH_LUSTRE
+static void oracle_ladvise_pre_read(struct iohints_strategy_run *run);
+static void oracle_ladvise_read(struct iohints_strategy_run *run, uint64_t read, uint64_t offset, uint64_t length);
+#endif
+static void run_data_teardown(struct iohints_strategy_run *run);
+
+// Add a strategy to the registry of libiohints, refusing the names of the strategies with a benchmark loop of their own
+static void strategy_register(const struct iohints_strategy *strategy);
+
+// Load a strategy module, and register the strategies it returns
+static void strategy_module_load(const char *path);
+
+// Create an io_uring instance, register buffer_count aligned buffers of buffer_size bytes and the target file descriptor
+static inline void io_uring_engine_init(struct io_uring_engine *engine, int fd, unsigned buffer_count, uint64_t buffer_size, bool sqpoll);
+
+// Unregister everything and tear down the io_uring instance
+static inline void io_uring_engine_destroy(struct io_uring_engine *engine);
+
+// Queue a read of the registered file into a registered buffer. The buffer index is given back as the completion user_data
+static inline void io_uring_engine_queue_read(struct io_uring_engine *engine, unsigned buffer_index, uint64_t offset, uint64_t length);
+
+// Hand the queued reads over to the kernel
+static inline void io_uring_engine_submit(struct io_uring_engine *engine);
+
+// Wait for a single completion and consume it
+static inline void io_uring_engine_wait(struct io_uring_engine *engine, struct io_uring_cqe *cqe);
+
+// Wait for every in-flight read to complete
+static inline void io_uring_engine_drain(struct io_uring_engine *engine);
+
+// Give the madvise hint of an mmap strategy on a whole mapping. Returns false when the kernel does not support it
+static inline bool mmap_strategy_apply(enum mmap_strategy strategy, char *mapping, uint64_t length);
+
+// Find the logical block size of the device backing a file, which O_DIRECT offsets, sizes and buffers must be aligned to
+static inline uint64_t get_logical_block_size(int fd);
+
+// Parse the command line (and the config files it points to) into the sweep parameters
+static void parse_arguments(int argc, char **argv);
+
+// Tell whether a configuration of the sweep should run, and count it towards the campaign estimate
+static inline bool configuration_selected(const char *strategy, uint64_t file_size);
+
+// Fill thread_counts with 1, 2, 4... up to the number of online cores (included), and return how many counts were written
+static inline int get_reader_thread_counts(int *thread_counts);
+
+// Create the target file, and fill its first file_size bytes with the deterministic content of the libiohints generator
+static void generate_target_file(const char *path, uint64_t file_size);
+
+// Strategies whose only difference is how they hint the file, all run by perform_registered_benchmark
+static const struct iohints_strategy baseline_o_direct_strategy = {
+    "baseline/o_direct", "Baseline", "O_DIRECT", "File not cached, no readahead, using O_DIRECT with queue_depth reads in flight", IOHINTS_STRATEGY_DIRECT_IO,
+    NULL, NULL, NULL, NULL, NULL, NULL
+};
+static const struct iohints_strategy baseline_not_cached_strategy = {
+    "baseline/not_cached", "Baseline", "Not cached", "File not cached", 0, NULL, NULL, NULL, NULL, NULL, NULL
+};
+static const struct iohints_strategy baseline_sequential_strategy = {
+    "baseline/sequential", "Extended baseline", "Not cached but marked as sequential", "File not cached, but fadvise was used to mark it as sequential", 0,
+    baseline_sequential_prepare, NULL, NULL, NULL, NULL, NULL
+};
+static const struct iohints_strategy baseline_random_strategy = {
+    "baseline/random", "Extended baseline", "Not cached but marked as random", "File not cached, but fadvise was used to mark it as random", 0,
+    baseline_random_prepare, NULL, NULL, NULL, NULL, NULL
+};
+static const struct iohints_strategy offline_sync_read_strategy = {
+    "offline/sync_read", "Offline prefetch", "Offline prefetch\\n(sync read)", "File was read once before the experiment", IOHINTS_STRATEGY_CACHED,
+    offline_prepare, offline_prefetch, NULL, NULL, NULL, run_data_teardown
+};
+#ifdef WITH_LUSTRE
+static const struct iohints_strategy offline_ladvise_evict_strategy = {
+    "offline/ladvise_evict", "Offline prefetch", "Offline client-side prefetch\\n(sync read + ladvise evict)",
+    "File was read once before the experiment, but lla_ladvise was used to evict it from the server cache", IOHINTS_STRATEGY_CACHED,
+    offline_prepare, offline_prefetch, offline_ladvise_evict, NULL, NULL, run_data_teardown
+};
+#endif
+static const struct iohints_strategy offline_drop_cache_evict_strategy = {
+    "offline/drop_cache_evict", "Offline prefetch", "Offline server-side prefetch\\n(sync read + drop_cache evict)",
+    "File was read once before the experiment, but /proc/sys/vm/drop_caches was used to evict it from the client cache", 0,
+    offline_prepare, offline_prefetch, offline_drop_cache_evict, NULL, NULL, run_data_teardown
+};
+static const struct iohints_strategy offline_fadvise_evict_strategy = {
+    "offline/fadvise_evict", "Offline prefetch", "Offline server-side prefetch\\n(sync read + fadvise evict)",
+    "File was read once before the experiment, but fadvise was used to evict it from the client cache", 0,
+    offline_prepare, offline_prefetch, offline_fadvise_evict, NULL, NULL, run_data_teardown
+};
+static const struct iohints_strategy oracle_fadvise_strategy = {
+    "oracle/fadvise", "Oracle lookahead", "fadvise oracle lookahead", "The next lookahead_depth offsets are prefetched using fadvise",
+    IOHINTS_STRATEGY_LOOKAHEAD_DEPTHS, NULL, NULL, NULL, oracle_fadvise_pre_read, oracle_fadvise_read, NULL
+};
+static const struct iohints_strategy oracle_aio_strategy = {
+    "oracle/aio", "Oracle lookahead", "async-io oracle lookahead", "The next lookahead_depth offsets are prefetched using aio_read",
+    IOHINTS_STRATEGY_LOOKAHEAD_DEPTHS, NULL, NULL, NULL, oracle_aio_pre_read, oracle_aio_read, NULL
+};
+#ifdef WITH_LUSTRE
+static const struct iohints_strategy oracle_ladvise_strategy = {
+    "oracle/ladvise", "Oracle lookahead", "ladvise oracle lookahead", "The next lookahead_depth offsets are prefetched using llapi_ladvise",
+    IOHINTS_STRATEGY_LOOKAHEAD_DEPTHS, NULL, NULL, NULL, oracle_ladvise_pre_read, oracle_ladvise_read, NULL
+};
+#endif
+
+// Strategies registered before those of the strategy modules, which perform_registered_benchmark runs in this order
+static const struct iohints_strategy *builtin_strategies[] = {
+    &baseline_o_direct_strategy,
+    &baseline_not_cached_strategy,
+    &baseline_sequential_strategy,
+    &baseline_random_strategy,
+    &offline_sync_read_strategy,
+    #ifdef WITH_LUSTRE
+    &offline_ladvise_evict_strategy,
+    #endif
+    &offline_drop_cache_evict_strategy,
+    &offline_fadvise_evict_strategy,
+    &oracle_fadvise_strategy,
+    &oracle_aio_strategy,
+    #ifdef WITH_LUSTRE
+    &oracle_ladvise_strategy,
+    #endif
+    NULL
+};
+
+// Benchmark the registered strategies, the built-in ones then those of the strategy modules. They all read the file the same
+// way, and only differ by their hooks and by the sweeps their flags ask for
+void perform_registered_benchmark(char *target_file, FILE *output_file){
+    const struct iohints_strategy *const *strategies = iohints_strategy_registry();
+
+    // Direct I/Os must cover whole logical blocks of the device backing the file
+    int fd = open(target_file_path, O_RDONLY);
+    if(fd<0){
+        printf("Error opening file \"%s\": %s\n", target_file_path, strerror(errno));
+        exit(0);
+    }
+    uint64_t block_size = get_logical_block_size(fd);
+    close(fd);
+
     for(int h = 0; h<io_interarrival_time_count; h++){
         uint64_t io_interarrival_time_ns = io_interarrival_times[h];
 
-        // O_DIRECT
-        printf("O_DIRECT\n");
-        int fd = open(TARGET_FILE, O_RDONLY, O_DIRECT | O_SYNC); 
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
-
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
-
-                // Allocating the read buffer
-                char *buffer = malloc(sizeof(char)*io_size);
-
-                // Starting the campaign
-                int experiment_count; uint64_t total_volume=0;
-                uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
-
-                    // Cleaning the cache at the beginning of each experiment
-                    #ifdef WITH_LUSTRE
-                    server_cache_evict(fd, 0, file_size);
-                    #endif
-                    client_cache_drop(fd);
-                    // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
-
-                    // Running the experimentation once
-                    lseek(fd, 0, SEEK_SET);
-                    srand(RANDOM_SEED);
-                    uint64_t t1 = get_timestamp_us();
-                    size_t volume;
-                    for(volume = 0; volume<file_size*0.1; volume+=io_size){
-                        lseek(fd, rand() / (RAND_MAX / file_size + 1), SEEK_SET);
-                        int ret = read(fd, buffer, io_size);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                            exit(0);
-                        }
-                        if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
-                        }
-                    }
-                    read_duration += get_timestamp_us()-t1;
-                    total_volume+=volume;
-                }
-                
-                free(buffer);
-                fprintf(output_file, "target='%s', category='Baseline', label='O_DIRECT', "
-                    #if OUTPUT_EXPERIMENT_DESCRIPTION
-                    "desc='File not cached, no readahead, using O_DIRECT', "
-                    #endif
-                    "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size,
-                    total_volume/(read_duration*1e-6)/(1ul << 30));
-                fflush(output_file);
-            }
-        }
-        close(fd);
-
-        // Not cached
-        printf("Not cached\n");
-        FILE *fp = fopen(TARGET_FILE, "r");
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
-
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
-
-                // Allocating the read buffer
-                char *buffer = malloc(sizeof(char)*io_size);
-
-                // Starting the campaign
-                int experiment_count; uint64_t total_volume=0;
-                uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
-
-                    // Cleaning the cache at the beginning of each experiment
-                    #ifdef WITH_LUSTRE
-                    server_cache_evict(fileno(fp), 0, file_size);
-                    #endif
-                    client_cache_drop(fileno(fp));
-                    // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
-
-                    // Running the experimentation once
-                    fseek(fp, 0, SEEK_SET);
-                    srand(RANDOM_SEED);
-                    uint64_t t1 = get_timestamp_us();
-                    size_t volume;
-                    for(volume = 0; volume<file_size*0.1; volume+=io_size){
-                        fseek(fp, rand() / (RAND_MAX / file_size + 1), SEEK_SET);
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                            exit(0);
-                        }
-                        if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
-                        }
-                    }
-                    total_volume+=volume;
-                    read_duration += get_timestamp_us()-t1;
-                }
-                fprintf(output_file, "target='%s', category='Baseline', label='Not cached', "
-                    #if OUTPUT_EXPERIMENT_DESCRIPTION
-                    "desc='File not cached', "
-                    #endif
-                    "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size,
-                    total_volume/(read_duration*1e-6)/(1ul << 30));
-                free(buffer);
-                fflush(output_file);
-            }
-        }
+        for(int s = 0; strategies[s]; s++){
+            const struct iohints_strategy *strategy = strategies[s];
+            bool lookahead_depth_sweep = (strategy->flags & IOHINTS_STRATEGY_LOOKAHEAD_DEPTHS)!=0;
+            bool prefetch_delay_sweep = (strategy->flags & IOHINTS_STRATEGY_PREFETCH_DELAYS)!=0;
+            bool direct_io = (strategy->flags & IOHINTS_STRATEGY_DIRECT_IO)!=0;
 
-        // Not cached but marked as sequential
-        printf("Sequential\n");
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
-
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
-
-                // Allocating the read buffer
-                char *buffer = malloc(sizeof(char)*io_size);
-
-                // Starting the campaign
-                int experiment_count; uint64_t total_volume=0;
-                uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
-
-                    // Cleaning the cache at the beginning of each experiment
-                    #ifdef WITH_LUSTRE
-                    server_cache_evict(fileno(fp), 0, file_size);
-                    #endif
-                    client_cache_drop(fileno(fp));
-                    // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
-
-                    // Running the experimentation once
-                    fseek(fp, 0, SEEK_SET);
-                    posix_fadvise(fileno(fp), 0, file_size, POSIX_FADV_SEQUENTIAL);
-                    srand(RANDOM_SEED);
-                    uint64_t t1 = get_timestamp_us();
-                    size_t volume;
-                    for(volume = 0; volume<file_size*0.1; volume+=io_size){
-                        fseek(fp, rand() / (RAND_MAX / file_size + 1), SEEK_SET);
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                            exit(0);
-                        }
-                        if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
-                        }
-                    }
-                    read_duration += get_timestamp_us()-t1;
-                    total_volume+=volume;
-                }
-                fprintf(output_file, "target='%s', category='Extended baseline', label='Not cached but marked as sequential', "
-                    #if OUTPUT_EXPERIMENT_DESCRIPTION
-                    "desc='File not cached, but fadvise was used to mark it as sequential', "
-                    #endif
-                    "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size,
-                    total_volume/(read_duration*1e-6)/(1ul << 30));
-                free(buffer);
-                fflush(output_file);
-            }
-        }
+            for(int i = 0; i<file_size_count; i++){
+                uint64_t file_size = file_sizes[i];
 
-        printf("Random\n");
-        // Not cached but marked as random
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
-
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
-
-                // Allocating the read buffer
-                char *buffer = malloc(sizeof(char)*io_size);
-
-                // Starting the campaign
-                int experiment_count; uint64_t total_volume=0;
-                uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
-
-                    // Cleaning the cache at the beginning of each experiment
-                    #ifdef WITH_LUSTRE
-                    server_cache_evict(fileno(fp), 0, file_size);
-                    #endif
-                    client_cache_drop(fileno(fp));
-                    // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
-
-                    // Running the experimentation once
-                    fseek(fp, 0, SEEK_SET);
-                    posix_fadvise(fileno(fp), 0, file_size, POSIX_FADV_RANDOM);
-                    srand(RANDOM_SEED);
-                    uint64_t t1 = get_timestamp_us();
-                    size_t volume;
-                    for(volume = 0; volume<file_size*0.1; volume+=io_size){
-                        fseek(fp, rand() / (RAND_MAX / file_size + 1), SEEK_SET);
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                            exit(0);
-                        }
-                        if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
+                for(int j = 0; j<io_size_count; j++){
+                    uint64_t io_size = io_sizes[j];
+                    if(io_size>file_size) continue;
+                    uint64_t read_size = direct_io ? (io_size+block_size-1)/block_size*block_size : io_size;
+
+                    for(int k = 0; k<(lookahead_depth_sweep ? oracle_lookahead_depth_count : 1); k++){
+                        uint64_t lookahead_depth = lookahead_depth_sweep ? oracle_lookahead_depths[k] : 0;
+
+                        for(int d = 0; d<(prefetch_delay_sweep ? jit_prefetch_delay_count : 1); d++){
+                            uint64_t prefetch_delay = prefetch_delay_sweep ? jit_prefetch_delays[d] : 0;
+
+                            for(int q = 0; q<(direct_io ? direct_io_queue_depth_count : 1); q++){
+                                unsigned queue_depth = direct_io ? direct_io_queue_depths[q] : 1;
+                                if(direct_io && read_size*queue_depth>DIRECT_IO_MAX_POOL_SIZE) continue;
+
+                                if(!configuration_selected(strategy->name, file_size)) continue;
+
+                                struct iohints_strategy_run run = {-1, file_size, read_size, 0, lookahead_depth, prefetch_delay, queue_depth, 0, NULL, NULL};
+                                registered_strategy_run(strategy, &run, block_size, target_file, output_file, io_size, io_interarrival_time_ns);
+                            }
                         }
                     }
-                    read_duration += get_timestamp_us()-t1;
-                    total_volume+=volume;
                 }
-                fprintf(output_file, "target='%s', category='Extended baseline', label='Not cached but marked as random', "
-                    #if OUTPUT_EXPERIMENT_DESCRIPTION
-                    "desc='File not cached, but fadvise was used to mark it as random', "
-                    #endif
-                    "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size,
-                    total_volume/(read_duration*1e-6)/(1ul << 30));
-                free(buffer);
-                fflush(output_file);
             }
         }
-        fclose(fp);
     }
 }
 
-void perform_offline_prefetch_benchmark(char *target_file, FILE *output_file){
+void perform_mmap_benchmark(char *target_file, FILE *output_file){
 
     for(int h = 0; h<io_interarrival_time_count; h++){
         uint64_t io_interarrival_time_ns = io_interarrival_times[h];
-        FILE *fp = fopen(TARGET_FILE, "r");
-
-        // Cached
-        printf("Cached\n");
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
-
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
-
-                // Allocating the read buffer
-                char *buffer = malloc(sizeof(char)*io_size);
-
-                // Starting the campaign
-                int experiment_count; uint64_t total_volume=0;
-                uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
-
-                    // Cleaning the cache at the beginning of each experiment
-                    #ifdef WITH_LUSTRE
-                    server_cache_evict(fileno(fp), 0, file_size);
-                    #endif
-                    client_cache_drop(fileno(fp));
-                    // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
-
-                    // Running the experimentation once: first a dummy read to have the file in cache, then the instrumented read
-                    fseek(fp, 0, SEEK_SET);
-                    size_t volume;
-                    for(volume = 0; volume<file_size; volume+=io_size){
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
+        FILE *fp = fopen(target_file_path, "r");
+
+        // Reading through a memory mapping, with each of the madvise hints
+        for(int s = 0; s<MMAP_STRATEGY_COUNT; s++){
+            enum mmap_strategy strategy = s;
+            bool supported = true;
+
+            for(int i = 0; i<file_size_count && supported; i++){
+                uint64_t file_size = file_sizes[i];
+
+                for(int j = 0; j<io_size_count && supported; j++){
+                    uint64_t io_size = io_sizes[j];
+                    if(io_size>file_size) continue;
+
+                    if(!configuration_selected(mmap_strategy_names[strategy], file_size)) continue;
+
+                    // Allocating the read buffer, which the mapped data is copied to just like read() would. The offsets are computed up front
+                    char *buffer = malloc(sizeof(char)*io_size);
+                    uint64_t access_count = random_access_count(file_size, io_size);
+                    uint64_t *offsets = malloc(sizeof(uint64_t)*access_count);
+                    random_offsets_generate(offsets, access_count, file_size, io_size, random_offset_alignment(io_size), 0);
+                    struct latency_histogram histogram;
+                    latency_histogram_reset(&histogram);
+                    struct residency_record residency;
+                    residency_record_reset(&residency, RESIDENCY_COLD);
+
+                    // Starting the campaign
+                    int experiment_count; uint64_t total_volume=0;
+                    struct repetition repetition;
+                    repetition_reset(&repetition);
+                    uint64_t read_duration = 0;
+                    for(experiment_count=0; repetition_continue(&repetition, total_volume, read_duration); experiment_count++){
+
+                        // Cleaning the cache at the beginning of each experiment, then mapping the file
+                        #ifdef WITH_LUSTRE
+                        server_cache_evict(fileno(fp), 0, file_size);
+                        #endif
+                        client_cache_drop(fileno(fp));
+                        // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+                        char *mapping = mmap(NULL, file_size, PROT_READ, MAP_SHARED, fileno(fp), 0);
+                        if(mapping==MAP_FAILED){
+                            printf("Error mapping file \"%s\": %s\n", target_file_path, strerror(errno));
                             exit(0);
                         }
-                    }
-                    fseek(fp, 0, SEEK_SET);
-                    srand(RANDOM_SEED);
-                    uint64_t t1 = get_timestamp_us();
-                    for(volume = 0; volume<file_size*0.1; volume+=io_size){
-                        fseek(fp, rand() / (RAND_MAX / file_size + 1), SEEK_SET);
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                            exit(0);
-                        }
-                        if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
-                        }
-                    }
-                    read_duration += get_timestamp_us()-t1;
-                    total_volume+=volume;
-                }
-                fprintf(output_file, "target='%s', category='Offline prefetch', label='Offline prefetch\\n(sync read)', "
-                    #if OUTPUT_EXPERIMENT_DESCRIPTION
-                    "desc='File was read once before the experiment', "
-                    #endif
-                    "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size,
-                    total_volume/(read_duration*1e-6)/(1ul << 30));
-                free(buffer);
-                fflush(output_file);
-            }
-        }
 
-        // Cached client-side only
-        #ifdef WITH_LUSTRE
-        printf("Cached ladvise evicted\n");
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
-
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
-
-                // Allocating the read buffer
-                char *buffer = malloc(sizeof(char)*io_size);
-
-                // Starting the campaign
-                int experiment_count; uint64_t total_volume=0;
-                uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
-
-                    // Cleaning the cache at the beginning of each experiment
-                    #ifdef WITH_LUSTRE
-                    server_cache_evict(fileno(fp), 0, file_size);
-                    #endif
-                    client_cache_drop(fileno(fp));
-                    // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
-
-                    // Running the experimentation once: first a dummy read to have the file in cache, then the instrumented read
-                    fseek(fp, 0, SEEK_SET);
-                    size_t volume;
-                    for(volume = 0; volume<file_size*0.1; volume+=io_size){
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                            exit(0);
+                        // Running the experimentation once: the hint is part of the timed region, as POPULATE_READ does the reading itself
+                        residency_record_before(&residency, fileno(fp), 0, file_size);
+                        struct pacer pacer;
+                        pacer_reset(&pacer, io_interarrival_time_ns, 0);
+                        uint64_t t1 = get_timestamp_us();
+                        if(!mmap_strategy_apply(strategy, mapping, file_size)){
+                            printf("madvise is not supported for \"%s\" on \"%s\": %s, skipping\n", mmap_strategy_names[strategy], target_file_path, strerror(errno));
+                            supported = false;
+                            munmap(mapping, file_size);
+                            break;
                         }
-                    }
-                    server_cache_evict(fileno(fp), 0, file_size);
-                    
-                    fseek(fp, 0, SEEK_SET);
-                    srand(RANDOM_SEED);
-                    uint64_t t1 = get_timestamp_us();
-                    for(volume = 0; volume<file_size*0.1; volume+=io_size){
-                        fseek(fp, rand() / (RAND_MAX / file_size + 1), SEEK_SET);
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                            exit(0);
-                        }
-                        if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
+                        for(uint64_t a = 0; a<access_count; a++){
+                            uint64_t offset = offsets[a], length = io_size<file_size-offset ? io_size : file_size-offset;
+                            uint64_t t2 = pacer_intended_start(&pacer);
+                            memcpy(buffer, mapping+offset, length);
+                            latency_histogram_record(&histogram, get_timestamp_ns()-t2);
+                            event_trace_record(EVENT_READ, t2, offset, length, length);
+                            if(io_interarrival_time_ns!=0){
+                                read_duration += get_timestamp_us()-t1;
+                                pacer_wait(&pacer);
+                                t1 = get_timestamp_us();
+                            }
                         }
+                        read_duration += get_timestamp_us()-t1;
+                        event_trace_flush();
+                        residency_record_after(&residency, fileno(fp), 0, file_size);
+                        total_volume+=access_count*io_size;
+                        munmap(mapping, file_size);
                     }
-                    read_duration += get_timestamp_us()-t1;
-                    total_volume+=volume;
+                    if(supported){
+                        fprintf(output_file, "target='%s', category='mmap', label='%s', "
+                            #if OUTPUT_EXPERIMENT_DESCRIPTION
+                            "desc='The file is mapped, hinted with madvise, then randomly read through page faults', "
+                            #endif
+                            "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f", target_file, mmap_strategy_labels[strategy], file_size, io_interarrival_time_ns, io_size,
+                            total_volume/(read_duration*1e-6)/(1ul << 30));
+                        arrival_schedule_fprint(output_file, io_interarrival_time_ns);
+                        offset_distribution_fprint(output_file);
+                        memory_ratio_fprint(output_file, file_size);
+                        repetition_fprint(output_file, &repetition);
+                        residency_record_fprint(output_file, &residency);
+                        latency_histogram_fprint(output_file, &histogram);
+                    }
+                    free(buffer);
+                    free(offsets);
+                    fflush(output_file);
                 }
-                fprintf(output_file, "target='%s', category='Offline prefetch', label='Offline client-side prefetch\\n(sync read + ladvise evict)', "
-                    #if OUTPUT_EXPERIMENT_DESCRIPTION
-                    "desc='File was read once before the experiment, but lla_ladvise was used to evict it from the server cache', "
-                    #endif
-                    "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size,
-                    total_volume/(read_duration*1e-6)/(1ul << 30));
-                free(buffer);
-                fflush(output_file);
             }
         }
-        #endif
+        fclose(fp);
+    }
+}
 
-        // Cached server-side only (1)
-        printf("Cached server-side 1\n");
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
-
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
-
-                // Allocating the read buffer
-                char *buffer = malloc(sizeof(char)*io_size);
-
-                // Starting the campaign
-                int experiment_count; uint64_t total_volume=0;
-                uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
-
-                    // Cleaning the cache at the beginning of each experiment
-                    #ifdef WITH_LUSTRE
-                    server_cache_evict(fileno(fp), 0, file_size);
-                    #endif
-                    client_cache_drop(fileno(fp));
-                    // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
-
-                    // Running the experimentation once: first a dummy read to have the file in cache, then the instrumented read
-                    fseek(fp, 0, SEEK_SET);
-                    size_t volume;
-                    for(volume = 0; volume<file_size; volume+=io_size){
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                            exit(0);
-                        }
-                    }
-                    client_cache_drop(fileno(fp));
-                    
-                    fseek(fp, 0, SEEK_SET);
-                    srand(RANDOM_SEED);
-                    uint64_t t1 = get_timestamp_us();
-                    for(volume = 0; volume<file_size*0.1; volume+=io_size){
-                        fseek(fp, rand() / (RAND_MAX / file_size + 1), SEEK_SET);
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                            exit(0);
-                        }
-                        if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
-                        }
-                    }
-                    read_duration += get_timestamp_us()-t1;
-                    total_volume+=volume;
+// Body of a reader thread: hint its own region, wait for everyone, then read random places of the region
+static void *reader_thread_main(void *arg){
+    struct reader_thread *reader = arg;
+    int fd = fileno(reader->fp);
+    char *buffer = malloc(sizeof(char)*reader->io_size);
+    event_trace_thread_start(1+reader->id);
+
+    // Applying the strategy hints to the region of this thread, before everyone starts reading at the same time
+    switch(reader->strategy){
+        case READER_STRATEGY_SEQUENTIAL:
+            posix_fadvise(fd, reader->region_offset, reader->region_size, POSIX_FADV_SEQUENTIAL);
+            break;
+        case READER_STRATEGY_RANDOM:
+            posix_fadvise(fd, reader->region_offset, reader->region_size, POSIX_FADV_RANDOM);
+            break;
+        case READER_STRATEGY_OFFLINE_PREFETCH:
+            fseek(reader->fp, reader->region_offset, SEEK_SET);
+            for(size_t volume = 0; volume<reader->region_size; volume+=reader->io_size){
+                int ret = fread(buffer, sizeof(char), reader->io_size, reader->fp);
+                if(__glibc_unlikely(ret < 0)){
+                    printf("Error reading file \"%s\": %s\n", target_file_path, strerror(errno));
+                    exit(0);
                 }
-                fprintf(output_file, "target='%s', category='Offline prefetch', label='Offline server-side prefetch\\n(sync read + drop_cache evict)', "
-                    #if OUTPUT_EXPERIMENT_DESCRIPTION
-                    "desc='File was read once before the experiment, but /proc/sys/vm/drop_caches was used to evict it from the client cache', "
-                    #endif
-                    "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size,
-                    total_volume/(read_duration*1e-6)/(1ul << 30));
-                free(buffer);
-                fflush(output_file);
             }
+            break;
+        default:
+            break;
+    }
+    uint64_t access_count = random_access_count(reader->region_size, reader->io_size);
+    uint64_t *offsets = malloc(sizeof(uint64_t)*access_count);
+    random_offsets_generate(offsets, access_count, reader->region_size, reader->io_size, random_offset_alignment(reader->io_size), 1+reader->id); // Every thread has its own sequence
+    pthread_barrier_wait(reader->barrier);
+
+    // Reading random places of the region
+    reader->read_duration = 0;
+    struct pacer pacer;
+    pacer_reset(&pacer, reader->io_interarrival_time_ns, reader->region_offset);
+    uint64_t t1 = get_timestamp_us();
+    for(uint64_t a = 0; a<access_count; a++){
+        uint64_t offset = reader->region_offset+offsets[a];
+        fseek(reader->fp, offset, SEEK_SET);
+        uint64_t t2 = pacer_intended_start(&pacer);
+        int ret = fread(buffer, sizeof(char), reader->io_size, reader->fp);
+        latency_histogram_record(&reader->histogram, get_timestamp_ns()-t2);
+        event_trace_record(EVENT_READ, t2, offset, reader->io_size, ret);
+        if(__glibc_unlikely(ret < 0)){
+            printf("Error reading file \"%s\": %s\n", target_file_path, strerror(errno));
+            exit(0);
+        }
+        if(reader->io_interarrival_time_ns!=0){
+            reader->read_duration += get_timestamp_us()-t1;
+            pacer_wait(&pacer);
+            t1 = get_timestamp_us();
         }
+    }
+    reader->read_duration += get_timestamp_us()-t1;
+    reader->volume = access_count*reader->io_size;
 
-        // Cached server-side only (2)
-        printf("Cached server-side 2\n");
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
-
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
-
-                // Allocating the read buffer
-                char *buffer = malloc(sizeof(char)*io_size);
-
-                // Starting the campaign
-                int experiment_count; uint64_t total_volume=0;
-                uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
-
-                    // Cleaning the cache at the beginning of each experiment
-                    #ifdef WITH_LUSTRE
-                    server_cache_evict(fileno(fp), 0, file_size);
-                    #endif
-                    client_cache_drop(fileno(fp));
-                    // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
-
-                    // Running the experimentation once: first a dummy read to have the file in cache, then the instrumented read
-                    fseek(fp, 0, SEEK_SET);
-                    size_t volume;
-                    for(volume = 0; volume<file_size; volume+=io_size){
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                            exit(0);
+    event_trace_thread_stop();
+    free(offsets);
+    free(buffer);
+    return NULL;
+}
+
+void perform_multithreaded_benchmark(char *target_file, FILE *output_file){
+    int thread_counts[64];
+    int thread_count_count = get_reader_thread_counts(thread_counts);
+
+    for(int h = 0; h<io_interarrival_time_count; h++){
+        uint64_t io_interarrival_time_ns = io_interarrival_times[h];
+        FILE *fp = fopen(target_file_path, "r");
+
+        for(int s = 0; s<READER_STRATEGY_COUNT; s++){
+            enum reader_strategy strategy = s;
+
+            for(int i = 0; i<file_size_count; i++){
+                uint64_t file_size = file_sizes[i];
+
+                for(int j = 0; j<io_size_count; j++){
+                    uint64_t io_size = io_sizes[j];
+                    if(io_size>file_size) continue;
+
+                    for(int k = 0; k<thread_count_count; k++){
+                        int thread_count = thread_counts[k];
+
+                        if(!configuration_selected(reader_strategy_names[strategy], file_size)) continue;
+
+                        // Splitting the file in equal regions made of whole I/Os. The tail of the file might be left unread
+                        uint64_t region_size = file_size/thread_count/io_size*io_size;
+                        if(region_size==0) continue;
+
+                        // Each thread gets its own open file description, so that fadvise access patterns do not leak between threads
+                        struct reader_thread *readers = calloc(thread_count, sizeof(struct reader_thread));
+                        pthread_barrier_t barrier;
+                        for(int r = 0; r<thread_count; r++){
+                            readers[r].barrier = &barrier;
+                            readers[r].fp = fopen(target_file_path, "r");
+                            if(readers[r].fp == NULL){
+                                printf("Error opening file \"%s\": %s\n", target_file_path, strerror(errno));
+                                exit(0);
+                            }
+                            readers[r].id = r;
+                            readers[r].strategy = strategy;
+                            readers[r].region_offset = r*region_size;
+                            readers[r].region_size = region_size;
+                            readers[r].io_size = io_size;
+                            readers[r].io_interarrival_time_ns = io_interarrival_time_ns;
                         }
-                    }
-                    client_cache_evict(fileno(fp), 0, file_size);
-                    
-                    fseek(fp, 0, SEEK_SET);
-                    srand(RANDOM_SEED);
-                    uint64_t t1 = get_timestamp_us();
-                    for(volume = 0; volume<file_size*0.1; volume+=io_size){
-                        fseek(fp, rand() / (RAND_MAX / file_size + 1), SEEK_SET);
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                            exit(0);
+
+                        // Starting the campaign. The aggregate throughput is computed against the slowest reader of each experiment
+                        struct residency_record residency;
+                        residency_record_reset(&residency, RESIDENCY_COLD);
+                        int experiment_count;
+                        struct repetition repetition;
+                        repetition_reset(&repetition);
+                        uint64_t read_duration = 0, total_volume = 0;
+                        for(experiment_count=0; repetition_continue(&repetition, total_volume, read_duration); experiment_count++){
+
+                            // Cleaning the cache at the beginning of each experiment
+                            #ifdef WITH_LUSTRE
+                            server_cache_evict(fileno(fp), 0, file_size);
+                            #endif
+                            client_cache_drop(fileno(fp));
+                            // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+
+                            // Running the experimentation once, with all the threads at the same time. Residency is checked before they apply their hints
+                            residency_record_before(&residency, fileno(fp), 0, file_size);
+                            pthread_barrier_init(&barrier, NULL, thread_count);
+                            for(int r = 0; r<thread_count; r++){
+                                int ret = pthread_create(&readers[r].thread, NULL, reader_thread_main, &readers[r]);
+                                if(ret){
+                                    printf("Could not create reader thread: %s\n", strerror(ret));
+                                    exit(0);
+                                }
+                            }
+                            uint64_t slowest_read_duration = 0;
+                            for(int r = 0; r<thread_count; r++){
+                                pthread_join(readers[r].thread, NULL);
+                                readers[r].total_read_duration += readers[r].read_duration;
+                                readers[r].total_volume += readers[r].volume;
+                                total_volume += readers[r].volume;
+                                if(readers[r].read_duration>slowest_read_duration) slowest_read_duration = readers[r].read_duration;
+                            }
+                            pthread_barrier_destroy(&barrier);
+                            read_duration += slowest_read_duration;
+                            residency_record_after(&residency, fileno(fp), 0, file_size);
                         }
-                        if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
+
+                        // Per-thread throughputs over the whole campaign, and latencies of every thread
+                        double min_thread_throughput = INFINITY, max_thread_throughput = 0, mean_thread_throughput = 0;
+                        struct latency_histogram histogram;
+                        latency_histogram_reset(&histogram);
+                        for(int r = 0; r<thread_count; r++){
+                            latency_histogram_merge(&histogram, &readers[r].histogram);
+                            double thread_throughput = readers[r].total_volume/(readers[r].total_read_duration*1e-6)/(1ul << 30);
+                            if(thread_throughput<min_thread_throughput) min_thread_throughput = thread_throughput;
+                            if(thread_throughput>max_thread_throughput) max_thread_throughput = thread_throughput;
+                            mean_thread_throughput += thread_throughput/thread_count;
+                            fclose(readers[r].fp);
                         }
+                        free(readers);
+
+                        fprintf(output_file, "target='%s', category='Multi-threaded', label='%s', "
+                            #if OUTPUT_EXPERIMENT_DESCRIPTION
+                            "desc='The file is split in one region per thread, and each thread applies the strategy to its own region', "
+                            #endif
+                            "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, thread_count=%d, throughput_gb_per_second=%.3f, "
+                            "mean_thread_throughput_gb_per_second=%.3f, min_thread_throughput_gb_per_second=%.3f, max_thread_throughput_gb_per_second=%.3f",
+                            target_file, reader_strategy_labels[strategy], file_size, io_interarrival_time_ns, io_size, thread_count,
+                            total_volume/(read_duration*1e-6)/(1ul << 30), mean_thread_throughput, min_thread_throughput, max_thread_throughput);
+                        arrival_schedule_fprint(output_file, io_interarrival_time_ns);
+                        offset_distribution_fprint(output_file);
+                        memory_ratio_fprint(output_file, file_size);
+                        repetition_fprint(output_file, &repetition);
+                        residency_record_fprint(output_file, &residency);
+                        latency_histogram_fprint(output_file, &histogram);
+                        fflush(output_file);
                     }
-                    read_duration += get_timestamp_us()-t1;
-                    total_volume+=volume;
                 }
-                fprintf(output_file, "target='%s', category='Offline prefetch', label='Offline server-side prefetch\\n(sync read + fadvise evict)', "
-                    #if OUTPUT_EXPERIMENT_DESCRIPTION
-                    "desc='File was read once before the experiment, but fadvise was used to evict it from the client cache', "
-                    #endif
-                    "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size,
-                    total_volume/(read_duration*1e-6)/(1ul << 30));
-                free(buffer);
-                fflush(output_file);
             }
         }
         fclose(fp);
     }
 }
 
+// Run every benchmark of this binary. In dry-run mode, configurations are only counted
+static void perform_campaign(FILE *output_file){
+    configuration_count = 0;
+    for(int d = 0; d<offset_distribution_count; d++){
+        offset_distribution = offset_distributions[d];
+        perform_registered_benchmark(target_file_path, output_file);
+        perform_mmap_benchmark(target_file_path, output_file);
+        perform_multithreaded_benchmark(target_file_path, output_file);
+    }
+}
+
 int main(int argc, char **argv){
-    #ifdef WITH_LUSTRE
-    FILE *log_file = fopen("output-lustre.csv", "w");
-    #else
-    FILE *log_file = fopen("output.csv", "w");
-    #endif
-    if(log_file <= 0){
-        printf("Error opening file \"output.csv\": %s\n", strerror(errno));
+    parse_arguments(argc, argv);
+    uint64_t largest_file_size = 0;
+    for(int i = 0; i<file_size_count; i++) if(file_sizes[i]>largest_file_size) largest_file_size = file_sizes[i];
+
+    // Generator mode: only create a target file big enough for the largest file size
+    if(generate_target){
+        generate_target_file(target_file_path, largest_file_size);
+        return 0;
+    }
+
+    // Combinations needing more data than the target file holds are skipped, so we need its size
+    struct stat st;
+    if(stat(target_file_path, &st)<0){
+        printf("Error opening file \"%s\": %s\n", target_file_path, strerror(errno));
+        exit(0);
+    }
+    target_file_size = st.st_size;
+    if(largest_file_size>target_file_size){
+        printf("\"%s\" only holds %.3f GB, so file sizes above that are skipped. Use --generate to create a big enough one\n", target_file_path,
+            target_file_size/(double)(1ul << 30));
+    }
+
+    // Holes are read as zeros without touching the disk, which would inflate read throughputs
+    uint64_t tested_size = largest_file_size<target_file_size ? largest_file_size : target_file_size;
+    int fd = open(target_file_path, O_RDONLY);
+    off_t hole = fd<0 ? -1 : lseek(fd, 0, SEEK_HOLE);
+    if(fd>=0) close(fd);
+    if(hole>=0 && (uint64_t)hole<tested_size){
+        printf("\"%s\" is sparse: only its first %.3f GB out of %.3f GB are allocated. Use --generate to fill it\n", target_file_path,
+            hole/(double)(1ul << 30), tested_size/(double)(1ul << 30));
+        exit(0);
+    }
+
+    // Estimating the campaign duration, and shrinking the duration of each configuration to fit in the budget
+    bool list_only = dry_run;
+    dry_run = true;
+    perform_campaign(NULL);
+    dry_run = list_only;
+    if(configuration_count==0){
+        printf("No configuration left to run: check the selected strategies and that \"%s\" is big enough\n", target_file_path);
+        exit(0);
+    }
+    planned_configuration_count = configuration_count;
+    requested_duration_us = duration_per_experiment_us;
+    if(campaign_budget_us!=0 && configuration_count*duration_per_experiment_us>campaign_budget_us){
+        duration_per_experiment_us = campaign_budget_us/configuration_count;
+        if(duration_per_experiment_us==0) duration_per_experiment_us = 1;
+        printf("Shrinking the duration of each configuration to %.3f s to fit in the campaign budget\n", duration_per_experiment_us*1e-6);
+    }
+    uint64_t estimate_s = configuration_count*duration_per_experiment_us/(uint64_t)1e6;
+    // Only an approximation: the cache drops and the preparation of each experiment are not counted, while the confidence
+    // interval can end the repetitions early. The budget, when there is one, is what caps the campaign
+    printf("Campaign: %llu configurations x %.3f s, estimated to take about %lluh%02llum%02llus%s\n", configuration_count,
+        duration_per_experiment_us*1e-6, estimate_s/3600, estimate_s/60%60, estimate_s%60, campaign_budget_us!=0 ? ", capped by the budget" : "");
+    if(dry_run) return 0;
+
+    FILE *log_file = fopen(output_file_path, "w");
+    if(log_file == NULL){
+        printf("Error opening file \"%s\": %s\n", output_file_path, strerror(errno));
         exit(0);
     }
-    perform_baseline_benchmark(TARGET_FILE, log_file);
-    perform_offline_prefetch_benchmark(TARGET_FILE, log_file);
+    if(event_trace_path) event_trace_open(event_trace_path);
+    campaign_start_us = get_timestamp_us();
+    perform_campaign(log_file);
+    if(event_trace_path) event_trace_close();
     fclose(log_file);
+    if(budget_skipped_count>0) printf("%llu configurations were skipped, the campaign budget being spent\n", budget_skipped_count);
+    if(cache_drop_fallback_count>0) printf("%llu of the %llu cache resets could not evict the file alone, and dropped the whole page cache\n", cache_drop_fallback_count, cache_drop_count);
 }
 
 // Used for throughput instrumentation 
 static inline uint64_t get_timestamp_us(){
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    return tv.tv_sec*(uint64_t)1e6+tv.tv_usec;
+    return get_timestamp_ns()/1000;
 }
 
-// Use /proc/sys/vm/drop_caches to drop the client page cache 
+// Evict a file from the client page cache, falling back to /proc/sys/vm/drop_caches only when some of it stays resident
 static inline void client_cache_drop(int fd){
+
+    // Asynchronous prefetches still in flight would bring the file back
+    aio_prefetches_cancel();
+
+    // Dirty pages cannot be evicted, and pages still being read by a previous prefetch may come back: a few attempts are made
+    cache_drop_count++;
+    fdatasync(fd);
+    // An eviction that cannot be verified is not trusted, and the whole page cache is dropped instead
+    for(int attempt = 0; attempt<CACHE_EVICT_ATTEMPTS; attempt++){
+        client_cache_evict(fd, 0, 0);
+        uint64_t resident_pages = client_cache_resident_pages(fd, 0, 0);
+        if(resident_pages==0) return;
+        if(resident_pages==RESIDENT_PAGES_UNKNOWN) break;
+    }
+    cache_drop_fallback_count++;
+    client_cache_drop_global(fd);
+}
+
+// Use /proc/sys/vm/drop_caches to drop the whole client page cache 
+static inline void client_cache_drop_global(int fd){
     sync();
     char *data = "3";
     int fd2 = open("/proc/sys/vm/drop_caches", O_WRONLY);
@@ -642,50 +1112,1471 @@ static inline void client_cache_drop(int fd){
 
 // Use fadvise to evict some data from the client page cache 
 static inline void client_cache_evict(int fd, uint64_t offset, uint64_t length){
-    posix_fadvise(fd, offset, offset+length, POSIX_FADV_DONTNEED);
+    iohints_client_evict(fd, offset, length);
+}
+
+// Count the pages of a range that are resident in the client page cache, using cachestat or mincore on older kernels. A length of 0 means up to the end of the file.
+// Returns RESIDENT_PAGES_UNKNOWN when they could not be counted
+static inline uint64_t client_cache_resident_pages(int fd, uint64_t offset, uint64_t length){
+    struct cachestat_range range = {offset, length};
+    struct cachestat stat;
+    if(syscall(__NR_cachestat, fd, &range, &stat, 0)==0) return stat.nr_cache;
+
+    // mincore only works on mappings, which must start on a page boundary
+    struct stat file_stat;
+    if(fstat(fd, &file_stat)<0) return RESIDENT_PAGES_UNKNOWN;
+    if(offset>=(uint64_t)file_stat.st_size) return 0;
+    if(length==0 || offset+length>(uint64_t)file_stat.st_size) length = file_stat.st_size-offset;
+    uint64_t page_size = sysconf(_SC_PAGESIZE);
+    uint64_t map_offset = offset/page_size*page_size, map_length = offset+length-map_offset;
+    uint64_t page_count = (map_length+page_size-1)/page_size, resident_pages = 0;
+    char *mapping = mmap(NULL, map_length, PROT_READ, MAP_SHARED, fd, map_offset);
+    if(mapping==MAP_FAILED) return RESIDENT_PAGES_UNKNOWN;
+    unsigned char *residency = malloc(page_count);
+    if(mincore(mapping, map_length, residency)==0){
+        for(uint64_t i = 0; i<page_count; i++) resident_pages += residency[i]&1;
+    }
+    else resident_pages = RESIDENT_PAGES_UNKNOWN;
+    free(residency);
+    munmap(mapping, map_length);
+    return resident_pages;
 }
 
 // Use lla_ladvise to evict some data from the server page cache
 #ifdef WITH_LUSTRE
 static inline void server_cache_evict(int fd, uint64_t offset, uint64_t length){
-    struct llapi_lu_ladvise advises;
-    memset(&advises, 0, sizeof(struct llapi_lu_ladvise));
-    advises.lla_advice = LU_LADVISE_DONTNEED;
-    advises.lla_start = offset;
-    advises.lla_end = offset+length;
-    llapi_ladvise(fd, 0, 1, &advises);
+    aio_prefetches_cancel();
+    iohints_server_evict(fd, offset, length);
 }
 #endif
 
 // Use fadvise to prefetch some data to the client page cache  
 static inline void client_cache_prefetch(int fd, uint64_t offset, uint64_t length){
-    posix_fadvise(fd, offset, length, POSIX_FADV_WILLNEED);
+    uint64_t start_ns = event_trace_now();
+    int ret = iohints_client_prefetch(fd, offset, length);
+    event_trace_record(EVENT_HINT_FADVISE, start_ns, offset, length, ret);
 }
 
 // Use lla_ladvise to prefetch some data to the server page cache
 #ifdef WITH_LUSTRE
 static inline void server_cache_prefetch(int fd, uint64_t offset, uint64_t length){
-    struct llapi_lu_ladvise advises;
-    memset(&advises, 0, sizeof(struct llapi_lu_ladvise));
-    advises.lla_advice = LU_LADVISE_WILLREAD;
-    advises.lla_start = offset;
-    advises.lla_end = offset + length;
-    llapi_ladvise(fd, 0, 1, &advises);
+    uint64_t start_ns = event_trace_now();
+    int ret = iohints_server_prefetch(fd, offset, length);
+    event_trace_record(EVENT_HINT_LADVISE, start_ns, offset, length, ret);
 }
 #endif
 
-// Use asynchronous I/O to forcefully prefetch some data 
+// Use asynchronous I/O to forcefully prefetch some data. The handle is kept, so that the prefetch can be cancelled before the next cache drop
 static inline void aio_prefetch(int fd, uint64_t offset, uint64_t length){
-    static char *buffer = 0;
-    if(buffer == 0) buffer = malloc(sizeof(char)*file_sizes[file_size_count-1]);
-    off_t current_offset = lseek(fd, 0, SEEK_CUR);
-    struct aiocb aiocbp;
-    memset(&aiocbp, 0, sizeof(struct aiocb));
-    aiocbp.aio_fildes = fd;
-    aiocbp.aio_buf = buffer;
-    aiocbp.aio_nbytes = length;
-    aiocbp.aio_offset = offset; // No need to lseek
-    aiocbp.aio_sigevent.sigev_notify = SIGEV_NONE;
-    aio_read(&aiocbp);
-    lseek(fd, current_offset, SEEK_SET);
+    pthread_mutex_lock(&aio_prefetch_mutex);
+    if(aio_prefetch_count==IOHINTS_PREFETCH_MAX_REQUESTS) aio_prefetches_reap();
+    struct iohints_prefetch *prefetch;
+    uint64_t start_ns = event_trace_now();
+    int ret = iohints_aio_prefetch(fd, offset, length, &prefetch);
+    event_trace_record(EVENT_HINT_AIO, start_ns, offset, length, ret);
+    if(ret==0) aio_prefetches[aio_prefetch_count++] = prefetch;
+    pthread_mutex_unlock(&aio_prefetch_mutex);
+}
+
+// Give back the handles of the asynchronous prefetches that are over, or wait for the oldest one when none is. Called with aio_prefetch_mutex held
+static inline void aio_prefetches_reap(){
+    int kept_count = 0;
+    for(int p = 0; p<aio_prefetch_count; p++){
+        if(iohints_prefetch_poll(aio_prefetches[p])==EINPROGRESS) aio_prefetches[kept_count++] = aio_prefetches[p];
+        else iohints_prefetch_release(aio_prefetches[p]);
+    }
+    aio_prefetch_count = kept_count;
+    if(aio_prefetch_count==IOHINTS_PREFETCH_MAX_REQUESTS){
+        iohints_prefetch_wait(aio_prefetches[0]);
+        iohints_prefetch_release(aio_prefetches[0]);
+        memmove(aio_prefetches, aio_prefetches+1, sizeof(struct iohints_prefetch *)*--aio_prefetch_count);
+    }
+}
+
+// Cancel the asynchronous prefetches still in flight and wait for them to be over
+static inline void aio_prefetches_cancel(){
+    pthread_mutex_lock(&aio_prefetch_mutex);
+    for(int p = 0; p<aio_prefetch_count; p++) iohints_prefetch_cancel(aio_prefetches[p]);
+    for(int p = 0; p<aio_prefetch_count; p++){
+        iohints_prefetch_wait(aio_prefetches[p]);
+        iohints_prefetch_release(aio_prefetches[p]);
+    }
+    aio_prefetch_count = 0;
+    pthread_mutex_unlock(&aio_prefetch_mutex);
+}
+
+// Run the experiments of a configuration of a registered strategy, and print its row
+static void registered_strategy_run(const struct iohints_strategy *strategy, struct iohints_strategy_run *run, uint64_t block_size, char *target_file, FILE *output_file, uint64_t io_size, uint64_t io_interarrival_time_ns){
+    bool lookahead_depth_sweep = (strategy->flags & IOHINTS_STRATEGY_LOOKAHEAD_DEPTHS)!=0;
+    bool prefetch_delay_sweep = (strategy->flags & IOHINTS_STRATEGY_PREFETCH_DELAYS)!=0;
+    bool direct_io = (strategy->flags & IOHINTS_STRATEGY_DIRECT_IO)!=0;
+    uint64_t file_size = run->file_size;
+
+    // Opening the file for this configuration only, so that the advice a strategy gives does not outlive it
+    FILE *fp = NULL;
+    if(direct_io) run->fd = open(target_file_path, O_RDONLY | O_DIRECT);
+    else if((fp = fopen(target_file_path, "r"))) run->fd = fileno(fp);
+    if(run->fd<0){
+        printf("Error opening file \"%s\"%s: %s\n", target_file_path, direct_io ? " with O_DIRECT" : "", strerror(errno));
+        exit(0);
+    }
+
+    // Computing the offsets the reader is going to seek to, which the strategy knows. O_DIRECT needs them aligned to the logical
+    // block size
+    run->read_count = random_access_count(file_size, run->io_size);
+    uint64_t *offsets = malloc(sizeof(uint64_t)*run->read_count);
+    uint64_t alignment = random_offset_alignment(run->io_size);
+    if(direct_io && alignment%block_size!=0) alignment += block_size-alignment%block_size;
+    random_offsets_generate(offsets, run->read_count, file_size, run->io_size, alignment, 0);
+    run->offsets = offsets;
+    if(strategy->prepare && strategy->prepare(run)!=0){
+        free(offsets);
+        if(fp) fclose(fp);
+        else close(run->fd);
+        return;
+    }
+
+    // Allocating the read buffer, or for direct reads the aligned buffer pool: one registered buffer per read in flight
+    char *buffer = NULL;
+    struct io_uring_engine engine;
+    uint64_t *submit_times = NULL, *submit_offsets = NULL;
+    if(direct_io){
+        io_uring_engine_init(&engine, run->fd, run->queue_depth, run->io_size, false);
+        submit_times = malloc(sizeof(uint64_t)*run->queue_depth);
+        submit_offsets = malloc(sizeof(uint64_t)*run->queue_depth);
+    }
+    else buffer = malloc(sizeof(char)*run->io_size);
+    struct latency_histogram histogram;
+    latency_histogram_reset(&histogram);
+    struct residency_record residency;
+    residency_record_reset(&residency, (strategy->flags & IOHINTS_STRATEGY_CACHED) ? RESIDENCY_WARM : prefetch_delay_sweep ? RESIDENCY_ANY : RESIDENCY_COLD);
+
+    // Starting the campaign
+    int experiment_count; uint64_t total_volume=0;
+    struct repetition repetition;
+    repetition_reset(&repetition);
+    uint64_t read_duration = 0;
+    for(experiment_count=0; repetition_continue(&repetition, total_volume, read_duration); experiment_count++){
+
+        // Cleaning the cache at the beginning of each experiment
+        #ifdef WITH_LUSTRE
+        server_cache_evict(run->fd, 0, file_size);
+        #endif
+        client_cache_drop(run->fd);
+        // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+
+        // Letting the strategy load the file and evict some of it, then waiting for a bit
+        if(strategy->prefetch) strategy->prefetch(run);
+        if(strategy->evict) strategy->evict(run);
+        if(prefetch_delay_sweep) usleep(run->prefetch_delay);
+
+        // Running the experimentation: reading, and letting the strategy hint before each read
+        residency_record_before(&residency, run->fd, 0, file_size);
+        struct pacer pacer;
+        pacer_reset(&pacer, io_interarrival_time_ns, 0);
+        uint64_t t1 = get_timestamp_us();
+        if(strategy->pre_read) strategy->pre_read(run);
+        if(direct_io){
+
+            // Filling the queue, then issuing a new read each time one completes
+            uint64_t a = 0;
+            for(unsigned b = 0; b<run->queue_depth && a<run->read_count; b++, a++){
+                if(strategy->on_read) strategy->on_read(run, a, offsets[a], run->io_size);
+                submit_times[b] = get_timestamp_ns();
+                submit_offsets[b] = offsets[a];
+                io_uring_engine_queue_read(&engine, b, offsets[a], run->io_size);
+            }
+            io_uring_engine_submit(&engine);
+            while(engine.inflight>0){
+                struct io_uring_cqe cqe;
+                io_uring_engine_wait(&engine, &cqe);
+                latency_histogram_record(&histogram, get_timestamp_ns()-submit_times[cqe.user_data]);
+                event_trace_record(EVENT_READ, submit_times[cqe.user_data], submit_offsets[cqe.user_data], run->io_size, cqe.res);
+                if(__glibc_unlikely(cqe.res < 0)){
+                    printf("Error reading file \"%s\": %s\n", target_file_path, strerror(-cqe.res));
+                    exit(0);
+                }
+                if(a>=run->read_count) continue;
+                if(io_interarrival_time_ns!=0){
+                    read_duration += get_timestamp_us()-t1;
+                    pacer_wait(&pacer);
+                    t1 = get_timestamp_us();
+                }
+                if(strategy->on_read) strategy->on_read(run, a, offsets[a], run->io_size);
+                submit_times[cqe.user_data] = pacer_intended_start(&pacer);
+                submit_offsets[cqe.user_data] = offsets[a];
+                io_uring_engine_queue_read(&engine, cqe.user_data, offsets[a], run->io_size);
+                io_uring_engine_submit(&engine);
+                a++;
+            }
+        }
+        else{
+            for(uint64_t a = 0; a<run->read_count; a++){
+                uint64_t offset = offsets[a];
+                if(strategy->on_read) strategy->on_read(run, a, offset, run->io_size);
+                fseek(fp, offset, SEEK_SET);
+                uint64_t t2 = pacer_intended_start(&pacer);
+                int ret = fread(buffer, sizeof(char), run->io_size, fp);
+                latency_histogram_record(&histogram, get_timestamp_ns()-t2);
+                event_trace_record(EVENT_READ, t2, offset, run->io_size, ret);
+                if(__glibc_unlikely(ret < 0)){
+                    printf("Error reading file \"%s\": %s\n", target_file_path, strerror(errno));
+                    exit(0);
+                }
+                if(io_interarrival_time_ns!=0){
+                    read_duration += get_timestamp_us()-t1;
+                    pacer_wait(&pacer);
+                    t1 = get_timestamp_us();
+                }
+            }
+        }
+        read_duration += get_timestamp_us()-t1;
+        event_trace_flush();
+        residency_record_after(&residency, run->fd, 0, file_size);
+        total_volume+=run->read_count*run->io_size;
+    }
+    if(strategy->teardown) strategy->teardown(run);
+    fprintf(output_file, "target='%s', category='%s', label='%s', "
+        #if OUTPUT_EXPERIMENT_DESCRIPTION
+        "desc='%s', "
+        #endif
+        "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, ", target_file, strategy->category, strategy->label,
+        #if OUTPUT_EXPERIMENT_DESCRIPTION
+        strategy->description,
+        #endif
+        file_size, io_interarrival_time_ns, io_size);
+    if(lookahead_depth_sweep) fprintf(output_file, "lookahead_depth=%llu, ", run->lookahead_depth);
+    if(prefetch_delay_sweep) fprintf(output_file, "prefetch_delay=%llu, ", run->prefetch_delay);
+    if(direct_io) fprintf(output_file, "queue_depth=%u, ", run->queue_depth);
+    fprintf(output_file, "throughput_gb_per_second=%.3f", total_volume/(read_duration*1e-6)/(1ul << 30));
+    arrival_schedule_fprint(output_file, io_interarrival_time_ns);
+    offset_distribution_fprint(output_file);
+    memory_ratio_fprint(output_file, file_size);
+    repetition_fprint(output_file, &repetition);
+    residency_record_fprint(output_file, &residency);
+    latency_histogram_fprint(output_file, &histogram);
+    if(direct_io){
+        io_uring_engine_destroy(&engine);
+        free(submit_times);
+        free(submit_offsets);
+    }
+    free(buffer);
+    free(offsets);
+    if(fp) fclose(fp);
+    else close(run->fd);
+    fflush(output_file);
+}
+
+// Hooks of the built-in strategies driven by perform_registered_benchmark
+static int baseline_sequential_prepare(struct iohints_strategy_run *run){
+    posix_fadvise(run->fd, 0, run->file_size, POSIX_FADV_SEQUENTIAL);
+    return 0;
+}
+
+static int baseline_random_prepare(struct iohints_strategy_run *run){
+    posix_fadvise(run->fd, 0, run->file_size, POSIX_FADV_RANDOM);
+    return 0;
+}
+
+// Offline strategies read the whole file before each experiment, io size at a time
+static int offline_prepare(struct iohints_strategy_run *run){
+    run->data = malloc(sizeof(char)*run->io_size);
+    return 0;
+}
+
+static void offline_prefetch(struct iohints_strategy_run *run){
+    for(uint64_t offset = 0; offset<run->file_size; offset+=run->io_size){
+        if(__glibc_unlikely(pread(run->fd, run->data, run->io_size, offset) < 0)){
+            printf("Error reading file \"%s\": %s\n", target_file_path, strerror(errno));
+            exit(0);
+        }
+    }
+}
+
+#ifdef WITH_LUSTRE
+static void offline_ladvise_evict(struct iohints_strategy_run *run){
+    server_cache_evict(run->fd, 0, run->file_size);
+}
+#endif
+
+static void offline_drop_cache_evict(struct iohints_strategy_run *run){
+    client_cache_drop(run->fd);
+}
+
+static void offline_fadvise_evict(struct iohints_strategy_run *run){
+    client_cache_evict(run->fd, 0, run->file_size);
+}
+
+// Oracle strategies hint the first lookahead_depth accesses, then keep lookahead_depth accesses hinted ahead of the reader
+static void oracle_fadvise_pre_read(struct iohints_strategy_run *run){
+    for(uint64_t a = 0; a<run->lookahead_depth && a<run->read_count; a++) client_cache_prefetch(run->fd, run->offsets[a], run->io_size);
+}
+
+static void oracle_fadvise_read(struct iohints_strategy_run *run, uint64_t read, uint64_t offset, uint64_t length){
+    if(read+run->lookahead_depth<run->read_count) client_cache_prefetch(run->fd, run->offsets[read+run->lookahead_depth], run->io_size);
+}
+
+static void oracle_aio_pre_read(struct iohints_strategy_run *run){
+    for(uint64_t a = 0; a<run->lookahead_depth && a<run->read_count; a++) aio_prefetch(run->fd, run->offsets[a], run->io_size);
+}
+
+static void oracle_aio_read(struct iohints_strategy_run *run, uint64_t read, uint64_t offset, uint64_t length){
+    if(read+run->lookahead_depth<run->read_count) aio_prefetch(run->fd, run->offsets[read+run->lookahead_depth], run->io_size);
+}
+
+#ifdef WITH_LUSTRE
+static void oracle_ladvise_pre_read(struct iohints_strategy_run *run){
+    for(uint64_t a = 0; a<run->lookahead_depth && a<run->read_count; a++) server_cache_prefetch(run->fd, run->offsets[a], run->io_size);
+}
+
+static void oracle_ladvise_read(struct iohints_strategy_run *run, uint64_t read, uint64_t offset, uint64_t length){
+    if(read+run->lookahead_depth<run->read_count) server_cache_prefetch(run->fd, run->offsets[read+run->lookahead_depth], run->io_size);
+}
+#endif
+
+// Strategies that allocated run->data in prepare free it once the configuration is over
+static void run_data_teardown(struct iohints_strategy_run *run){
+    free(run->data);
+}
+
+// Create an io_uring instance, register buffer_count aligned buffers of buffer_size bytes and the target file descriptor
+static inline void io_uring_engine_init(struct io_uring_engine *engine, int fd, unsigned buffer_count, uint64_t buffer_size, bool sqpoll){
+    memset(engine, 0, sizeof(struct io_uring_engine));
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(struct io_uring_params));
+    if(sqpoll){
+        params.flags |= IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = IO_URING_SQPOLL_IDLE_MS;
+    }
+    engine->ring_fd = syscall(__NR_io_uring_setup, buffer_count, &params);
+    if(engine->ring_fd<0){
+        printf("Could not create io_uring instance: %s\n", strerror(errno));
+        exit(0);
+    }
+    engine->sqpoll = sqpoll;
+    engine->entries = params.sq_entries;
+
+    // Mapping the submission and completion rings, which share a single mapping on recent kernels
+    engine->sq_ring_size = params.sq_off.array + params.sq_entries*sizeof(unsigned);
+    engine->cq_ring_size = params.cq_off.cqes + params.cq_entries*sizeof(struct io_uring_cqe);
+    if(params.features & IORING_FEAT_SINGLE_MMAP){
+        if(engine->cq_ring_size > engine->sq_ring_size) engine->sq_ring_size = engine->cq_ring_size;
+        engine->cq_ring_size = engine->sq_ring_size;
+    }
+    engine->sq_ring = mmap(0, engine->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, engine->ring_fd, IORING_OFF_SQ_RING);
+    if(engine->sq_ring == MAP_FAILED){
+        printf("Could not map io_uring submission ring: %s\n", strerror(errno));
+        exit(0);
+    }
+    if(params.features & IORING_FEAT_SINGLE_MMAP){
+        engine->cq_ring = engine->sq_ring;
+    }else{
+        engine->cq_ring = mmap(0, engine->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, engine->ring_fd, IORING_OFF_CQ_RING);
+        if(engine->cq_ring == MAP_FAILED){
+            printf("Could not map io_uring completion ring: %s\n", strerror(errno));
+            exit(0);
+        }
+    }
+    engine->sqes = mmap(0, params.sq_entries*sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, engine->ring_fd, IORING_OFF_SQES);
+    if(engine->sqes == MAP_FAILED){
+        printf("Could not map io_uring submission entries: %s\n", strerror(errno));
+        exit(0);
+    }
+    engine->sq_head = engine->sq_ring + params.sq_off.head;
+    engine->sq_tail = engine->sq_ring + params.sq_off.tail;
+    engine->sq_mask = engine->sq_ring + params.sq_off.ring_mask;
+    engine->sq_flags = engine->sq_ring + params.sq_off.flags;
+    engine->sq_array = engine->sq_ring + params.sq_off.array;
+    engine->cq_head = engine->cq_ring + params.cq_off.head;
+    engine->cq_tail = engine->cq_ring + params.cq_off.tail;
+    engine->cq_mask = engine->cq_ring + params.cq_off.ring_mask;
+    engine->cqes = engine->cq_ring + params.cq_off.cqes;
+
+    // Registering the buffers and the file, so that the kernel does not have to pin pages and take file references on every read.
+    // Buffers are page aligned, which also satisfies the logical block size alignment required by O_DIRECT
+    engine->buffer_count = buffer_count;
+    engine->buffer_size = buffer_size;
+    engine->buffers = malloc(sizeof(struct iovec)*buffer_count);
+    for(unsigned i = 0; i<buffer_count; i++){
+        if(posix_memalign(&engine->buffers[i].iov_base, sysconf(_SC_PAGESIZE), buffer_size)){
+            printf("Could not allocate io_uring buffer: %s\n", strerror(errno));
+            exit(0);
+        }
+        engine->buffers[i].iov_len = buffer_size;
+    }
+    if(syscall(__NR_io_uring_register, engine->ring_fd, IORING_REGISTER_BUFFERS, engine->buffers, buffer_count)<0){
+        printf("Could not register io_uring buffers: %s\n", strerror(errno));
+        exit(0);
+    }
+    if(syscall(__NR_io_uring_register, engine->ring_fd, IORING_REGISTER_FILES, &fd, 1)<0){
+        printf("Could not register file in io_uring: %s\n", strerror(errno));
+        exit(0);
+    }
+}
+
+// Unregister everything and tear down the io_uring instance
+static inline void io_uring_engine_destroy(struct io_uring_engine *engine){
+    io_uring_engine_drain(engine);
+    syscall(__NR_io_uring_register, engine->ring_fd, IORING_UNREGISTER_FILES, NULL, 0);
+    syscall(__NR_io_uring_register, engine->ring_fd, IORING_UNREGISTER_BUFFERS, NULL, 0);
+    munmap(engine->sqes, engine->entries*sizeof(struct io_uring_sqe));
+    if(engine->cq_ring != engine->sq_ring) munmap(engine->cq_ring, engine->cq_ring_size);
+    munmap(engine->sq_ring, engine->sq_ring_size);
+    close(engine->ring_fd);
+    for(unsigned i = 0; i<engine->buffer_count; i++) free(engine->buffers[i].iov_base);
+    free(engine->buffers);
+}
+
+// Block in io_uring_enter until at least min_complete completions are available
+static inline void io_uring_engine_enter_wait(struct io_uring_engine *engine, unsigned min_complete){
+    int ret = syscall(__NR_io_uring_enter, engine->ring_fd, 0, min_complete, IORING_ENTER_GETEVENTS, NULL, 0);
+    if(ret<0 && errno!=EINTR){
+        printf("Could not wait for io_uring completions: %s\n", strerror(errno));
+        exit(0);
+    }
+}
+
+// Consume the available completions without looking at them, blocking until at least min_complete of them were seen
+static inline void io_uring_engine_reap(struct io_uring_engine *engine, unsigned min_complete){
+    unsigned reaped = 0;
+    for(;;){
+        unsigned head = *engine->cq_head;
+        unsigned tail = __atomic_load_n(engine->cq_tail, __ATOMIC_ACQUIRE);
+        reaped += tail-head;
+        engine->inflight -= tail-head;
+        __atomic_store_n(engine->cq_head, tail, __ATOMIC_RELEASE);
+        if(reaped>=min_complete || engine->inflight==0) return;
+        io_uring_engine_enter_wait(engine, min_complete-reaped);
+    }
+}
+
+// Wait for a single completion and consume it
+static inline void io_uring_engine_wait(struct io_uring_engine *engine, struct io_uring_cqe *cqe){
+    for(;;){
+        unsigned head = *engine->cq_head;
+        if(head != __atomic_load_n(engine->cq_tail, __ATOMIC_ACQUIRE)){
+            *cqe = engine->cqes[head & *engine->cq_mask];
+            __atomic_store_n(engine->cq_head, head+1, __ATOMIC_RELEASE);
+            engine->inflight--;
+            return;
+        }
+        io_uring_engine_enter_wait(engine, 1);
+    }
+}
+
+// Hand the queued reads over to the kernel, either directly or by waking up the SQ polling thread
+static inline void io_uring_engine_submit(struct io_uring_engine *engine){
+    unsigned flags = 0;
+    if(engine->sqpoll){
+        if(!(__atomic_load_n(engine->sq_flags, __ATOMIC_ACQUIRE) & IORING_SQ_NEED_WAKEUP)){
+            engine->queued = 0;
+            return;
+        }
+        flags |= IORING_ENTER_SQ_WAKEUP;
+    }
+    int ret = syscall(__NR_io_uring_enter, engine->ring_fd, engine->sqpoll ? 0 : engine->queued, 0, flags, NULL, 0);
+    if(ret<0){
+        printf("Could not submit io_uring reads: %s\n", strerror(errno));
+        exit(0);
+    }
+    engine->queued = 0;
+}
+
+// Queue a read of the registered file into a registered buffer. The buffer index is given back as the completion user_data
+static inline void io_uring_engine_queue_read(struct io_uring_engine *engine, unsigned buffer_index, uint64_t offset, uint64_t length){
+
+    // The SQ ring is full: handing it over to the kernel before queuing more
+    unsigned tail = *engine->sq_tail;
+    if(tail-__atomic_load_n(engine->sq_head, __ATOMIC_ACQUIRE) >= engine->entries){
+        io_uring_engine_submit(engine);
+        while(tail-__atomic_load_n(engine->sq_head, __ATOMIC_ACQUIRE) >= engine->entries) io_uring_engine_reap(engine, 1);
+    }
+
+    unsigned index = tail & *engine->sq_mask;
+    struct io_uring_sqe *sqe = &engine->sqes[index];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    sqe->opcode = IORING_OP_READ_FIXED;
+    sqe->flags = IOSQE_FIXED_FILE;
+    sqe->fd = 0; // Index in the registered files table
+    sqe->off = offset;
+    sqe->buf_index = buffer_index;
+    sqe->addr = (uint64_t)engine->buffers[buffer_index].iov_base;
+    sqe->len = length;
+    sqe->user_data = buffer_index;
+    engine->sq_array[index] = index;
+    __atomic_store_n(engine->sq_tail, tail+1, __ATOMIC_RELEASE);
+    engine->queued++;
+    engine->inflight++;
+}
+
+// Wait for every in-flight read to complete
+static inline void io_uring_engine_drain(struct io_uring_engine *engine){
+    if(engine->queued>0) io_uring_engine_submit(engine);
+    while(engine->inflight>0) io_uring_engine_reap(engine, engine->inflight);
+}
+
+// Find the logical block size of the device backing a file, which O_DIRECT offsets, sizes and buffers must be aligned to
+static inline uint64_t get_logical_block_size(int fd){
+    struct stat st;
+    if(fstat(fd, &st)<0){
+        printf("Could not stat file \"%s\": %s\n", target_file_path, strerror(errno));
+        exit(0);
+    }
+
+    // The queue directory only exists for whole disks, so partitions have to look at their parent
+    const char *candidates[] = {"/sys/dev/block/%u:%u/queue/logical_block_size", "/sys/dev/block/%u:%u/../queue/logical_block_size"};
+    for(int i = 0; i<2; i++){
+        char path[128];
+        snprintf(path, sizeof(path), candidates[i], major(st.st_dev), minor(st.st_dev));
+        FILE *fp = fopen(path, "r");
+        if(fp == NULL) continue;
+        unsigned long long block_size = 0;
+        int ret = fscanf(fp, "%llu", &block_size);
+        fclose(fp);
+        if(ret == 1 && block_size > 0) return block_size;
+    }
+
+    // Network file systems (Lustre, GPFS...) have no backing block device, but accept page aligned direct I/Os
+    return sysconf(_SC_PAGESIZE);
+}
+
+// Fill thread_counts with 1, 2, 4... up to the number of online cores (included), and return how many counts were written
+static inline int get_reader_thread_counts(int *thread_counts){
+    int core_count = sysconf(_SC_NPROCESSORS_ONLN);
+    if(core_count<1) core_count = 1;
+    int count = 0;
+    for(int thread_count = 1; thread_count<core_count; thread_count*=2) thread_counts[count++] = thread_count;
+    thread_counts[count++] = core_count;
+    return count;
+}
+
+// Parse a size such as 4096, 64K, 16M or 1G
+static uint64_t parse_size(const char *value){
+    char *end;
+    uint64_t size = strtoull(value, &end, 10);
+    switch(*end){
+        case 'T': case 't': size <<= 10; // fallthrough
+        case 'G': case 'g': size <<= 10; // fallthrough
+        case 'M': case 'm': size <<= 10; // fallthrough
+        case 'K': case 'k': size <<= 10; end++; break;
+        default: break;
+    }
+    if(end==value || (*end!='\0' && strcmp(end, "B")!=0 && strcmp(end, "iB")!=0)){
+        printf("Invalid size \"%s\"\n", value);
+        exit(0);
+    }
+    return size;
+}
+
+// Parse a duration such as 15, 15s, 20m or 2h into microseconds. Plain numbers are seconds
+static uint64_t parse_duration_us(const char *value){
+    char *end;
+    double duration = strtod(value, &end);
+    if(end==value || duration<0){
+        printf("Invalid duration \"%s\"\n", value);
+        exit(0);
+    }
+    if(strcmp(end, "h")==0) duration *= 3600;
+    else if(strcmp(end, "m")==0 || strcmp(end, "min")==0) duration *= 60;
+    else if(strcmp(end, "ms")==0) duration *= 1e-3;
+    else if(strcmp(end, "us")==0) duration *= 1e-6;
+    else if(*end!='\0' && strcmp(end, "s")!=0){
+        printf("Invalid duration \"%s\"\n", value);
+        exit(0);
+    }
+    return duration*1e6;
+}
+
+// Parse a comma separated list of sizes (or plain integers) into values, and return how many were found
+static int parse_size_list(const char *name, const char *list, uint64_t *values){
+    char *copy = strdup(list), *saveptr = NULL;
+    int count = 0;
+    for(char *token = strtok_r(copy, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)){
+        if(count==MAX_SWEEP_VALUES){
+            printf("Too many values for --%s (at most %d)\n", name, MAX_SWEEP_VALUES);
+            exit(0);
+        }
+        values[count++] = parse_size(token);
+    }
+    free(copy);
+    if(count==0){
+        printf("Empty list for --%s\n", name);
+        exit(0);
+    }
+    return count;
+}
+
+// Memory the page cache can grow to: MemTotal, or the memory limit of our cgroup when it is lower
+static uint64_t get_page_cache_capacity(){
+    uint64_t capacity = 0, limit;
+    char line[256];
+    FILE *fp = fopen("/proc/meminfo", "r");
+    if(fp == NULL){
+        printf("Error opening file \"/proc/meminfo\": %s\n", strerror(errno));
+        exit(0);
+    }
+    while(fgets(line, sizeof(line), fp)) if(sscanf(line, "MemTotal: %llu kB", &capacity)==1) break;
+    fclose(fp);
+    capacity *= 1024;
+    fp = fopen("/sys/fs/cgroup/memory.max", "r");
+    if(fp){
+        if(fscanf(fp, "%llu", &limit)==1 && limit<capacity) capacity = limit; // "max" means no limit
+        fclose(fp);
+    }
+    if(capacity==0){
+        printf("Could not find out how much memory the page cache can use\n");
+        exit(0);
+    }
+    return capacity;
+}
+
+// Parse a list of multiples of the page cache capacity, e.g. 0.25,1,4, into file sizes rounded down to whole MBs
+static int parse_memory_ratio_list(const char *list, uint64_t *values){
+    uint64_t capacity = get_page_cache_capacity();
+    char *copy = strdup(list), *saveptr = NULL;
+    int count = 0;
+    for(char *token = strtok_r(copy, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)){
+        char *end;
+        double ratio = strtod(token, &end);
+        if(end==token || *end!='\0' || ratio<=0){
+            printf("Invalid memory ratio \"%s\"\n", token);
+            exit(0);
+        }
+        if(count==MAX_SWEEP_VALUES){
+            printf("Too many values for --memory-ratios (at most %d)\n", MAX_SWEEP_VALUES);
+            exit(0);
+        }
+        values[count] = (uint64_t)(ratio*capacity) & ~((1ul << 20)-1);
+        if(values[count]==0) values[count] = 1ul << 20;
+        count++;
+    }
+    free(copy);
+    if(count==0){
+        printf("Empty list for --memory-ratios\n");
+        exit(0);
+    }
+    printf("Sizing files after a page cache capacity of %.3f GB\n", capacity/(double)(1ul << 30));
+    page_cache_capacity = capacity;
+    return count;
+}
+
+// Tell whether a strategy is known. Strategies can be named individually ("online/aio") or by category ("online")
+static bool strategy_exists(const char *name){
+    size_t length = strlen(name);
+    for(int i = 0; strategy_names[i]; i++){
+        if(strcmp(strategy_names[i], name)==0) return true;
+        if(strncmp(strategy_names[i], name, length)==0 && strategy_names[i][length]=='/') return true;
+    }
+    const struct iohints_strategy *const *strategies = iohints_strategy_registry();
+    for(int i = 0; strategies[i]; i++){
+        if(strcmp(strategies[i]->name, name)==0) return true;
+        if(strncmp(strategies[i]->name, name, length)==0 && strategies[i]->name[length]=='/') return true;
+    }
+    return false;
+}
+
+// Add a strategy to the registry of libiohints, refusing the names of the strategies with a benchmark loop of their own
+static void strategy_register(const struct iohints_strategy *strategy){
+    for(int i = 0; strategy->name && strategy_names[i]; i++){
+        if(strcmp(strategy_names[i], strategy->name)==0){
+            printf("Strategy \"%s\" is registered twice\n", strategy->name);
+            exit(0);
+        }
+    }
+    if(iohints_strategy_register(strategy)==0) return;
+    if(errno==EINVAL) printf("Invalid strategy \"%s\": strategies need a \"category/strategy\" name, a category and a label\n", strategy->name ? strategy->name : "");
+    else if(errno==EEXIST) printf("Strategy \"%s\" is registered twice\n", strategy->name);
+    else printf("Too many registered strategies (at most %d)\n", IOHINTS_STRATEGY_MAX_REGISTERED);
+    exit(0);
+}
+
+// Load a strategy module, and register the strategies it returns
+static void strategy_module_load(const char *path){
+    const struct iohints_strategy *const *strategies = iohints_strategy_module_load(path);
+    if(strategies == NULL){
+        if(errno==ENOTSUP) printf("Error loading strategy module \"%s\": version %d of the strategy interface is not supported\n", path, IOHINTS_STRATEGY_API_VERSION);
+        else printf("Error loading strategy module \"%s\": %s\n", path, dlerror());
+        exit(0);
+    }
+    for(int i = 0; strategies[i]; i++) strategy_register(strategies[i]);
+}
+
+// Tell whether a strategy was selected on the command line
+static inline bool strategy_selected(const char *strategy){
+    if(selected_strategy_count==0) return true;
+    for(int i = 0; i<selected_strategy_count; i++){
+        size_t length = strlen(selected_strategies[i]);
+        if(strcmp(strategy, selected_strategies[i])==0) return true;
+        if(strncmp(strategy, selected_strategies[i], length)==0 && strategy[length]=='/') return true;
+    }
+    return false;
+}
+
+// Tell whether a configuration of the sweep should run, and count it towards the campaign estimate
+static inline bool configuration_selected(const char *strategy, uint64_t file_size){
+    if(!strategy_selected(strategy)) return false;
+    if(file_size>target_file_size) return false;
+    configuration_count++;
+    if(dry_run) return false;
+
+    // The budget is enforced as the campaign goes: each configuration gets its share of what is left of it, and none starts
+    // once it is spent, so that long experiments and cache resets are made up for by the configurations after them
+    if(campaign_budget_us!=0){
+        uint64_t elapsed_us = get_timestamp_us()-campaign_start_us;
+        uint64_t remaining_count = planned_configuration_count>=configuration_count ? planned_configuration_count-configuration_count+1 : 1;
+        uint64_t share_us = elapsed_us<campaign_budget_us ? (campaign_budget_us-elapsed_us)/remaining_count : 0;
+        if(elapsed_us<campaign_budget_us && share_us==0) share_us = 1;
+        duration_per_experiment_us = share_us<requested_duration_us ? share_us : requested_duration_us;
+        if(duration_per_experiment_us==0){
+            budget_skipped_count++;
+            return false;
+        }
+    }
+    return true;
+}
+
+static void print_usage(const char *program){
+    printf("Usage: %s [options]\n"
+        "  -t, --target=PATH               file to read (default: %s)\n"
+        "  -o, --output=PATH               output csv (default: %s)\n"
+        "  -s, --strategies=LIST           strategies or categories to run, e.g. baseline,online/aio (default: all)\n"
+        "  -l, --list                      list the available strategies\n"
+        "      --file-sizes=LIST           file sizes to test, e.g. 64M,1G,16G\n"
+        "      --memory-ratios[=LIST]      file sizes to test as multiples of the page cache capacity (default: %s)\n"
+        "      --io-sizes=LIST             I/O sizes to test, e.g. 4K,1M\n"
+        "      --interarrival-times=LIST   inter arrival times between I/Os, in ns\n"
+        "      --arrivals=SCHEDULE         constant or poisson arrivals of the paced I/Os (default: constant)\n"
+        "      --queue-depths=LIST         numbers of O_DIRECT reads in flight\n"
+        "      --lookahead-depths=LIST     numbers of upcoming accesses hinted ahead by the oracle strategies\n"
+        "  -d, --duration=TIME             time spent on each configuration, e.g. 15s (default: %llus)\n"
+        "  -b, --budget=TIME               time budget of the whole campaign, e.g. 20m. Shrinks --duration if needed\n"
+        "      --ci-width=FRACTION         stop repeating a configuration once its 95%% confidence interval is within FRACTION of the mean\n"
+        "                                  throughput, 0 always runs for --duration (default: %g)\n"
+        "      --min-repetitions=COUNT     experiments run before trusting the confidence interval (default: %d)\n"
+        "      --max-repetitions=COUNT     experiments after which a configuration stops anyway, 0 means no limit (default: %d)\n"
+        "  -c, --config=PATH               read options from a file, one \"option = value\" per line\n"
+        "      --distributions=LIST        distributions of the random offsets: uniform, zipf, hotspot or gaussian (default: uniform)\n"
+        "      --zipf-exponent=VALUE       skew of the zipf distribution (default: %.2f)\n"
+        "      --hotspot=ACCESSES/DATA     percentages of the accesses sent to the first part of the file by the hotspot distribution, and\n"
+        "                                  of the file in that part (default: %.0f/%.0f)\n"
+        "      --gaussian-stddev=FRACTION  distance between consecutive accesses of the gaussian distribution, as a fraction of the file\n"
+        "                                  size (default: %.2f)\n"
+        "      --offset-alignment=SIZE     random offsets are multiples of SIZE, 0 aligns them to the I/O size and 1 leaves them unaligned\n"
+        "                                  (default: %d)\n"
+        "      --event-trace=PATH          record every read and hint to a binary event trace, see event-trace-decoder\n"
+        "      --strategy-modules=LIST     shared objects to load strategies from, see iohints-strategy.h\n"
+        "  -n, --dry-run                   only print the campaign estimate\n"
+        "  -g, --generate                  create the target file, big enough for the largest file size, and exit\n"
+        "  -h, --help                      print this help\n",
+        program, TARGET_FILE, OUTPUT_FILE, MEMORY_RATIOS, DURATION_PER_EXPERIMENT_US/(uint64_t)1e6, REPETITION_CI_WIDTH, REPETITION_MIN_COUNT, REPETITION_MAX_COUNT,
+        ZIPF_EXPONENT, HOTSPOT_ACCESS_FRACTION*100, HOTSPOT_DATA_FRACTION*100, GAUSSIAN_LOCALITY_STDDEV, OFFSET_ALIGNMENT);
+}
+
+static const struct option long_options[] = {
+    {"target", required_argument, 0, 't'},
+    {"output", required_argument, 0, 'o'},
+    {"strategies", required_argument, 0, 's'},
+    {"list", no_argument, 0, 'l'},
+    {"file-sizes", required_argument, 0, 1},
+    {"memory-ratios", optional_argument, 0, 13},
+    {"io-sizes", required_argument, 0, 2},
+    {"interarrival-times", required_argument, 0, 4},
+    {"arrivals", required_argument, 0, 7},
+    {"queue-depths", required_argument, 0, 5},
+    {"lookahead-depths", required_argument, 0, 6},
+    {"duration", required_argument, 0, 'd'},
+    {"budget", required_argument, 0, 'b'},
+    {"ci-width", required_argument, 0, 8},
+    {"min-repetitions", required_argument, 0, 9},
+    {"max-repetitions", required_argument, 0, 10},
+    {"config", required_argument, 0, 'c'},
+    {"event-trace", required_argument, 0, 11},
+    {"offset-alignment", required_argument, 0, 12},
+    {"distributions", required_argument, 0, 14},
+    {"zipf-exponent", required_argument, 0, 15},
+    {"hotspot", required_argument, 0, 16},
+    {"gaussian-stddev", required_argument, 0, 17},
+    {"strategy-modules", required_argument, 0, 18},
+    {"dry-run", no_argument, 0, 'n'},
+    {"generate", no_argument, 0, 'g'},
+    {"help", no_argument, 0, 'h'},
+    {0, 0, 0, 0}
+};
+
+static void parse_config_file(const char *path);
+
+// Apply a single option, given either on the command line or in a config file
+static void apply_option(int option, const char *value){
+    uint64_t values[MAX_SWEEP_VALUES];
+    switch(option){
+        case 't':
+            target_file_path = strdup(value);
+            break;
+        case 'o':
+            output_file_path = strdup(value);
+            break;
+        case 's': {
+            char *copy = strdup(value), *saveptr = NULL;
+            selected_strategy_count = 0;
+            for(char *token = strtok_r(copy, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)){
+                if(selected_strategy_count==MAX_SWEEP_VALUES){
+                    printf("Too many values for --strategies (at most %d)\n", MAX_SWEEP_VALUES);
+                    exit(0);
+                }
+                selected_strategies[selected_strategy_count++] = token;
+            }
+            break;
+        }
+        case 'l':
+            list_strategies = true;
+            break;
+        case 1:
+            file_size_count = parse_size_list("file-sizes", value, file_sizes);
+            page_cache_capacity = 0;
+            break;
+        case 13:
+            file_size_count = parse_memory_ratio_list(value==NULL || *value=='\0' ? MEMORY_RATIOS : value, file_sizes);
+            break;
+        case 2:
+            io_size_count = parse_size_list("io-sizes", value, io_sizes);
+            break;
+        case 4:
+            io_interarrival_time_count = parse_size_list("interarrival-times", value, io_interarrival_times);
+            break;
+        case 5:
+            direct_io_queue_depth_count = parse_size_list("queue-depths", value, values);
+            for(int i = 0; i<direct_io_queue_depth_count; i++) direct_io_queue_depths[i] = values[i];
+            break;
+        case 6:
+            oracle_lookahead_depth_count = parse_size_list("lookahead-depths", value, values);
+            for(int i = 0; i<oracle_lookahead_depth_count; i++) oracle_lookahead_depths[i] = values[i];
+            break;
+        case 7:
+            if(strcmp(value, "constant")==0) arrival_schedule = ARRIVAL_CONSTANT;
+            else if(strcmp(value, "poisson")==0) arrival_schedule = ARRIVAL_POISSON;
+            else{
+                printf("Unknown arrival schedule \"%s\", expected constant or poisson\n", value);
+                exit(0);
+            }
+            break;
+        case 'd':
+            duration_per_experiment_us = parse_duration_us(value);
+            if(duration_per_experiment_us==0){
+                printf("The duration of each configuration must not be zero\n");
+                exit(0);
+            }
+            break;
+        case 'b':
+            campaign_budget_us = parse_duration_us(value);
+            break;
+        case 8: {
+            char *end;
+            repetition_ci_width = strtod(value, &end);
+            if(end==value || *end!='\0' || repetition_ci_width<0){
+                printf("Invalid confidence interval width \"%s\"\n", value);
+                exit(0);
+            }
+            break;
+        }
+        case 9:
+        case 10: {
+            char *end;
+            uint64_t count = strtoull(value, &end, 10);
+            if(end==value || *end!='\0'){
+                printf("Invalid number of repetitions \"%s\"\n", value);
+                exit(0);
+            }
+            if(option==9) repetition_min_count = count;
+            else repetition_max_count = count;
+            break;
+        }
+        case 11:
+            event_trace_path = strdup(value);
+            break;
+        case 12:
+            offset_alignment = parse_size(value);
+            break;
+        case 14: {
+            char *copy = strdup(value), *saveptr = NULL;
+            offset_distribution_count = 0;
+            for(char *token = strtok_r(copy, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)){
+                int d;
+                for(d = 0; d<OFFSET_DISTRIBUTION_COUNT && strcmp(offset_distribution_names[d], token)!=0; d++);
+                if(d==OFFSET_DISTRIBUTION_COUNT){
+                    printf("Unknown distribution \"%s\", expected uniform, zipf, hotspot or gaussian\n", token);
+                    exit(0);
+                }
+                if(offset_distribution_count==OFFSET_DISTRIBUTION_COUNT){
+                    printf("Too many values for --distributions (at most %d)\n", OFFSET_DISTRIBUTION_COUNT);
+                    exit(0);
+                }
+                offset_distributions[offset_distribution_count++] = d;
+            }
+            free(copy);
+            if(offset_distribution_count==0){
+                printf("Empty list for --distributions\n");
+                exit(0);
+            }
+            break;
+        }
+        case 15:
+        case 17: {
+            char *end;
+            double parameter = strtod(value, &end);
+            if(end==value || *end!='\0' || parameter<=0){
+                printf("Invalid value \"%s\" for --%s\n", value, option==15 ? "zipf-exponent" : "gaussian-stddev");
+                exit(0);
+            }
+            if(option==15) zipf_exponent = parameter;
+            else gaussian_locality_stddev = parameter;
+            break;
+        }
+        case 16: {
+            double accesses, data;
+            char end;
+            if(sscanf(value, "%lf/%lf%c", &accesses, &data, &end)!=2 || accesses<0 || accesses>100 || data<=0 || data>100){
+                printf("Invalid hotspot \"%s\", expected e.g. 90/10\n", value);
+                exit(0);
+            }
+            hotspot_access_fraction = accesses/100;
+            hotspot_data_fraction = data/100;
+            break;
+        }
+        case 18: {
+            char *copy = strdup(value), *saveptr = NULL;
+            for(char *token = strtok_r(copy, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)) strategy_module_load(token);
+            free(copy);
+            break;
+        }
+        case 'c':
+            parse_config_file(value);
+            break;
+        case 'n':
+            dry_run = true;
+            break;
+        case 'g':
+            generate_target = true;
+            break;
+        default:
+            exit(0);
+    }
+}
+
+// Remove leading and trailing white spaces
+static char *trim(char *text){
+    while(isspace((unsigned char)*text)) text++;
+    char *end = text+strlen(text);
+    while(end>text && isspace((unsigned char)end[-1])) *--end = '\0';
+    return text;
+}
+
+// Read options from a file, one "option = value" (or "option" for flags) per line. Lines starting with # are ignored
+static void parse_config_file(const char *path){
+    FILE *fp = fopen(path, "r");
+    if(fp == NULL){
+        printf("Error opening file \"%s\": %s\n", path, strerror(errno));
+        exit(0);
+    }
+    char line[4096];
+    int line_number = 0;
+    while(fgets(line, sizeof(line), fp)){
+        line_number++;
+
+        // Stripping comments, then splitting on '='
+        char *comment = strchr(line, '#');
+        if(comment) *comment = '\0';
+        char *separator = strchr(line, '=');
+        if(separator) *separator = '\0';
+        char *name = trim(line), *value = separator ? trim(separator+1) : NULL;
+        if(*name=='\0') continue;
+
+        const struct option *option = NULL;
+        for(int i = 0; long_options[i].name; i++) if(strcmp(long_options[i].name, name)==0) option = &long_options[i];
+        if(option==NULL || (option->has_arg==required_argument && (value==NULL || *value=='\0'))){
+            printf("%s:%d: invalid option \"%s\"\n", path, line_number, name);
+            exit(0);
+        }
+        apply_option(option->val, value);
+    }
+    fclose(fp);
+}
+
+// Parse the command line (and the config files it points to) into the sweep parameters
+static void parse_arguments(int argc, char **argv){
+
+    // The built-in strategies come first in the registry, before those of the strategy modules the options load
+    for(int i = 0; builtin_strategies[i]; i++) strategy_register(builtin_strategies[i]);
+    int option;
+    while((option = getopt_long(argc, argv, "t:o:s:ld:b:c:ngh", long_options, NULL)) != -1){
+        if(option=='h' || option=='?'){
+            print_usage(argv[0]);
+            exit(0);
+        }
+        apply_option(option, optarg);
+    }
+    if(optind<argc){
+        print_usage(argv[0]);
+        exit(0);
+    }
+
+    // Strategy modules may come after --strategies or --list, so strategies are only looked up once every option is known
+    for(int i = 0; i<selected_strategy_count; i++){
+        if(!strategy_exists(selected_strategies[i])){
+            printf("Unknown strategy \"%s\", use --list to see the available ones\n", selected_strategies[i]);
+            exit(0);
+        }
+    }
+    if(list_strategies){
+        for(int i = 0; strategy_names[i]; i++) printf("%s\n", strategy_names[i]);
+        const struct iohints_strategy *const *strategies = iohints_strategy_registry();
+        for(int i = 0; strategies[i]; i++) printf("%s\n", strategies[i]->name);
+        exit(0);
+    }
+}
+
+// Used for per-I/O latency instrumentation
+static inline uint64_t get_timestamp_ns(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return ts.tv_sec*(uint64_t)1e9+ts.tv_nsec;
+}
+
+// Wait until a timestamp given by get_timestamp_ns
+static inline void sleep_until_ns(uint64_t due_ns){
+    uint64_t now = get_timestamp_ns();
+    if(due_ns>now+PACER_SPIN_THRESHOLD_NS){
+        uint64_t delay = due_ns-now-PACER_SPIN_THRESHOLD_NS;
+        struct timespec ts = {delay/(uint64_t)1e9, delay%(uint64_t)1e9};
+        while(nanosleep(&ts, &ts)==-1 && errno==EINTR);
+    }
+    while(get_timestamp_ns()<due_ns);
+}
+
+// Start a new schedule of reads, one every interarrival_ns on average. Streams of the same schedule draw different gaps
+static inline void pacer_reset(struct pacer *pacer, uint64_t interarrival_ns, uint64_t stream){
+    pacer->interarrival_ns = interarrival_ns;
+    pacer->due_ns = 0;
+    pacer->rng_state = PACER_SEED^(stream*0xbf58476d1ce4e5b9ull);
+    if(pacer->rng_state==0) pacer->rng_state = PACER_SEED;
+}
+
+// When the next read should have started. Latencies measured from there include the time the read spent waiting for the previous ones
+static inline uint64_t pacer_intended_start(struct pacer *pacer){
+    uint64_t now = get_timestamp_ns();
+    if(pacer->interarrival_ns==0) return now;
+    if(pacer->due_ns==0) pacer->due_ns = now;
+    return pacer->due_ns<now ? pacer->due_ns : now;
+}
+
+// Wait for the next read to be due. Late reads are not waited for, and the schedule does not shift to make up for them
+static inline void pacer_wait(struct pacer *pacer){
+    uint64_t gap = pacer->interarrival_ns;
+    if(arrival_schedule==ARRIVAL_POISSON){
+        pacer->rng_state ^= pacer->rng_state >> 12;
+        pacer->rng_state ^= pacer->rng_state << 25;
+        pacer->rng_state ^= pacer->rng_state >> 27;
+        double uniform = 1.0-((pacer->rng_state*0x2545f4914f6cdd1dull) >> 11)*0x1.0p-53; // In (0, 1]
+        gap = -log(uniform)*pacer->interarrival_ns;
+    }
+    if(pacer->due_ns==0) pacer->due_ns = get_timestamp_ns();
+    pacer->due_ns += gap;
+    sleep_until_ns(pacer->due_ns);
+}
+
+// Print the arrival schedule column of paced configurations
+static inline void arrival_schedule_fprint(FILE *output_file, uint64_t interarrival_ns){
+    fprintf(output_file, ", arrival_schedule='%s'", interarrival_ns==0 ? "back_to_back" : arrival_schedule_names[arrival_schedule]);
+}
+
+// Start repeating a configuration
+static inline void repetition_reset(struct repetition *repetition){
+    memset(repetition, 0, sizeof(struct repetition));
+    repetition->start_us = get_timestamp_us();
+}
+
+// Record the experiment that just ended from the running totals of the loop, and tell whether another one is needed
+static inline bool repetition_continue(struct repetition *repetition, uint64_t volume, uint64_t read_duration){
+    if(read_duration>repetition->last_read_duration){
+        double throughput = (volume-repetition->last_volume)/((read_duration-repetition->last_read_duration)*1e-6)/(1ul << 30);
+        repetition->count++;
+        double delta = throughput-repetition->mean;
+        repetition->mean += delta/repetition->count;
+        repetition->m2 += delta*(throughput-repetition->mean);
+        repetition->last_volume = volume;
+        repetition->last_read_duration = read_duration;
+    }
+    if(get_timestamp_us()-repetition->start_us>=duration_per_experiment_us) return false;
+    if(campaign_budget_us!=0 && repetition->count>0 && get_timestamp_us()-campaign_start_us>=campaign_budget_us) return false;
+    if(repetition_max_count!=0 && repetition->count>=repetition_max_count) return false;
+    if(repetition_ci_width>0 && repetition->count>=repetition_min_count && repetition->count>=2 &&
+        repetition_ci(repetition)<=repetition_ci_width*repetition->mean) return false;
+    return true;
+}
+
+// Half width of the 95% confidence interval of the mean throughput
+static inline double repetition_ci(const struct repetition *repetition){
+    // Two-sided 95% quantiles of Student's t distribution, by degrees of freedom. The normal quantile is close enough past 30
+    static const double t_quantiles[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228, 2.201, 2.179, 2.160, 2.145, 2.131,
+        2.120, 2.110, 2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if(repetition->count<2) return 0;
+    uint64_t freedom = repetition->count-1;
+    double quantile = freedom<=30 ? t_quantiles[freedom-1] : 1.960;
+    return quantile*sqrt(repetition->m2/freedom/repetition->count);
+}
+
+// Print the repetition columns of a configuration
+static inline void repetition_fprint(FILE *output_file, const struct repetition *repetition){
+    fprintf(output_file, ", throughput_mean_gb_per_second=%.3f, throughput_stddev_gb_per_second=%.3f, throughput_ci95_gb_per_second=%.3f, experiment_count=%llu",
+        repetition->mean, repetition->count>1 ? sqrt(repetition->m2/(repetition->count-1)) : 0, repetition_ci(repetition), repetition->count);
+}
+
+// Event trace file shared by every thread, and events lost because a ring filled up between two flushes
+static FILE *event_trace_file = NULL;
+static pthread_mutex_t event_trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t event_trace_overwritten = 0;
+static __thread struct event_ring *event_ring = NULL;
+
+// Create the event trace file, and start recording the events of the main thread
+static void event_trace_open(const char *path){
+    event_trace_file = fopen(path, "wb");
+    if(event_trace_file==NULL){
+        printf("Error opening file \"%s\": %s\n", path, strerror(errno));
+        exit(0);
+    }
+    fwrite(EVENT_TRACE_MAGIC, sizeof(char), 8, event_trace_file);
+    event_trace_thread_start(0);
+}
+
+// Flush the events of the main thread and close the event trace file
+static void event_trace_close(){
+    event_trace_thread_stop();
+    fclose(event_trace_file);
+    event_trace_file = NULL;
+    if(event_trace_overwritten>0) printf("%llu events were overwritten before being written to the event trace\n", event_trace_overwritten);
+}
+
+// Start recording the events of the calling thread, if the event trace is enabled
+static void event_trace_thread_start(uint16_t thread){
+    if(event_trace_file==NULL) return;
+    event_ring = malloc(sizeof(struct event_ring));
+    event_ring->records = malloc(sizeof(struct event_record)*EVENT_TRACE_RING_CAPACITY);
+    memset(event_ring->records, 0, sizeof(struct event_record)*EVENT_TRACE_RING_CAPACITY); // Faulting the ring in now rather than while timing
+    event_ring->head = 0;
+    event_ring->thread = thread;
+}
+
+// Flush the events of the calling thread and stop recording them
+static void event_trace_thread_stop(){
+    if(event_ring==NULL) return;
+    event_trace_flush();
+    free(event_ring->records);
+    free(event_ring);
+    event_ring = NULL;
+}
+
+// Timestamp to start an event with, only taken when the calling thread records events
+static inline uint64_t event_trace_now(){
+    return event_ring==NULL ? 0 : get_timestamp_ns();
+}
+
+// Record an event that started at start_ns and ends now, if the calling thread records events
+static inline void event_trace_record(enum event_type type, uint64_t start_ns, uint64_t offset, uint64_t size, int64_t result){
+    if(__glibc_likely(event_ring==NULL)) return;
+    struct event_record *record = &event_ring->records[event_ring->head++%EVENT_TRACE_RING_CAPACITY];
+    record->start_ns = start_ns;
+    record->end_ns = get_timestamp_ns();
+    record->offset = offset;
+    record->size = size;
+    record->result = result;
+    record->configuration = configuration_count;
+    record->thread = event_ring->thread;
+    record->type = type;
+}
+
+// Write the events recorded by the calling thread to the event trace file. Only call it outside of timed regions
+static void event_trace_flush(){
+    if(event_ring==NULL || event_ring->head==0) return;
+    uint64_t count = event_ring->head<EVENT_TRACE_RING_CAPACITY ? event_ring->head : EVENT_TRACE_RING_CAPACITY;
+    uint64_t first = (event_ring->head-count)%EVENT_TRACE_RING_CAPACITY;
+    pthread_mutex_lock(&event_trace_mutex);
+    uint64_t tail = first+count<=EVENT_TRACE_RING_CAPACITY ? count : EVENT_TRACE_RING_CAPACITY-first; // Oldest events, up to the end of the ring
+    fwrite(&event_ring->records[first], sizeof(struct event_record), tail, event_trace_file);
+    fwrite(event_ring->records, sizeof(struct event_record), count-tail, event_trace_file);
+    event_trace_overwritten += event_ring->head-count;
+    pthread_mutex_unlock(&event_trace_mutex);
+    event_ring->head = 0;
+}
+
+// Seed a xoshiro256** generator, expanding the seed with splitmix64
+static inline void random_generator_seed(struct random_generator *generator, uint64_t seed){
+    for(int i = 0; i<4; i++){
+        seed += 0x9e3779b97f4a7c15ull;
+        uint64_t z = seed;
+        z = (z^(z >> 30))*0xbf58476d1ce4e5b9ull;
+        z = (z^(z >> 27))*0x94d049bb133111ebull;
+        generator->state[i] = z^(z >> 31);
+    }
+}
+
+// Next 64 random bits of a xoshiro256** generator
+static inline uint64_t random_generator_next(struct random_generator *generator){
+    uint64_t *state = generator->state;
+    uint64_t result = state[1]*5;
+    result = ((result << 7) | (result >> 57))*9;
+    uint64_t t = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = (state[3] << 45) | (state[3] >> 19);
+    return result;
+}
+
+// Number of random accesses of io_size bytes in a configuration: enough to read 10% of the file, or the size of the whole file when
+// --memory-ratios sized it, so that data gets accessed again and the sweep shows when the file stops fitting in the page cache
+static inline uint64_t random_access_count(uint64_t file_size, uint64_t io_size){
+    uint64_t volume = page_cache_capacity!=0 ? file_size : file_size/10;
+    return volume/io_size + (volume%io_size!=0);
+}
+
+// Alignment of the random offsets of accesses of io_size bytes
+static inline uint64_t random_offset_alignment(uint64_t io_size){
+    return offset_alignment==0 ? io_size : offset_alignment;
+}
+
+// Uniform random number in [0, 1)
+static inline double random_generator_uniform(struct random_generator *generator){
+    return (random_generator_next(generator) >> 11)*0x1.0p-53;
+}
+
+// Uniform random integer in [0, bound)
+static inline uint64_t random_generator_bounded(struct random_generator *generator, uint64_t bound){
+    // Multiplying rather than taking a modulo keeps the values uniform without a division (Lemire)
+    return ((unsigned __int128)random_generator_next(generator)*bound) >> 64;
+}
+
+// Helpers of the rejection-inversion sampler: log1p(x)/x and expm1(x)/x, which stay accurate around 0
+static inline double zipf_helper1(double x){
+    return fabs(x)>1e-8 ? log1p(x)/x : 1-x*(0.5-x*(1/3.0-0.25*x));
+}
+static inline double zipf_helper2(double x){
+    return fabs(x)>1e-8 ? expm1(x)/x : 1+x*0.5*(1+x/3.0*(1+0.25*x));
+}
+
+// Integral of the hat function x^-exponent of the rejection-inversion sampler, and its inverse
+static inline double zipf_h_integral(double x, double exponent){
+    double log_x = log(x);
+    return zipf_helper2((1-exponent)*log_x)*log_x;
+}
+static inline double zipf_h_integral_inverse(double x, double exponent){
+    double t = x*(1-exponent);
+    if(t<-1) t = -1;
+    return exp(zipf_helper1(t)*x);
+}
+
+// Zipfian random integer in [1, n], by rejection-inversion (Hörmann and Derflinger). Constant time whatever n, which can be
+// the number of 4 KB blocks of a huge file
+static inline uint64_t random_generator_zipf(struct random_generator *generator, uint64_t n, double exponent){
+    double h_integral_x1 = zipf_h_integral(1.5, exponent)-1, h_integral_n = zipf_h_integral(n+0.5, exponent);
+    double s = 2-zipf_h_integral_inverse(zipf_h_integral(2.5, exponent)-exp(-exponent*log(2)), exponent);
+    while(true){
+        double u = h_integral_n+random_generator_uniform(generator)*(h_integral_x1-h_integral_n);
+        double x = zipf_h_integral_inverse(u, exponent);
+        uint64_t k = x+0.5<1 ? 1 : x+0.5>n ? n : (uint64_t)(x+0.5);
+        if(k-x<=s || u>=zipf_h_integral(k+0.5, exponent)-exp(-exponent*log(k))) return k;
+    }
+}
+
+// Fill offsets with count random offsets of io_size accesses, following the current distribution and multiples of alignment. Accesses
+// never go past the end of the file, and the same stream always gives the same offsets
+static inline void random_offsets_generate(uint64_t *offsets, uint64_t count, uint64_t file_size, uint64_t io_size, uint64_t alignment, uint64_t stream){
+    struct random_generator generator;
+    random_generator_seed(&generator, RANDOM_SEED+stream);
+    uint64_t slot_count = io_size<file_size ? (file_size-io_size)/alignment+1 : 1;
+
+    // Zipfian ranks are scattered over the file by multiplying them with a number coprime with the slot count, which is a permutation
+    uint64_t scatter = (uint64_t)(slot_count*0.6180339887)|1;
+    while(true){
+        uint64_t a = scatter, b = slot_count;
+        while(b!=0){
+            uint64_t r = a%b;
+            a = b;
+            b = r;
+        }
+        if(a==1) break;
+        scatter += 2;
+    }
+    uint64_t hot_slot_count = slot_count*hotspot_data_fraction>=1 ? slot_count*hotspot_data_fraction : 1;
+    double stddev_slots = gaussian_locality_stddev*slot_count;
+    uint64_t slot = random_generator_bounded(&generator, slot_count);
+
+    for(uint64_t a = 0; a<count; a++){
+        switch(offset_distribution){
+            case OFFSET_DISTRIBUTION_ZIPF:
+                slot = (unsigned __int128)(random_generator_zipf(&generator, slot_count, zipf_exponent)-1)*scatter%slot_count;
+                break;
+            case OFFSET_DISTRIBUTION_HOTSPOT:
+                if(hot_slot_count==slot_count || random_generator_uniform(&generator)<hotspot_access_fraction) slot = random_generator_bounded(&generator, hot_slot_count);
+                else slot = hot_slot_count+random_generator_bounded(&generator, slot_count-hot_slot_count);
+                break;
+            case OFFSET_DISTRIBUTION_GAUSSIAN: {
+                // Box-Muller transform, wrapping around the ends of the file
+                double normal = sqrt(-2*log(1-random_generator_uniform(&generator)))*cos(2*M_PI*random_generator_uniform(&generator));
+                int64_t step = llround(normal*stddev_slots)%(int64_t)slot_count;
+                slot = (slot+slot_count+step)%slot_count;
+                break;
+            }
+            default:
+                slot = random_generator_bounded(&generator, slot_count);
+                break;
+        }
+        offsets[a] = slot*alignment;
+    }
+}
+
+// Print the distribution column of a configuration
+static inline void offset_distribution_fprint(FILE *output_file){
+    fprintf(output_file, ", distribution='%s'", offset_distribution_names[offset_distribution]);
+    switch(offset_distribution){
+        case OFFSET_DISTRIBUTION_ZIPF: fprintf(output_file, ", zipf_exponent=%.3f", zipf_exponent); break;
+        case OFFSET_DISTRIBUTION_HOTSPOT: fprintf(output_file, ", hotspot_access_fraction=%.3f, hotspot_data_fraction=%.3f", hotspot_access_fraction, hotspot_data_fraction); break;
+        case OFFSET_DISTRIBUTION_GAUSSIAN: fprintf(output_file, ", gaussian_locality_stddev=%.3f", gaussian_locality_stddev); break;
+        default: break;
+    }
+}
+
+// Print the size of the file relative to the page cache capacity as a column, when --memory-ratios sized the files
+static inline void memory_ratio_fprint(FILE *output_file, uint64_t file_size){
+    if(page_cache_capacity!=0) fprintf(output_file, ", memory_ratio=%.3f", (double)file_size/page_cache_capacity);
+}
+
+// Empty a latency histogram
+static inline void latency_histogram_reset(struct latency_histogram *histogram){
+    memset(histogram, 0, sizeof(struct latency_histogram));
+}
+
+// Record a single latency, in ns
+static inline void latency_histogram_record(struct latency_histogram *histogram, uint64_t latency_ns){
+    unsigned index = latency_ns;
+    if(latency_ns >= 1u << LATENCY_HISTOGRAM_SUB_BUCKET_BITS){
+
+        // Buckets are powers of two, and sub-buckets the bits right after the most significant one
+        unsigned magnitude = 63-__builtin_clzll(latency_ns)-LATENCY_HISTOGRAM_SUB_BUCKET_BITS;
+        unsigned sub_bucket = (latency_ns >> magnitude) & ((1u << LATENCY_HISTOGRAM_SUB_BUCKET_BITS)-1);
+        index = ((magnitude+1) << LATENCY_HISTOGRAM_SUB_BUCKET_BITS) | sub_bucket;
+    }
+    histogram->counts[index]++;
+    histogram->count++;
+    if(latency_ns>histogram->max) histogram->max = latency_ns;
+}
+
+// Add every value of source to destination
+static inline void latency_histogram_merge(struct latency_histogram *destination, const struct latency_histogram *source){
+    for(int i = 0; i<LATENCY_HISTOGRAM_BUCKET_COUNT; i++) destination->counts[i] += source->counts[i];
+    destination->count += source->count;
+    if(source->max>destination->max) destination->max = source->max;
+}
+
+// Highest latency (in ns) that falls in the same bucket as the given percentile
+static inline uint64_t latency_histogram_percentile(const struct latency_histogram *histogram, double percentile){
+    if(histogram->count==0) return 0;
+    uint64_t rank = ceil(percentile/100*histogram->count), seen = 0;
+    if(rank==0) rank = 1;
+    for(unsigned index = 0; index<LATENCY_HISTOGRAM_BUCKET_COUNT; index++){
+        seen += histogram->counts[index];
+        if(seen<rank) continue;
+        unsigned magnitude = index >> LATENCY_HISTOGRAM_SUB_BUCKET_BITS;
+        if(magnitude==0) return index;
+        uint64_t sub_bucket = (index & ((1u << LATENCY_HISTOGRAM_SUB_BUCKET_BITS)-1)) | (1u << LATENCY_HISTOGRAM_SUB_BUCKET_BITS);
+        uint64_t highest = ((sub_bucket+1) << (magnitude-1))-1;
+        return highest<histogram->max ? highest : histogram->max;
+    }
+    return histogram->max;
+}
+
+// Print the p50/p90/p99/p99.9/max latency columns (in us), and end the output line
+static inline void latency_histogram_fprint(FILE *output_file, const struct latency_histogram *histogram){
+    fprintf(output_file, ", latency_p50_us=%.3f, latency_p90_us=%.3f, latency_p99_us=%.3f, latency_p999_us=%.3f, latency_max_us=%.3f\n",
+        latency_histogram_percentile(histogram, 50)*1e-3, latency_histogram_percentile(histogram, 90)*1e-3,
+        latency_histogram_percentile(histogram, 99)*1e-3, latency_histogram_percentile(histogram, 99.9)*1e-3, histogram->max*1e-3);
+}
+
+// Give the madvise hint of an mmap strategy on a whole mapping. Returns false when the kernel does not support it
+static inline bool mmap_strategy_apply(enum mmap_strategy strategy, char *mapping, uint64_t length){
+    int advice;
+    switch(strategy){
+        case MMAP_STRATEGY_SEQUENTIAL: advice = MADV_SEQUENTIAL; break;
+        case MMAP_STRATEGY_RANDOM: advice = MADV_RANDOM; break;
+        case MMAP_STRATEGY_WILLNEED: advice = MADV_WILLNEED; break;
+        case MMAP_STRATEGY_POPULATE_READ: advice = MADV_POPULATE_READ; break;
+        case MMAP_STRATEGY_HUGEPAGE: advice = MADV_HUGEPAGE; break;
+        default: return true;
+    }
+    uint64_t start_ns = event_trace_now();
+    int ret = madvise(mapping, length, advice);
+    event_trace_record(EVENT_HINT_MADVISE, start_ns, 0, length, ret);
+    return ret==0;
+}
+
+// Fraction of the pages of a range that are resident in the client page cache, -1 when it could not be measured
+static inline double client_cache_resident_fraction(int fd, uint64_t offset, uint64_t length){
+    struct stat file_stat;
+    if(fstat(fd, &file_stat)<0) return -1;
+    if(offset>=(uint64_t)file_stat.st_size) return 0;
+    if(length==0 || offset+length>(uint64_t)file_stat.st_size) length = file_stat.st_size-offset;
+    uint64_t page_size = sysconf(_SC_PAGESIZE);
+    uint64_t page_count = (offset+length+page_size-1)/page_size - offset/page_size;
+    uint64_t resident_pages = client_cache_resident_pages(fd, offset, length);
+    return resident_pages==RESIDENT_PAGES_UNKNOWN ? -1 : (double)resident_pages/page_count;
+}
+
+// Start recording the residency of a new configuration, whose timed loops should start in the given state
+static inline void residency_record_reset(struct residency_record *record, enum residency_precondition precondition){
+    memset(record, 0, sizeof(struct residency_record));
+    record->precondition = precondition;
+}
+
+// Snapshot the residency of a range right before a timed loop, and check the precondition
+static inline void residency_record_before(struct residency_record *record, int fd, uint64_t offset, uint64_t length){
+    double fraction = client_cache_resident_fraction(fd, offset, length);
+
+    // A residency that could not be measured cannot be trusted to meet the precondition
+    if(fraction<0){
+        record->failure_count++;
+        return;
+    }
+    record->before_sum += fraction;
+    record->before_count++;
+    if((record->precondition==RESIDENCY_COLD && fraction>RESIDENCY_TOLERANCE) || (record->precondition==RESIDENCY_WARM && fraction<1-RESIDENCY_TOLERANCE)){
+        record->failure_count++;
+    }
+}
+
+// Snapshot the residency of a range right after a timed loop
+static inline void residency_record_after(struct residency_record *record, int fd, uint64_t offset, uint64_t length){
+    double fraction = client_cache_resident_fraction(fd, offset, length);
+    if(fraction<0) return;
+    record->after_sum += fraction;
+    record->after_count++;
+}
+
+// Print the mean resident fractions (-1 when none could be measured) and the precondition failures as columns
+static inline void residency_record_fprint(FILE *output_file, const struct residency_record *record){
+    fprintf(output_file, ", resident_before=%.3f, resident_after=%.3f, precondition='%s', precondition_failures=%d",
+        record->before_count ? record->before_sum/record->before_count : -1, record->after_count ? record->after_sum/record->after_count : -1,
+        residency_precondition_names[record->precondition], record->failure_count);
+}
+
+// Create the target file, and fill its first file_size bytes with the deterministic content of the libiohints generator
+static void generate_target_file(const char *path, uint64_t file_size){
+    uint64_t t1 = get_timestamp_us();
+    int thread_count = iohints_generate_file(path, file_size);
+    if(thread_count<0){
+        printf("Error generating file \"%s\": %s\n", path, strerror(errno));
+        exit(0);
+    }
+    uint64_t duration = get_timestamp_us()-t1;
+    printf("Generated \"%s\": %.3f GB in %.3f s (%.3f GB/s) with %d threads\n", path, file_size/(double)(1ul << 30), duration*1e-6,
+        file_size/(duration*1e-6)/(1ul << 30), thread_count);
 }
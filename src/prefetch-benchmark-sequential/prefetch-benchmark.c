@@ -13,17 +13,57 @@
 #include <sys/time.h>
 #include <aio.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <time.h>
+#include <pthread.h>
+#include <getopt.h>
+#include <ctype.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <linux/io_uring.h>
+#include <dlfcn.h>
+
+#ifdef WITH_MPI
+#include <mpi.h>
+#endif
 
-#ifdef WITH_LUSTRE
-#include "lustre/lustreapi.h"
+// The cachestat syscall (Linux 6.5) is not wrapped by the C library yet
+#ifndef __NR_cachestat
+#define __NR_cachestat 451
+#endif
+struct cachestat_range {
+    uint64_t off, len;
+};
+struct cachestat {
+    uint64_t nr_cache, nr_dirty, nr_writeback, nr_evicted, nr_recently_evicted;
+};
+
+// Older C libraries do not know about MADV_POPULATE_READ (Linux 5.14)
+#ifndef MADV_POPULATE_READ
+#define MADV_POPULATE_READ 22
 #endif
 
-#define nsleep(nanoseconds) nanosleep((const struct timespec[]){{0, nanoseconds}}, NULL);
+#include "iohints.h"
+#include "iohints-strategy.h"
+#include "iohints-event-trace.h"
+#include "iohints-generate.h"
 
 // How many time we do the same measure in a row to increase precision
 #define DURATION_PER_EXPERIMENT_US (15*(uint64_t)1e6)
 
+// Configurations stop repeating earlier once the 95% confidence interval of their per-experiment throughput is narrower than
+// this fraction of its mean, in both directions. 0 always runs them for DURATION_PER_EXPERIMENT_US
+#define REPETITION_CI_WIDTH 0.02
+
+// Bounds on the number of experiments of each configuration: the confidence interval is not trusted below the minimum, and
+// 0 leaves the maximum to the duration
+#define REPETITION_MIN_COUNT 5
+#define REPETITION_MAX_COUNT 0
+
 // Dropping the cache might be asynchronous (or not, we don't know). As such, we sleep for the duration below after a cache drop, just to be sure.
 #define CACHE_DROP_DELAY_SECONDS 0
 
@@ -39,31 +79,675 @@
 #define SECONDARY_IO_COUNT 1024 // For a total of 4 GB, which is the size of GPFS page cache
 #endif
 
+// Default output csv
+#ifdef WITH_LUSTRE
+#define OUTPUT_FILE "output-lustre.csv"
+#else
+#define OUTPUT_FILE "output.csv"
+#endif
+
+// How many times the file is evicted with fadvise before falling back to dropping the whole page cache
+#define CACHE_EVICT_ATTEMPTS 3
+
+// Resident page count returned when it could not be measured (neither cachestat nor mincore worked)
+#define RESIDENT_PAGES_UNKNOWN UINT64_MAX
+
+// A timed loop counts as starting cold below this resident fraction of its range, and warm above one minus it
+#define RESIDENCY_TOLERANCE 0.01
+
+// Period between two samples of the side thread following JIT prefetches (in us)
+#define RESIDENCY_SAMPLER_PERIOD_US 500
+
+// Maximal number of values of each swept parameter
+#define MAX_SWEEP_VALUES 64
+
+// Multiples of the page cache capacity --memory-ratios sweeps when given no list: from a working set fitting comfortably in memory to 4 times bigger
+#define MEMORY_RATIOS "0.25,0.5,1,2,4"
+
 // Whether or not a "desc" field should be included in the output csv
 #define OUTPUT_EXPERIMENT_DESCRIPTION false
 
 // Individual file sizes to be tested
-static const uint64_t file_sizes[] = {64*1024*1024, 1024*1024*1024, 16ul*1024*1024*1024};
-static const int file_size_count = 3;
+static uint64_t file_sizes[MAX_SWEEP_VALUES] = {64*1024*1024, 1024*1024*1024, 16ul*1024*1024*1024};
+static int file_size_count = 3;
 
 // Individual I/O sizes to be tested
-static const uint64_t io_sizes[] = {4*1024, 16*1024, 64*1024, 1024*1024, 16*1024*1024, 256*1024*1024};
-static const int io_size_count = 6;
+static uint64_t io_sizes[MAX_SWEEP_VALUES] = {4*1024, 16*1024, 64*1024, 1024*1024, 16*1024*1024, 256*1024*1024};
+static int io_size_count = 6;
 
 // Individual delays for just in time prefetch (in us)
-static const uint64_t jit_prefetch_delays[] = {0, 1000, 10000, 100000, 1000000};
-static const int jit_prefetch_delay_count = 5;
+static uint64_t jit_prefetch_delays[MAX_SWEEP_VALUES] = {0, 1000, 10000, 100000, 1000000};
+static int jit_prefetch_delay_count = 5;
 
 // Individual inter arrival times between I/Os (in ns)
-static const uint64_t io_interarrival_times[] = {0, 100, 10000, 1000000};
-static const int io_interarrival_time_count = 4;
+static uint64_t io_interarrival_times[MAX_SWEEP_VALUES] = {0, 100, 10000, 1000000};
+static int io_interarrival_time_count = 4;
+
+// Arrival schedules of the paced reads. Both are open loop: when a read is due does not depend on when the previous one completed
+enum arrival_schedule {
+    ARRIVAL_CONSTANT, // One read every inter arrival time
+    ARRIVAL_POISSON,  // Exponentially distributed gaps, averaging the inter arrival time
+};
+static const char *arrival_schedule_names[] = {"constant", "poisson"};
+static enum arrival_schedule arrival_schedule = ARRIVAL_CONSTANT;
+
+// Waits longer than this are slept through up to this much, and the rest is spun on the clock (in ns)
+#define PACER_SPIN_THRESHOLD_NS 50000
+
+// Seed of the Poisson arrival schedules, so that campaigns are reproducible
+#define PACER_SEED 0x9e3779b97f4a7c15ull
+
+// Whether the io_uring prefetcher should rely on a kernel SQ polling thread instead of io_uring_enter for submission
+static const bool io_uring_sqpoll_modes[] = {false, true};
+static const int io_uring_sqpoll_mode_count = 2;
+
+// Size of the io_uring submission queue of the prefetcher, which is also its number of registered buffers
+#define IO_URING_QUEUE_DEPTH 64
+
+// Size of each registered buffer. Prefetches are split into reads of at most this size
+#define IO_URING_BUFFER_SIZE (1024*1024) // 1 MB
+
+// How long the SQ polling thread may stay idle before going to sleep (in ms)
+#define IO_URING_SQPOLL_IDLE_MS 1000
+
+// Individual numbers of O_DIRECT reads kept in flight
+static unsigned direct_io_queue_depths[MAX_SWEEP_VALUES] = {1, 4, 16, 64};
+static int direct_io_queue_depth_count = 4;
+
+// Upper bound on the memory used by the O_DIRECT buffer pool. Bigger io_size x queue depth combinations are skipped
+#define DIRECT_IO_MAX_POOL_SIZE (1024ul*1024*1024) // 1 GB
+
+// Orders in which the file is read, each covering it entirely. Backward reads it from the end, strided reads one I/O out of every
+// ACCESS_PATTERN_STRIDE in as many passes, and interleaved splits it in contiguous streams read in turn, one I/O at a time, as
+// column-oriented readers do. The whole campaign is run once per selected pattern, and interleaved once per stream count
+enum access_pattern {
+    ACCESS_PATTERN_FORWARD,
+    ACCESS_PATTERN_BACKWARD,
+    ACCESS_PATTERN_STRIDED,
+    ACCESS_PATTERN_INTERLEAVED,
+    ACCESS_PATTERN_COUNT
+};
+static const char *access_pattern_names[] = {"forward", "backward", "strided", "interleaved"};
+static enum access_pattern access_patterns[ACCESS_PATTERN_COUNT] = {ACCESS_PATTERN_FORWARD};
+static int access_pattern_count = 1;
+static enum access_pattern access_pattern = ACCESS_PATTERN_FORWARD; // The one being run
+#define ACCESS_PATTERN_STRIDE 8
+static uint64_t access_pattern_stride = ACCESS_PATTERN_STRIDE;
+
+// Individual numbers of streams of the interleaved pattern
+static uint64_t interleaved_stream_counts[MAX_SWEEP_VALUES] = {2, 4, 8, 16};
+static int interleaved_stream_count_count = 4;
+static uint64_t interleaved_stream_count = 1; // The one being run
+
+// A contiguous range of the file, hinted at once by the online strategies
+struct access_range {
+    uint64_t offset, length;
+};
+
+// Number of events each thread keeps between two flushes of the event trace. Past that, the oldest ones are overwritten
+#define EVENT_TRACE_RING_CAPACITY (1u << 20)
+
+// Latency histograms have 2^LATENCY_HISTOGRAM_SUB_BUCKET_BITS linear sub-buckets per power of two, i.e. a relative precision of 1/32
+#define LATENCY_HISTOGRAM_SUB_BUCKET_BITS 5
+#define LATENCY_HISTOGRAM_BUCKET_COUNT ((65-LATENCY_HISTOGRAM_SUB_BUCKET_BITS) << LATENCY_HISTOGRAM_SUB_BUCKET_BITS)
+
+// Log-bucketed (HDR-style) histogram of per-I/O latencies, in ns. Recording a value is a couple of shifts and an increment
+struct latency_histogram {
+    uint64_t counts[LATENCY_HISTOGRAM_BUCKET_COUNT];
+    uint64_t count, max;
+};
+
+// State the client page cache is expected to be in when a timed loop starts
+enum residency_precondition {
+    RESIDENCY_ANY,
+    RESIDENCY_COLD,
+    RESIDENCY_WARM
+};
+static const char *residency_precondition_names[] = {"any", "cold", "warm"};
+
+// Resident fractions of the target range before and after the timed loops of a configuration, and how many experiments did not start as expected
+struct residency_record {
+    enum residency_precondition precondition;
+    double before_sum, after_sum;
+    int before_count, after_count, failure_count;
+};
+
+// Page cache the write experiments of a configuration leave behind, as fractions of the written range, and the time spent flushing it
+struct write_cache_record {
+    double dirty_sum, writeback_sum, resident_sum, resident_after_sync_sum;
+    int count;
+    bool dirty_known; // Only cachestat tells dirty pages apart
+    bool resident_known; // False once a resident fraction could not be measured
+    uint64_t sync_duration; // fdatasync and drop-behind at the end of the experiments, in us
+};
+
+// Side thread following how fast a prefetched range becomes resident, and whether the reader catches up with the prefetch. Times are since the hint, 0 until reached
+struct residency_sampler {
+    pthread_t thread;
+    int fd;
+    uint64_t length, io_size;
+    uint64_t hint_ns, reader_start_ns, reader_position; // Written by the reader
+    bool stop;
+    uint64_t time_to_50_ns, time_to_90_ns, time_to_100_ns, catch_up_ns; // Written by the sampler
+
+    // Sums over the experiments of a configuration
+    double time_to_50_sum, time_to_90_sum, time_to_100_sum, reader_start_sum, catch_up_sum;
+    int experiment_count, time_to_50_count, time_to_90_count, time_to_100_count, catch_up_count;
+};
+
+// Per-experiment throughputs of a configuration, used to decide when to stop repeating it
+struct repetition {
+    uint64_t start_us;
+    uint64_t last_volume, last_read_duration; // Totals of the loop at the end of the previous experiment
+    uint64_t count;
+    double mean, m2; // Running moments of the throughputs (Welford), in GB/s
+};
+
+// Events of a thread since the last flush. Recording an event is a store in this ring, the trace file is only written by flushes
+struct event_ring {
+    struct event_record *records;
+    uint64_t head; // Events recorded since the last flush, including overwritten ones
+    uint16_t thread;
+};
+
+// Schedule of the reads of a paced loop
+struct pacer {
+    uint64_t interarrival_ns;
+    uint64_t due_ns; // When the next read is due, 0 before the first one
+    uint64_t rng_state; // Gaps of the Poisson schedule
+};
+
+// A minimal io_uring instance with registered buffers and a single registered file, driven through raw syscalls
+struct io_uring_engine {
+    int ring_fd;
+    bool sqpoll;
+    unsigned entries, inflight, queued, next_buffer;
+    unsigned *sq_head, *sq_tail, *sq_mask, *sq_flags, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sq_ring, *cq_ring;
+    size_t sq_ring_size, cq_ring_size;
+    struct iovec *buffers;
+    unsigned buffer_count;
+    uint64_t buffer_size;
+};
+
+// Bounds of the window (size of each prefetch) and distance (how far ahead prefetches go) of the adaptive online prefetcher
+#define ADAPTIVE_PREFETCH_MIN_SIZE (128*1024) // 128 KB
+#define ADAPTIVE_PREFETCH_MAX_SIZE (256*1024*1024) // 256 MB
+
+// Number of accesses with the same stride in a row before the adaptive prefetcher starts prefetching
+#define ADAPTIVE_PREFETCH_STRIDE_CONFIRMATIONS 2
+
+// Number of resident accesses in a row after which the adaptive prefetcher shrinks its window and distance
+#define ADAPTIVE_PREFETCH_SHRINK_PERIOD 64
+
+// State of the adaptive online prefetcher: the stride it detected, its current window and distance, and what it observed
+struct adaptive_prefetcher {
+    uint64_t last_offset, last_access_ns;
+    int64_t stride;
+    unsigned stride_confirmations, consecutive_hits;
+    uint64_t window, distance; // In bytes
+    uint64_t covered_accesses; // Upcoming accesses already covered by issued prefetches
+    bool predicted; // Whether the current access was covered by a prefetch
+    double miss_latency_ns, interarrival_ns; // Moving averages
+    uint64_t hits, misses, prefetch_count, window_sum;
+};
+
+// Prefetch size used by the online prefetching strategies of the multi-threaded benchmark
+#define MULTITHREAD_PREFETCH_SIZE (16*1024*1024) // 16 MB
+
+// Strategies available to each reader thread of the multi-threaded benchmark. Hints only ever target the region of the thread
+enum reader_strategy {
+    READER_STRATEGY_NOT_CACHED,
+    READER_STRATEGY_SEQUENTIAL,
+    READER_STRATEGY_RANDOM,
+    READER_STRATEGY_OFFLINE_PREFETCH,
+    READER_STRATEGY_JIT_FADVISE,
+    #ifdef WITH_LUSTRE
+    READER_STRATEGY_JIT_LADVISE,
+    READER_STRATEGY_ONLINE_LADVISE,
+    #endif
+    READER_STRATEGY_ONLINE_FADVISE,
+    READER_STRATEGY_ONLINE_AIO,
+    READER_STRATEGY_ONLINE_IO_URING,
+    READER_STRATEGY_COUNT
+};
+static const char *reader_strategy_labels[] = {
+    "Not cached",
+    "Not cached but marked as sequential",
+    "Not cached but marked as random",
+    "Offline prefetch\\n(sync read)",
+    "JIT fadvise prefetch of the whole file",
+    #ifdef WITH_LUSTRE
+    "JIT ladvise prefetch of the whole file",
+    "ladvise online prefetching",
+    #endif
+    "fadvise online prefetching",
+    "async-io online prefetching",
+    "io_uring online prefetching",
+};
+static const char *reader_strategy_names[] = {
+    "not_cached",
+    "sequential",
+    "random",
+    "offline_prefetch",
+    "jit_fadvise",
+    #ifdef WITH_LUSTRE
+    "jit_ladvise",
+    "online_ladvise",
+    #endif
+    "online_fadvise",
+    "online_aio",
+    "online_io_uring",
+};
+
+#ifdef WITH_MPI
+// How the ranks of the MPI benchmark share the file, made of file_size/io_size I/Os: each rank reads a contiguous block of them,
+// ranks take turns reading one I/O each (rank r reads the I/Os r, r+N, r+2N...), or each rank reads as many random I/Os
+enum mpi_layout {
+    MPI_LAYOUT_CONTIGUOUS,
+    MPI_LAYOUT_STRIDED,
+    MPI_LAYOUT_RANDOM,
+    MPI_LAYOUT_COUNT
+};
+static const char *mpi_layout_names[] = {"contiguous", "strided", "random"};
+static enum mpi_layout mpi_layouts[MPI_LAYOUT_COUNT] = {MPI_LAYOUT_CONTIGUOUS, MPI_LAYOUT_STRIDED, MPI_LAYOUT_RANDOM};
+static int mpi_layout_count = MPI_LAYOUT_COUNT;
+
+// Prefetch size used by the online prefetching strategies of the MPI benchmark: each rank hints the I/Os it reads next
+#define MPI_PREFETCH_SIZE (16*1024*1024) // 16 MB
+
+// Seed of the offsets of the random MPI layout, mixed with the rank so that each rank draws its own
+#define MPI_LAYOUT_SEED 0x6a09e667f3bcc909ull
+
+// How the ranks of the MPI-IO benchmark read the file: MPI_File_read_at at the offsets of their layout, MPI_File_read_shared from
+// the shared file pointer (which decides the offsets, so only the contiguous layout is run), or MPI_File_read_at_all. Each of them
+// without hints, then with the MPIIO_HINT_... ones
+enum mpiio_strategy {
+    MPIIO_STRATEGY_INDEPENDENT,
+    MPIIO_STRATEGY_INDEPENDENT_HINTS,
+    MPIIO_STRATEGY_SHARED,
+    MPIIO_STRATEGY_SHARED_HINTS,
+    MPIIO_STRATEGY_COLLECTIVE,
+    MPIIO_STRATEGY_COLLECTIVE_HINTS,
+    MPIIO_STRATEGY_COUNT
+};
+static const char *mpiio_strategy_labels[] = {
+    "MPI-IO independent reads",
+    "MPI-IO independent reads\\nwith hints",
+    "MPI-IO shared pointer reads",
+    "MPI-IO shared pointer reads\\nwith hints",
+    "MPI-IO collective reads",
+    "MPI-IO collective reads\\nwith hints",
+};
+static const char *mpiio_strategy_names[] = {
+    "independent",
+    "independent_hints",
+    "shared",
+    "shared_hints",
+    "collective",
+    "collective_hints",
+};
+
+// MPI_Info hints given by the ..._hints strategies when opening the file. access_style also tells the layout (sequential or random),
+// and cb_nodes is the number of nodes of the job, so that every node aggregates collective reads
+#define MPIIO_HINT_ROMIO_CB_READ "enable" // Collective buffering of collective reads
+#define MPIIO_HINT_CB_BUFFER_SIZE "16777216" // 16 MB read by each aggregator at a time
+#define MPIIO_HINT_ROMIO_DS_READ "enable" // Data sieving of independent reads
+
+// Hints reported in the output rows, as the MPI-IO implementation applied them
+static const char *mpiio_hint_keys[] = {"access_style", "romio_cb_read", "cb_buffer_size", "cb_nodes", "romio_ds_read"};
+#endif
+
+// Size of the prefetches issued by online strategies during trace replay
+#define TRACE_PREFETCH_SIZE (16*1024*1024) // 16 MB
+
+// Magic number starting binary traces, which are followed by trace_record structures in native byte order
+#define TRACE_BINARY_MAGIC "IOHTRACE"
+
+// A single access of a replayed trace
+struct trace_record {
+    uint64_t timestamp_ns; // Relative to the first record once loaded
+    uint64_t offset, size;
+};
+
+// A replayed trace, with the range of the file it touches
+struct trace {
+    struct trace_record *records;
+    uint64_t record_count, start, end, largest_size;
+};
+
+// Hints given by the mmap reader on its mapping, which is then read through page faults instead of read()
+enum mmap_strategy {
+    MMAP_STRATEGY_NO_HINT,
+    MMAP_STRATEGY_SEQUENTIAL,
+    MMAP_STRATEGY_RANDOM,
+    MMAP_STRATEGY_WILLNEED,
+    MMAP_STRATEGY_POPULATE_READ,
+    MMAP_STRATEGY_HUGEPAGE,
+    MMAP_STRATEGY_COUNT
+};
+static const char *mmap_strategy_labels[] = {
+    "mmap without hint",
+    "mmap marked as sequential",
+    "mmap marked as random",
+    "mmap WILLNEED prefetch of the whole mapping",
+    "mmap POPULATE_READ prefault of the whole mapping",
+    "mmap marked as HUGEPAGE",
+};
+static const char *mmap_strategy_names[] = {
+    "mmap/no_hint",
+    "mmap/sequential",
+    "mmap/random",
+    "mmap/willneed",
+    "mmap/populate_read",
+    "mmap/hugepage",
+};
+
+// Hints given while writing the scratch file of the write benchmark, which is flushed with fdatasync at the end of every experiment
+enum write_strategy {
+    WRITE_STRATEGY_BUFFERED,
+    WRITE_STRATEGY_WRITE_BEHIND,
+    WRITE_STRATEGY_DROP_BEHIND,
+    WRITE_STRATEGY_O_DIRECT,
+    WRITE_STRATEGY_COUNT
+};
+static const char *write_strategy_labels[] = {
+    "Buffered writes",
+    "sync_file_range write-behind",
+    "sync_file_range write-behind and DONTNEED drop-behind",
+    "O_DIRECT writes",
+};
+static const char *write_strategy_names[] = {
+    "write/buffered",
+    "write/sync_file_range",
+    "write/dontneed",
+    "write/o_direct",
+};
+
+// Size of the windows the write-behind strategies start writing back at once. At most two windows are dirty at any time
+#define WRITE_BEHIND_WINDOW_SIZE (8*1024*1024) // 8 MB
+
+// The write benchmark writes to the target file path followed by this suffix, unless told otherwise. The target file is never written
+#define WRITE_TARGET_SUFFIX ".write"
+
+// Hints the LD_PRELOAD interposer gives to a plain reader run in its own process, which knows nothing of them. The plain
+// strategy runs the reader without the interposer, and none with the interposer following the streams without hinting them,
+// which measures its overhead
+enum interposer_strategy {
+    INTERPOSER_STRATEGY_PLAIN,
+    INTERPOSER_STRATEGY_NONE,
+    INTERPOSER_STRATEGY_FADVISE,
+    INTERPOSER_STRATEGY_AIO,
+    INTERPOSER_STRATEGY_READAHEAD,
+    INTERPOSER_STRATEGY_COUNT
+};
+static const char *interposer_strategy_labels[] = {
+    "Plain reads",
+    "Plain reads through the interposer, no hint",
+    "Plain reads with fadvise hints from the interposer",
+    "Plain reads with aio hints from the interposer",
+    "Plain reads with readahead hints from the interposer",
+};
+static const char *interposer_strategy_names[] = {
+    "interposer/plain",
+    "interposer/none",
+    "interposer/fadvise",
+    "interposer/aio",
+    "interposer/readahead",
+};
+static const char *interposer_strategy_hints[] = {NULL, "none", "fadvise", "aio", "readahead"}; // IOHINTS_PRELOAD_HINT
+
+// Interposer preloaded by the interposer strategies, unless told otherwise. CMake points it to the iohints-preload library it builds
+#ifndef IOHINTS_PRELOAD_PATH
+#define IOHINTS_PRELOAD_PATH "libiohints-preload.so"
+#endif
+
+// Every strategy of this benchmark with a benchmark loop of its own, as named on the command line. The others are registered,
+// see builtin_strategies
+static const char *strategy_names[] = {
+    "online/io_uring",
+    "online/adaptive",
+    "mmap/no_hint",
+    "mmap/sequential",
+    "mmap/random",
+    "mmap/willneed",
+    "mmap/populate_read",
+    "mmap/hugepage",
+    "multithreaded/not_cached",
+    "multithreaded/sequential",
+    "multithreaded/random",
+    "multithreaded/offline_prefetch",
+    "multithreaded/jit_fadvise",
+    #ifdef WITH_LUSTRE
+    "multithreaded/jit_ladvise",
+    "multithreaded/online_ladvise",
+    #endif
+    "multithreaded/online_fadvise",
+    "multithreaded/online_aio",
+    "multithreaded/online_io_uring",
+    "replay/not_cached",
+    "replay/sequential",
+    "replay/random",
+    "replay/offline_prefetch",
+    "replay/jit_fadvise",
+    #ifdef WITH_LUSTRE
+    "replay/jit_ladvise",
+    "replay/online_ladvise",
+    #endif
+    "replay/online_fadvise",
+    "replay/online_aio",
+    "replay/online_io_uring",
+    "write/buffered",
+    "write/sync_file_range",
+    "write/dontneed",
+    "write/o_direct",
+    "interposer/plain",
+    "interposer/none",
+    "interposer/fadvise",
+    "interposer/aio",
+    "interposer/readahead",
+    #ifdef WITH_MPI
+    "mpi/not_cached",
+    "mpi/sequential",
+    "mpi/random",
+    "mpi/offline_prefetch",
+    "mpi/jit_fadvise",
+    #ifdef WITH_LUSTRE
+    "mpi/jit_ladvise",
+    "mpi/online_ladvise",
+    #endif
+    "mpi/online_fadvise",
+    "mpi/online_aio",
+    "mpi/online_io_uring",
+    "mpiio/independent",
+    "mpiio/independent_hints",
+    "mpiio/shared",
+    "mpiio/shared_hints",
+    "mpiio/collective",
+    "mpiio/collective_hints",
+    #endif
+    NULL
+};
+
+// Campaign state: which strategies were selected, whether we only count configurations, and how many were counted
+static char *target_file_path = TARGET_FILE;
+static uint64_t target_file_size = 0;
+static char *output_file_path = OUTPUT_FILE;
+static uint64_t duration_per_experiment_us = DURATION_PER_EXPERIMENT_US;
+static uint64_t campaign_budget_us = 0; // 0 means unbounded
+static uint64_t campaign_start_us = 0; // When the campaign started running, which the budget counts from
+static uint64_t planned_configuration_count = 0; // Configurations counted by the estimate, which share the budget
+static uint64_t requested_duration_us = DURATION_PER_EXPERIMENT_US; // --duration, before configurations are shrunk to fit in the budget
+static uint64_t budget_skipped_count = 0; // Configurations that did not run, the budget being spent
+static double repetition_ci_width = REPETITION_CI_WIDTH;
+static uint64_t repetition_min_count = REPETITION_MIN_COUNT, repetition_max_count = REPETITION_MAX_COUNT;
+static char *event_trace_path = NULL; // NULL disables the event trace
+static char *write_target_file_path = NULL; // NULL means the target file path followed by WRITE_TARGET_SUFFIX
+static char *selected_strategies[MAX_SWEEP_VALUES];
+static int selected_strategy_count = 0; // 0 means every strategy
+static bool dry_run = false;
+static bool list_strategies = false;
+static bool generate_target = false;
+static bool plain_reader = false; // Only read the target with plain reads, for the interposer strategies
+static bool residency_sampling = false; // Follow JIT prefetches with a side thread. It competes with the timed reads, so it is off by default
+static char *interposer_path = IOHINTS_PRELOAD_PATH;
+static char *trace_file_path = NULL; // No trace replay by default
+static double trace_speed = 1; // 0 means ignoring the trace timestamps
+static uint64_t configuration_count = 0;
+static uint64_t cache_drop_count = 0, cache_drop_fallback_count = 0;
+
+// Asynchronous prefetches the benchmark holds the handles of. They are cancelled before each cache drop, as they would otherwise
+// keep reading into the next experiment
+static struct iohints_prefetch *aio_prefetches[IOHINTS_PREFETCH_MAX_REQUESTS];
+static int aio_prefetch_count = 0;
+static pthread_mutex_t aio_prefetch_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int mpi_rank = 0, mpi_rank_count = 1; // In MPI_COMM_WORLD. Only the MPI build runs several ranks
+#ifdef WITH_MPI
+static int mpi_node_rank = 0, mpi_node_count = 1; // Rank among the ranks sharing the page cache of the node, and number of nodes
+static MPI_Comm mpi_node_comm = MPI_COMM_NULL;
+#endif
+
+// State of a reader thread of the multi-threaded benchmark
+struct reader_thread {
+    pthread_t thread;
+    pthread_barrier_t *barrier;
+    FILE *fp;
+    int id;
+    enum reader_strategy strategy;
+    uint64_t region_offset, region_size, io_size, io_interarrival_time_ns;
+    uint64_t read_duration, volume; // Last experiment
+    uint64_t total_read_duration, total_volume; // Whole campaign
+    struct latency_histogram histogram; // Whole campaign
+};
 
 // Used for throughput instrumentation 
 static inline uint64_t get_timestamp_us();
 
-// Use /proc/sys/vm/drop_caches to drop the client page cache 
+// Used for per-I/O latency instrumentation
+static inline uint64_t get_timestamp_ns();
+
+// Wait until a timestamp given by get_timestamp_ns
+static inline void sleep_until_ns(uint64_t due_ns);
+
+// Start a new schedule of reads, one every interarrival_ns on average. Streams of the same schedule draw different gaps
+static inline void pacer_reset(struct pacer *pacer, uint64_t interarrival_ns, uint64_t stream);
+
+// When the next read should have started. Latencies measured from there include the time the read spent waiting for the previous ones
+static inline uint64_t pacer_intended_start(struct pacer *pacer);
+
+// Wait for the next read to be due. Late reads are not waited for, and the schedule does not shift to make up for them
+static inline void pacer_wait(struct pacer *pacer);
+
+// Print the arrival schedule column of paced configurations
+static inline void arrival_schedule_fprint(FILE *output_file, uint64_t interarrival_ns);
+
+// Start repeating a configuration
+static inline void repetition_reset(struct repetition *repetition);
+
+// Record the experiment that just ended from the running totals of the loop, and tell whether another one is needed
+static inline bool repetition_continue(struct repetition *repetition, uint64_t volume, uint64_t read_duration);
+
+// Half width of the 95% confidence interval of the mean throughput
+static inline double repetition_ci(const struct repetition *repetition);
+
+// Print the repetition columns of a configuration
+static inline void repetition_fprint(FILE *output_file, const struct repetition *repetition);
+
+// Create the event trace file, and start recording the events of the main thread
+static void event_trace_open(const char *path);
+
+// Flush the events of the main thread and close the event trace file
+static void event_trace_close();
+
+// Start recording the events of the calling thread, if the event trace is enabled
+static void event_trace_thread_start(uint16_t thread);
+
+// Flush the events of the calling thread and stop recording them
+static void event_trace_thread_stop();
+
+// Timestamp to start an event with, only taken when the calling thread records events
+static inline uint64_t event_trace_now();
+
+// Record an event that started at start_ns and ends now, if the calling thread records events
+static inline void event_trace_record(enum event_type type, uint64_t start_ns, uint64_t offset, uint64_t size, int64_t result);
+
+// Write the events recorded by the calling thread to the event trace file. Only call it outside of timed regions
+static void event_trace_flush();
+
+// Empty a latency histogram
+static inline void latency_histogram_reset(struct latency_histogram *histogram);
+
+// Record a single latency, in ns
+static inline void latency_histogram_record(struct latency_histogram *histogram, uint64_t latency_ns);
+
+// Add every value of source to destination
+static inline void latency_histogram_merge(struct latency_histogram *destination, const struct latency_histogram *source);
+
+// Print the p50/p90/p99/p99.9/max latency columns (in us), and end the output line
+static inline void latency_histogram_fprint(FILE *output_file, const struct latency_histogram *histogram);
+
+// Evict a file from the client page cache, falling back to /proc/sys/vm/drop_caches only when some of it stays resident
 static inline void client_cache_drop(int fd);
 
+// Use /proc/sys/vm/drop_caches to drop the whole client page cache 
+static inline void client_cache_drop_global(int fd);
+
+// Count the pages of a range that are resident in the client page cache, using cachestat or mincore on older kernels. A length of 0 means up to the end of the file.
+// Returns RESIDENT_PAGES_UNKNOWN when they could not be counted
+static inline uint64_t client_cache_resident_pages(int fd, uint64_t offset, uint64_t length);
+
+// Fraction of the pages of a range that are resident in the client page cache, -1 when it could not be measured
+static inline double client_cache_resident_fraction(int fd, uint64_t offset, uint64_t length);
+
+// Start recording the residency of a new configuration, whose timed loops should start in the given state
+static inline void residency_record_reset(struct residency_record *record, enum residency_precondition precondition);
+
+// Snapshot the residency of a range right before a timed loop, and check the precondition
+static inline void residency_record_before(struct residency_record *record, int fd, uint64_t offset, uint64_t length);
+
+// Snapshot the residency of a range right after a timed loop
+static inline void residency_record_after(struct residency_record *record, int fd, uint64_t offset, uint64_t length);
+
+// Print the mean resident fractions (-1 when none could be measured) and the precondition failures as columns
+static inline void residency_record_fprint(FILE *output_file, const struct residency_record *record);
+
+// Forget the experiments a residency sampler followed
+static inline void residency_sampler_reset(struct residency_sampler *sampler);
+
+// Start following the first length bytes of a file, right before a prefetch hint is issued
+static inline void residency_sampler_start(struct residency_sampler *sampler, int fd, uint64_t length, uint64_t io_size);
+
+// Tell the sampler that the reader starts reading
+static inline void residency_sampler_reader_start(struct residency_sampler *sampler);
+
+// Tell the sampler where the next read of the reader starts
+static inline void residency_sampler_progress(struct residency_sampler *sampler, uint64_t position);
+
+// Stop following the prefetch, and add the experiment to the sums
+static inline void residency_sampler_stop(struct residency_sampler *sampler);
+
+// Print the mean times to 50/90/100% resident, the prefetch bandwidth and when the reader caught up with the prefetch as columns
+static inline void residency_sampler_fprint(FILE *output_file, const struct residency_sampler *sampler);
+
+// Forget the experiments of a write cache record
+static inline void write_cache_record_reset(struct write_cache_record *record);
+
+// Snapshot the dirty, under writeback and resident pages of a range right after the last write of an experiment
+static inline void write_cache_record_after_write(struct write_cache_record *record, int fd, uint64_t offset, uint64_t length);
+
+// Snapshot the resident pages of a range once the experiment is flushed
+static inline void write_cache_record_after_sync(struct write_cache_record *record, int fd, uint64_t offset, uint64_t length);
+
+// Print the throughput including the final flush and the mean page cache fractions as columns. Dirty fractions are -1 without cachestat,
+// and resident ones when they could not be measured
+static inline void write_cache_record_fprint(FILE *output_file, const struct write_cache_record *record, uint64_t volume, uint64_t write_duration);
+
+// Start writing back a window that was just written, then wait for the previous one to be on disk, and drop it from the page cache if asked
+static inline void write_behind(int fd, uint64_t offset, uint64_t length, uint64_t previous_offset, uint64_t previous_length, bool drop);
+
 // Use fadvise to evict some data from the client page cache 
 static inline void client_cache_evict(int fd, uint64_t offset, uint64_t length);
 
@@ -83,169 +767,422 @@ static inline void server_cache_prefetch(int fd, uint64_t offset, uint64_t lengt
 // Use asynchronous I/O to forcefully prefetch some data 
 static inline void aio_prefetch(int fd, uint64_t offset, uint64_t length);
 
-void perform_baseline_benchmark(char *target_file, FILE *output_file){
+// Give back the handles of the asynchronous prefetches that are over, or wait for the oldest one when none is. Called with aio_prefetch_mutex held
+static inline void aio_prefetches_reap();
 
-    for(int h = 0; h<io_interarrival_time_count; h++){
-        uint64_t io_interarrival_time_ns = io_interarrival_times[h];
+// Cancel the asynchronous prefetches still in flight and wait for them to be over
+static inline void aio_prefetches_cancel();
 
-        // O_DIRECT
-        int fd = open(TARGET_FILE, O_RDONLY, O_DIRECT | O_SYNC); 
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
+// Create an io_uring instance, register buffer_count aligned buffers of buffer_size bytes and the target file descriptor
+static inline void io_uring_engine_init(struct io_uring_engine *engine, int fd, unsigned buffer_count, uint64_t buffer_size, bool sqpoll);
 
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
+// Unregister everything and tear down the io_uring instance
+static inline void io_uring_engine_destroy(struct io_uring_engine *engine);
 
-                // Allocating the read buffer
-                char *buffer = malloc(sizeof(char)*io_size);
+// Queue a read of the registered file into a registered buffer. The buffer index is given back as the completion user_data
+static inline void io_uring_engine_queue_read(struct io_uring_engine *engine, unsigned buffer_index, uint64_t offset, uint64_t length);
 
-                // Starting the campaign
-                int experiment_count;
-                uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
+// Hand the queued reads over to the kernel
+static inline void io_uring_engine_submit(struct io_uring_engine *engine);
 
-                    // Cleaning the cache at the beginning of each experiment
-                    #ifdef WITH_LUSTRE
-                    server_cache_evict(fd, 0, file_size);
-                    #endif
-                    client_cache_drop(fd);
-                    // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+// Wait for a single completion and consume it
+static inline void io_uring_engine_wait(struct io_uring_engine *engine, struct io_uring_cqe *cqe);
 
-                    // Running the experimentation once
-                    lseek(fd, 0, SEEK_SET);
-                    uint64_t t1 = get_timestamp_us();
-                    for(size_t volume = 0; volume<file_size; volume+=io_size){
-                        int ret = read(fd, buffer, io_size);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                            exit(0);
-                        }
-                        if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
-                        }
-                    }
-                    read_duration += get_timestamp_us()-t1;
-                }
-                free(buffer);
-                fprintf(output_file, "target='%s', category='Baseline', label='O_DIRECT', "
-                    #if OUTPUT_EXPERIMENT_DESCRIPTION
-                    "desc='File not cached, no readahead, using O_DIRECT', "
-                    #endif
-                    "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size,
-                    experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
-                fflush(output_file);
-            }
-        }
-        close(fd);
+// Wait for every in-flight read to complete
+static inline void io_uring_engine_drain(struct io_uring_engine *engine);
 
-        // Not cached
-        FILE *fp = fopen(TARGET_FILE, "r");
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
+// Give the madvise hint of an mmap strategy on a whole mapping. Returns false when the kernel does not support it
+static inline bool mmap_strategy_apply(enum mmap_strategy strategy, char *mapping, uint64_t length);
 
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
+// Find the logical block size of the device backing a file, which O_DIRECT offsets, sizes and buffers must be aligned to
+static inline uint64_t get_logical_block_size(int fd);
 
-                // Allocating the read buffer
-                char *buffer = malloc(sizeof(char)*io_size);
+// Parse the command line (and the config files it points to) into the sweep parameters
+static void parse_arguments(int argc, char **argv);
 
-                // Starting the campaign
-                int experiment_count;
-                uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
+// Tell whether a configuration of the sweep should run, and count it towards the campaign estimate
+static inline bool configuration_selected(const char *strategy, uint64_t file_size);
 
-                    // Cleaning the cache at the beginning of each experiment
-                    #ifdef WITH_LUSTRE
-                    server_cache_evict(fileno(fp), 0, file_size);
-                    #endif
-                    client_cache_drop(fileno(fp));
-                    // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+// Load a trace, either binary (TRACE_BINARY_MAGIC followed by trace_record structures) or text ("timestamp_s offset size" per line)
+static void trace_load(const char *path, struct trace *trace);
 
-                    // Running the experimentation once
-                    fseek(fp, 0, SEEK_SET);
-                    uint64_t t1 = get_timestamp_us();
-                    for(size_t volume = 0; volume<file_size; volume+=io_size){
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                            exit(0);
-                        }
-                        if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
+// Fill thread_counts with 1, 2, 4... up to the number of online cores (included), and return how many counts were written
+static inline int get_reader_thread_counts(int *thread_counts);
+
+// Create the target file, and fill its first file_size bytes with the deterministic content of the libiohints generator
+static void generate_target_file(const char *path, uint64_t file_size);
+
+#ifdef WITH_MPI
+// Number of I/Os each rank of the MPI benchmark reads. The tail of the file might be left unread
+static inline uint64_t mpi_layout_read_count(uint64_t file_size, uint64_t io_size);
+
+// Fill offsets with the offsets of the I/Os the calling rank reads in a layout, in the order it reads them
+static inline void mpi_layout_offsets(uint64_t *offsets, enum mpi_layout layout, uint64_t file_size, uint64_t io_size);
+
+// Fill ranges with what to prefetch before the read-th I/O of a rank: nothing, unless it starts a window of prefetch size, in which
+// case the I/Os of the window, contiguous ones merged. Return how many ranges were written, at most prefetch_size/io_size
+static inline uint64_t mpi_prefetch_ranges(struct access_range *ranges, const uint64_t *offsets, uint64_t read, uint64_t read_count, uint64_t io_size, uint64_t prefetch_size);
+
+// Join the MPI job: find out the rank of this process, and which ranks share its node
+static void mpi_start(int *argc, char ***argv);
+
+// Decide on rank 0 whether another experiment is needed, from the totals of every rank, and tell every rank
+static inline bool mpi_repetition_continue(struct repetition *repetition, uint64_t volume, uint64_t read_duration);
+
+// Reduce the throughput of every rank to their mean, minimum and maximum on rank 0
+static inline void mpi_rank_throughputs_reduce(double rank_throughput, double *mean, double *min, double *max);
+
+// Merge the latency histograms of every rank into destination on rank 0
+static inline void mpi_latency_histogram_reduce(struct latency_histogram *destination, const struct latency_histogram *source);
+
+// Create the MPI_Info hints of the MPI-IO benchmark for a layout, to be freed with MPI_Info_free
+static MPI_Info mpiio_hints_create(enum mpi_layout layout);
+
+// Exit with an error message when an MPI-IO call on the target file did not succeed. action is e.g. "opening" or "reading"
+static inline void mpiio_check(int ret, const char *action);
+
+// Print the mpiio_hint_keys hints of an opened file, as the MPI-IO implementation applied them ('' when it ignored them)
+static void mpiio_hints_fprint(FILE *output_file, MPI_File file);
+#endif
+
+// Plain reader mode: read the first file size of the target with read() calls, io size at a time in the first access pattern, and print the read time in us
+static void perform_plain_read();
+
+// Run the plain reader in a new process, with the interposer preloaded when the strategy hints, and return its read time in us
+static uint64_t plain_reader_run(enum interposer_strategy strategy, uint64_t file_size, uint64_t io_size, uint64_t io_interarrival_time_ns);
+
+// Run the experiments of a configuration of a registered strategy, and print its row
+static void registered_strategy_run(const struct iohints_strategy *strategy, struct iohints_strategy_run *run, char *target_file, FILE *output_file, uint64_t io_size, uint64_t io_interarrival_time_ns);
+
+// Hooks of the built-in strategies driven by perform_registered_benchmark
+static int baseline_sequential_prepare(struct iohints_strategy_run *run);
+static int baseline_random_prepare(struct iohints_strategy_run *run);
+static int offline_prepare(struct iohints_strategy_run *run);
+static void offline_prefetch(struct iohints_strategy_run *run);
+#ifdef WITH_LUSTRE
+static void offline_ladvise_evict(struct iohints_strategy_run *run);
+#endif
+static void offline_drop_cache_evict(struct iohints_strategy_run *run);
+static void offline_fadvise_evict(struct iohints_strategy_run *run);
+#ifdef WITH_LUSTRE
+static void jit_fadvise_ladvise_prefetch(struct iohints_strategy_run *run);
+static void jit_ladvise_prefetch(struct iohints_strategy_run *run);
+#endif
+static void jit_fadvise_prefetch(struct iohints_strategy_run *run);
+static void jit_aio_prefetch(struct iohints_strategy_run *run);
+static int online_prepare(struct iohints_strategy_run *run);
+static void online_fadvise_read(struct iohints_strategy_run *run, uint64_t read, uint64_t offset, uint64_t length);
+static void online_aio_read(struct iohints_strategy_run *run, uint64_t read, uint64_t offset, uint64_t length);
+#ifdef WITH_LUSTRE
+static void online_ladvise_read(struct iohints_strategy_run *run, uint64_t read, uint64_t offset, uint64_t length);
+static void online_fadvise_ladvise_read(struct iohints_strategy_run *run, uint64_t read, uint64_t offset, uint64_t length);
+static void online_aio_ladvise_read(struct iohints_strategy_run *run, uint64_t read, uint64_t offset, uint64_t length);
+#endif
+static void run_data_teardown(struct iohints_strategy_run *run);
+
+// Add a strategy to the registry of libiohints, refusing the names of the strategies with a benchmark loop of their own
+static void strategy_register(const struct iohints_strategy *strategy);
+
+// Load a strategy module, and register the strategies it returns
+static void strategy_module_load(const char *path);
+
+// Use io_uring to forcefully prefetch some data, without going through the glibc aio thread pool
+static inline void io_uring_prefetch(struct io_uring_engine *engine, uint64_t offset, uint64_t length);
+
+// Forget everything an adaptive prefetcher learnt, starting again from the smallest window and distance
+static inline void adaptive_prefetcher_reset(struct adaptive_prefetcher *prefetcher);
+
+// Feed an upcoming access to an adaptive prefetcher: learn the stride, and fadvise the accesses ahead once it is confirmed
+static inline void adaptive_prefetcher_access(struct adaptive_prefetcher *prefetcher, int fd, uint64_t offset, uint64_t size);
+
+// Read an access through an adaptive prefetcher, growing or shrinking its window and distance depending on whether the data was resident
+static inline ssize_t adaptive_prefetcher_read(struct adaptive_prefetcher *prefetcher, FILE *fp, char *buffer, uint64_t offset, uint64_t size);
+
+// Offset of the read-th read of a file_size range read io_size at a time in the current access pattern, or file_size past the last read
+static inline uint64_t access_pattern_offset(uint64_t read, uint64_t file_size, uint64_t io_size);
+
+// Fill ranges with the hints an online strategy gives before the read-th read, when it prefetches prefetch_size bytes ahead of the stream
+// being read, and return how many there are (0 when no hint is due). ranges must hold prefetch_size/io_size+1 of them
+static inline uint64_t access_pattern_prefetch_ranges(struct access_range *ranges, uint64_t read, uint64_t file_size, uint64_t io_size, uint64_t prefetch_size);
+
+// Print the access pattern column of a configuration
+static inline void access_pattern_fprint(FILE *output_file);
+
+// Strategies whose only difference is how they hint the file, all run by perform_registered_benchmark
+static const struct iohints_strategy baseline_o_direct_strategy = {
+    "baseline/o_direct", "Baseline", "O_DIRECT", "File not cached, no readahead, using O_DIRECT with queue_depth reads in flight", IOHINTS_STRATEGY_DIRECT_IO,
+    NULL, NULL, NULL, NULL, NULL, NULL
+};
+static const struct iohints_strategy baseline_not_cached_strategy = {
+    "baseline/not_cached", "Baseline", "Not cached", "File not cached", 0, NULL, NULL, NULL, NULL, NULL, NULL
+};
+static const struct iohints_strategy baseline_sequential_strategy = {
+    "baseline/sequential", "Extended baseline", "Not cached but marked as sequential", "File not cached, but fadvise was used to mark it as sequential", 0,
+    baseline_sequential_prepare, NULL, NULL, NULL, NULL, NULL
+};
+static const struct iohints_strategy baseline_random_strategy = {
+    "baseline/random", "Extended baseline", "Not cached but marked as random", "File not cached, but fadvise was used to mark it as random", 0,
+    baseline_random_prepare, NULL, NULL, NULL, NULL, NULL
+};
+static const struct iohints_strategy offline_sync_read_strategy = {
+    "offline/sync_read", "Offline prefetch", "Offline prefetch\\n(sync read)", "File was read once before the experiment", IOHINTS_STRATEGY_CACHED,
+    offline_prepare, offline_prefetch, NULL, NULL, NULL, run_data_teardown
+};
+#ifdef WITH_LUSTRE
+static const struct iohints_strategy offline_ladvise_evict_strategy = {
+    "offline/ladvise_evict", "Offline prefetch", "Offline client-side prefetch\\n(sync read + ladvise evict)",
+    "File was read once before the experiment, but lla_ladvise was used to evict it from the server cache", IOHINTS_STRATEGY_CACHED,
+    offline_prepare, offline_prefetch, offline_ladvise_evict, NULL, NULL, run_data_teardown
+};
+#endif
+static const struct iohints_strategy offline_drop_cache_evict_strategy = {
+    "offline/drop_cache_evict", "Offline prefetch", "Offline server-side prefetch\\n(sync read + drop_cache evict)",
+    "File was read once before the experiment, but /proc/sys/vm/drop_caches was used to evict it from the client cache", 0,
+    offline_prepare, offline_prefetch, offline_drop_cache_evict, NULL, NULL, run_data_teardown
+};
+static const struct iohints_strategy offline_fadvise_evict_strategy = {
+    "offline/fadvise_evict", "Offline prefetch", "Offline server-side prefetch\\n(sync read + fadvise evict)",
+    "File was read once before the experiment, but fadvise was used to evict it from the client cache", 0,
+    offline_prepare, offline_prefetch, offline_fadvise_evict, NULL, NULL, run_data_teardown
+};
+#ifdef WITH_LUSTRE
+static const struct iohints_strategy jit_fadvise_ladvise_strategy = {
+    "jit/fadvise_ladvise", "JIT prefetch", "JIT fadvise+ladvise prefetch of the whole file",
+    "File was prefetched to the server page cache using llu_ladvise and to the client page cache using fadvise prefetch_delay us before the reading started",
+    IOHINTS_STRATEGY_PREFETCH_DELAYS, NULL, jit_fadvise_ladvise_prefetch, NULL, NULL, NULL, NULL
+};
+#endif
+static const struct iohints_strategy jit_fadvise_strategy = {
+    "jit/fadvise", "JIT prefetch", "JIT fadvise prefetch of the whole file",
+    "File was prefetched to the client page cache using fadvise prefetch_delay us before the reading started",
+    IOHINTS_STRATEGY_PREFETCH_DELAYS, NULL, jit_fadvise_prefetch, NULL, NULL, NULL, NULL
+};
+#ifdef WITH_LUSTRE
+static const struct iohints_strategy jit_ladvise_strategy = {
+    "jit/ladvise", "JIT prefetch", "JIT ladvise prefetch of the whole file",
+    "File was prefetched to the server page cache using llu_ladvise prefetch_delay us before the reading started",
+    IOHINTS_STRATEGY_PREFETCH_DELAYS, NULL, jit_ladvise_prefetch, NULL, NULL, NULL, NULL
+};
+#endif
+static const struct iohints_strategy jit_aio_strategy = {
+    "jit/aio", "JIT prefetch", "JIT async-io prefetch of the whole file",
+    "File was prefetched to the client page cache using aio_read prefetch_delay us before the reading started",
+    IOHINTS_STRATEGY_PREFETCH_DELAYS, NULL, jit_aio_prefetch, NULL, NULL, NULL, NULL
+};
+#ifdef WITH_LUSTRE
+static const struct iohints_strategy online_fadvise_ladvise_strategy = {
+    "online/fadvise_ladvise", "Online prefetch", "fadvise+ladvise online prefetching", "The file is prefetched using prefetch_size bytes llu_ladvise AND fadvise prefetches",
+    IOHINTS_STRATEGY_PREFETCH_SIZES, online_prepare, NULL, NULL, NULL, online_fadvise_ladvise_read, run_data_teardown
+};
+static const struct iohints_strategy online_aio_ladvise_strategy = {
+    "online/aio_ladvise", "Online prefetch", "aio_read+ladvise online prefetching", "The file is prefetched using prefetch_size bytes llu_ladvise AND aio_read prefetches",
+    IOHINTS_STRATEGY_PREFETCH_SIZES, online_prepare, NULL, NULL, NULL, online_aio_ladvise_read, run_data_teardown
+};
+#endif
+static const struct iohints_strategy online_fadvise_strategy = {
+    "online/fadvise", "Online prefetch", "fadvise online prefetching", "The file is prefetched using prefetch_size bytes fadvise prefetches",
+    IOHINTS_STRATEGY_PREFETCH_SIZES, online_prepare, NULL, NULL, NULL, online_fadvise_read, run_data_teardown
+};
+#ifdef WITH_LUSTRE
+static const struct iohints_strategy online_ladvise_strategy = {
+    "online/ladvise", "Online prefetch", "ladvise online prefetching", "The file is prefetched using prefetch_size bytes llapi_ladvise prefetches",
+    IOHINTS_STRATEGY_PREFETCH_SIZES, online_prepare, NULL, NULL, NULL, online_ladvise_read, run_data_teardown
+};
+#endif
+static const struct iohints_strategy online_aio_strategy = {
+    "online/aio", "Online prefetch", "async-io online prefetching", "The file is prefetched using prefetch_size bytes aio_read prefetches",
+    IOHINTS_STRATEGY_PREFETCH_SIZES, online_prepare, NULL, NULL, NULL, online_aio_read, run_data_teardown
+};
+
+// Strategies registered before those of the strategy modules, which perform_registered_benchmark runs in this order
+static const struct iohints_strategy *builtin_strategies[] = {
+    &baseline_o_direct_strategy,
+    &baseline_not_cached_strategy,
+    &baseline_sequential_strategy,
+    &baseline_random_strategy,
+    &offline_sync_read_strategy,
+    #ifdef WITH_LUSTRE
+    &offline_ladvise_evict_strategy,
+    #endif
+    &offline_drop_cache_evict_strategy,
+    &offline_fadvise_evict_strategy,
+    #ifdef WITH_LUSTRE
+    &jit_fadvise_ladvise_strategy,
+    #endif
+    &jit_fadvise_strategy,
+    #ifdef WITH_LUSTRE
+    &jit_ladvise_strategy,
+    #endif
+    &jit_aio_strategy,
+    #ifdef WITH_LUSTRE
+    &online_fadvise_ladvise_strategy,
+    &online_aio_ladvise_strategy,
+    #endif
+    &online_fadvise_strategy,
+    #ifdef WITH_LUSTRE
+    &online_ladvise_strategy,
+    #endif
+    &online_aio_strategy,
+    NULL
+};
+
+// Benchmark the registered strategies, the built-in ones then those of the strategy modules. They all read the file the same
+// way, and only differ by their hooks and by the sweeps their flags ask for
+void perform_registered_benchmark(char *target_file, FILE *output_file){
+    const struct iohints_strategy *const *strategies = iohints_strategy_registry();
+
+    // Direct I/Os must cover whole logical blocks of the device backing the file
+    int fd = open(target_file_path, O_RDONLY);
+    if(fd<0){
+        printf("Error opening file \"%s\": %s\n", target_file_path, strerror(errno));
+        exit(0);
+    }
+    uint64_t block_size = get_logical_block_size(fd);
+    close(fd);
+
+    for(int h = 0; h<io_interarrival_time_count; h++){
+        uint64_t io_interarrival_time_ns = io_interarrival_times[h];
+
+        for(int s = 0; strategies[s]; s++){
+            const struct iohints_strategy *strategy = strategies[s];
+            bool prefetch_size_sweep = (strategy->flags & IOHINTS_STRATEGY_PREFETCH_SIZES)!=0;
+            bool prefetch_delay_sweep = (strategy->flags & IOHINTS_STRATEGY_PREFETCH_DELAYS)!=0;
+            bool direct_io = (strategy->flags & IOHINTS_STRATEGY_DIRECT_IO)!=0;
+
+            for(int i = 0; i<file_size_count; i++){
+                uint64_t file_size = file_sizes[i];
+
+                for(int j = 0; j<io_size_count; j++){
+                    uint64_t io_size = io_sizes[j];
+                    if(io_size>file_size) continue;
+                    uint64_t read_size = direct_io ? (io_size+block_size-1)/block_size*block_size : io_size;
+
+                    for(int k = 0; k<(prefetch_size_sweep ? io_size_count : 1); k++){
+                        uint64_t prefetch_size = prefetch_size_sweep ? io_sizes[k] : 0;
+                        if(prefetch_size_sweep && prefetch_size<=io_size) continue;
+
+                        for(int d = 0; d<(prefetch_delay_sweep ? jit_prefetch_delay_count : 1); d++){
+                            uint64_t prefetch_delay = prefetch_delay_sweep ? jit_prefetch_delays[d] : 0;
+
+                            for(int q = 0; q<(direct_io ? direct_io_queue_depth_count : 1); q++){
+                                unsigned queue_depth = direct_io ? direct_io_queue_depths[q] : 1;
+                                if(direct_io && read_size*queue_depth>DIRECT_IO_MAX_POOL_SIZE) continue;
+
+                                if(!configuration_selected(strategy->name, file_size)) continue;
+
+                                struct iohints_strategy_run run = {-1, file_size, read_size, prefetch_size, 0, prefetch_delay, queue_depth, 0, NULL, NULL};
+                                registered_strategy_run(strategy, &run, target_file, output_file, io_size, io_interarrival_time_ns);
+                            }
                         }
                     }
-                    read_duration += get_timestamp_us()-t1;
                 }
-                fprintf(output_file, "target='%s', category='Baseline', label='Not cached', "
-                    #if OUTPUT_EXPERIMENT_DESCRIPTION
-                    "desc='File not cached', "
-                    #endif
-                    "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size,
-                    experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
-                free(buffer);
-                fflush(output_file);
             }
         }
+    }
+}
+
+void perform_online_prefetch_benchmark(char *target_file, FILE *output_file){
 
-        // Not cached but marked as sequential
+    for(int h = 0; h<io_interarrival_time_count; h++){
+        uint64_t io_interarrival_time_ns = io_interarrival_times[h];
+        FILE *fp = fopen(target_file_path, "r");
+
+        // Dynamic io_uring prefetching
         for(int i = 0; i<file_size_count; i++){
             uint64_t file_size = file_sizes[i];
 
             for(int j = 0; j<io_size_count; j++){
                 uint64_t io_size = io_sizes[j];
                 if(io_size>file_size) continue;
+                
+                for(int k=0; k<io_size_count; k++){
+                    uint64_t prefetch_size = io_sizes[k];
+                    if(prefetch_size<=io_size) continue;
 
-                // Allocating the read buffer
-                char *buffer = malloc(sizeof(char)*io_size);
-
-                // Starting the campaign
-                int experiment_count;
-                uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
-
-                    // Cleaning the cache at the beginning of each experiment
-                    #ifdef WITH_LUSTRE
-                    server_cache_evict(fileno(fp), 0, file_size);
-                    #endif
-                    client_cache_drop(fileno(fp));
-                    // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
-
-                    // Running the experimentation once
-                    fseek(fp, 0, SEEK_SET);
-                    posix_fadvise(fileno(fp), 0, file_size, POSIX_FADV_SEQUENTIAL);
-                    uint64_t t1 = get_timestamp_us();
-                    for(size_t volume = 0; volume<file_size; volume+=io_size){
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                            exit(0);
-                        }
-                        if(io_interarrival_time_ns!=0){
+                    for(int l=0; l<io_uring_sqpoll_mode_count; l++){
+                        bool sqpoll = io_uring_sqpoll_modes[l];
+
+                        if(!configuration_selected("online/io_uring", file_size)) continue;
+
+                        // Allocating the read buffer, the io_uring instance, and the ranges to prefetch
+                        char *buffer = malloc(sizeof(char)*io_size);
+                        struct access_range *ranges = malloc(sizeof(struct access_range)*(prefetch_size/io_size+1));
+                        struct latency_histogram histogram;
+                        latency_histogram_reset(&histogram);
+                        struct residency_record residency;
+                        residency_record_reset(&residency, RESIDENCY_COLD);
+                        struct io_uring_engine engine;
+                        io_uring_engine_init(&engine, fileno(fp), IO_URING_QUEUE_DEPTH, IO_URING_BUFFER_SIZE, sqpoll);
+
+                        // Starting the campaign
+                        int experiment_count;
+                        struct repetition repetition;
+                        repetition_reset(&repetition);
+                        uint64_t read_duration = 0;
+                        for(experiment_count=0; repetition_continue(&repetition, experiment_count*file_size, read_duration); experiment_count++){
+
+                            // Cleaning the cache at the beginning of each experiment
+                            #ifdef WITH_LUSTRE
+                            server_cache_evict(fileno(fp), 0, file_size);
+                            #endif
+                            client_cache_drop(fileno(fp));
+                            // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+
+                            // Running the experimentation: reading, and sometimes prefetching!
+                            fseek(fp, 0, SEEK_SET);
+                            residency_record_before(&residency, fileno(fp), 0, file_size);
+                            struct pacer pacer;
+                            pacer_reset(&pacer, io_interarrival_time_ns, 0);
+                            uint64_t t1 = get_timestamp_us();
+                            for(size_t volume = 0; volume<file_size; volume+=io_size){
+                                uint64_t offset = access_pattern_offset(volume/io_size, file_size, io_size);
+                                if(access_pattern!=ACCESS_PATTERN_FORWARD) fseek(fp, offset, SEEK_SET);
+                                uint64_t range_count = access_pattern_prefetch_ranges(ranges, volume/io_size, file_size, io_size, prefetch_size);
+                                for(uint64_t r = 0; r<range_count; r++) io_uring_prefetch(&engine, ranges[r].offset, ranges[r].length);
+                                uint64_t t2 = pacer_intended_start(&pacer);
+                                int ret = fread(buffer, sizeof(char), io_size, fp);
+                                latency_histogram_record(&histogram, get_timestamp_ns()-t2);
+                                event_trace_record(EVENT_READ, t2, offset, io_size, ret);
+                                if(__glibc_unlikely(ret < 0)){
+                                    printf("Error reading file \"%s\": %s\n", target_file_path, strerror(errno));
+                                    exit(0);
+                                }
+                                if(io_interarrival_time_ns!=0){
+                                    read_duration += get_timestamp_us()-t1;
+                                    pacer_wait(&pacer);
+                                    t1 = get_timestamp_us();
+                                }
+                            }
                             read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
+                            event_trace_flush();
+                            residency_record_after(&residency, fileno(fp), 0, file_size);
+
+                            // Prefetches still in flight must not leak into the next experiment
+                            io_uring_engine_drain(&engine);
                         }
+                        fprintf(output_file, "target='%s', category='Online prefetch', label='io_uring online prefetching', "
+                            #if OUTPUT_EXPERIMENT_DESCRIPTION
+                            "desc='The file is prefetched using %llu bytes io_uring reads into registered buffers', "
+                            #endif
+                            "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, prefetch_size=%llu, sqpoll=%d, throughput_gb_per_second=%.3f", target_file, 
+                            #if OUTPUT_EXPERIMENT_DESCRIPTION
+                            prefetch_size, 
+                            #endif
+                            file_size, io_interarrival_time_ns, io_size, prefetch_size, sqpoll, experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
+                        arrival_schedule_fprint(output_file, io_interarrival_time_ns);
+                        access_pattern_fprint(output_file);
+                        repetition_fprint(output_file, &repetition);
+                        residency_record_fprint(output_file, &residency);
+                        latency_histogram_fprint(output_file, &histogram);
+                        io_uring_engine_destroy(&engine);
+                        free(ranges);
+                        free(buffer);
+                        fflush(output_file);
                     }
-                    read_duration += get_timestamp_us()-t1;
                 }
-                fprintf(output_file, "target='%s', category='Extended baseline', label='Not cached but marked as sequential', "
-                    #if OUTPUT_EXPERIMENT_DESCRIPTION
-                    "desc='File not cached, but fadvise was used to mark it as sequential', "
-                    #endif
-                    "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size,
-                    experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
-                free(buffer);
-                fflush(output_file);
             }
         }
-
-        // Not cached but marked as random
+        // Adaptive fadvise prefetching, which tunes its own prefetch size instead of sweeping it
         for(int i = 0; i<file_size_count; i++){
             uint64_t file_size = file_sizes[i];
 
@@ -253,13 +1190,23 @@ void perform_baseline_benchmark(char *target_file, FILE *output_file){
                 uint64_t io_size = io_sizes[j];
                 if(io_size>file_size) continue;
 
-                // Allocating the read buffer
+                if(!configuration_selected("online/adaptive", file_size)) continue;
+
+                // Allocating the read buffer and the prefetcher
                 char *buffer = malloc(sizeof(char)*io_size);
+                struct latency_histogram histogram;
+                latency_histogram_reset(&histogram);
+                struct residency_record residency;
+                residency_record_reset(&residency, RESIDENCY_COLD);
+                struct adaptive_prefetcher prefetcher;
+                uint64_t window_sum = 0, distance_sum = 0, hint_window_sum = 0, prefetch_count = 0, hits = 0, misses = 0;
 
                 // Starting the campaign
                 int experiment_count;
-                uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
+                struct repetition repetition;
+                repetition_reset(&repetition);
+                uint64_t read_duration = 0;
+                for(experiment_count=0; repetition_continue(&repetition, experiment_count*file_size, read_duration); experiment_count++){
 
                     // Cleaning the cache at the beginning of each experiment
                     #ifdef WITH_LUSTRE
@@ -268,30 +1215,56 @@ void perform_baseline_benchmark(char *target_file, FILE *output_file){
                     client_cache_drop(fileno(fp));
                     // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
 
-                    // Running the experimentation once
+                    // Running the experimentation: reading, and letting the prefetcher decide when and how much to prefetch
+                    adaptive_prefetcher_reset(&prefetcher);
                     fseek(fp, 0, SEEK_SET);
-                    posix_fadvise(fileno(fp), 0, file_size, POSIX_FADV_RANDOM);
+                    residency_record_before(&residency, fileno(fp), 0, file_size);
+                    struct pacer pacer;
+                    pacer_reset(&pacer, io_interarrival_time_ns, 0);
                     uint64_t t1 = get_timestamp_us();
                     for(size_t volume = 0; volume<file_size; volume+=io_size){
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
+                        uint64_t offset = access_pattern_offset(volume/io_size, file_size, io_size);
+                        if(access_pattern!=ACCESS_PATTERN_FORWARD) fseek(fp, offset, SEEK_SET);
+                        adaptive_prefetcher_access(&prefetcher, fileno(fp), offset, io_size);
+                        uint64_t t2 = pacer_intended_start(&pacer);
+                        ssize_t ret = adaptive_prefetcher_read(&prefetcher, fp, buffer, offset, io_size);
+                        latency_histogram_record(&histogram, get_timestamp_ns()-t2);
+                        event_trace_record(EVENT_READ, t2, offset, io_size, ret);
                         if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
+                            printf("Error reading file \"%s\": %s\n", target_file_path, strerror(errno));
                             exit(0);
                         }
                         if(io_interarrival_time_ns!=0){
                             read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
+                            pacer_wait(&pacer);
                             t1 = get_timestamp_us();
                         }
                     }
                     read_duration += get_timestamp_us()-t1;
+                    event_trace_flush();
+                    residency_record_after(&residency, fileno(fp), 0, file_size);
+
+                    // Keeping track of where the prefetcher converged at the end of the file
+                    window_sum += prefetcher.window;
+                    distance_sum += prefetcher.distance;
+                    hint_window_sum += prefetcher.window_sum;
+                    prefetch_count += prefetcher.prefetch_count;
+                    hits += prefetcher.hits;
+                    misses += prefetcher.misses;
                 }
-                fprintf(output_file, "target='%s', category='Extended baseline', label='Not cached but marked as random', "
+                fprintf(output_file, "target='%s', category='Online prefetch', label='adaptive fadvise online prefetching', "
                     #if OUTPUT_EXPERIMENT_DESCRIPTION
-                    "desc='File not cached, but fadvise was used to mark it as random', "
+                    "desc='The prefetcher detects the stride of the accesses, and tunes its fadvise prefetches depending on whether the data was resident when read', "
                     #endif
-                    "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size,
+                    "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, prefetch_size=%llu, prefetch_distance=%llu, mean_prefetch_size=%llu, resident_ratio=%.3f, throughput_gb_per_second=%.3f",
+                    target_file, file_size, io_interarrival_time_ns, io_size, window_sum/experiment_count, distance_sum/experiment_count,
+                    prefetch_count ? hint_window_sum/prefetch_count : 0, hits+misses ? (double)hits/(hits+misses) : 0,
                     experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
+                arrival_schedule_fprint(output_file, io_interarrival_time_ns);
+                access_pattern_fprint(output_file);
+                repetition_fprint(output_file, &repetition);
+                residency_record_fprint(output_file, &residency);
+                latency_histogram_fprint(output_file, &histogram);
                 free(buffer);
                 fflush(output_file);
             }
@@ -300,904 +1273,3168 @@ void perform_baseline_benchmark(char *target_file, FILE *output_file){
     }
 }
 
-void perform_offline_prefetch_benchmark(char *target_file, FILE *output_file){
+void perform_mmap_benchmark(char *target_file, FILE *output_file){
 
     for(int h = 0; h<io_interarrival_time_count; h++){
         uint64_t io_interarrival_time_ns = io_interarrival_times[h];
-        FILE *fp = fopen(TARGET_FILE, "r");
+        FILE *fp = fopen(target_file_path, "r");
 
-        // Cached
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
+        // Reading through a memory mapping, with each of the madvise hints
+        for(int s = 0; s<MMAP_STRATEGY_COUNT; s++){
+            enum mmap_strategy strategy = s;
+            bool supported = true;
 
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
+            for(int i = 0; i<file_size_count && supported; i++){
+                uint64_t file_size = file_sizes[i];
 
-                // Allocating the read buffer
-                char *buffer = malloc(sizeof(char)*io_size);
+                for(int j = 0; j<io_size_count && supported; j++){
+                    uint64_t io_size = io_sizes[j];
+                    if(io_size>file_size) continue;
 
-                // Starting the campaign
-                int experiment_count;
-                uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
+                    if(!configuration_selected(mmap_strategy_names[strategy], file_size)) continue;
 
-                    // Cleaning the cache at the beginning of each experiment
-                    #ifdef WITH_LUSTRE
-                    server_cache_evict(fileno(fp), 0, file_size);
-                    #endif
-                    client_cache_drop(fileno(fp));
-                    // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+                    // Allocating the read buffer, which the mapped data is copied to just like read() would
+                    char *buffer = malloc(sizeof(char)*io_size);
+                    struct latency_histogram histogram;
+                    latency_histogram_reset(&histogram);
+                    struct residency_record residency;
+                    residency_record_reset(&residency, RESIDENCY_COLD);
 
-                    // Running the experimentation once: first a dummy read to have the file in cache, then the instrumented read
-                    fseek(fp, 0, SEEK_SET);
-                    for(size_t volume = 0; volume<file_size; volume+=io_size){
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                            exit(0);
-                        }
-                    }
-                    fseek(fp, 0, SEEK_SET);
-                    uint64_t t1 = get_timestamp_us();
-                    for(size_t volume = 0; volume<file_size; volume+=io_size){
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
+                    // Starting the campaign
+                    int experiment_count;
+                    struct repetition repetition;
+                    repetition_reset(&repetition);
+                    uint64_t read_duration = 0;
+                    for(experiment_count=0; repetition_continue(&repetition, experiment_count*file_size, read_duration); experiment_count++){
+
+                        // Cleaning the cache at the beginning of each experiment, then mapping the file
+                        #ifdef WITH_LUSTRE
+                        server_cache_evict(fileno(fp), 0, file_size);
+                        #endif
+                        client_cache_drop(fileno(fp));
+                        // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+                        char *mapping = mmap(NULL, file_size, PROT_READ, MAP_SHARED, fileno(fp), 0);
+                        if(mapping==MAP_FAILED){
+                            printf("Error mapping file \"%s\": %s\n", target_file_path, strerror(errno));
                             exit(0);
                         }
-                        if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
+
+                        // Running the experimentation once: the hint is part of the timed region, as POPULATE_READ does the reading itself
+                        fseek(fp, 0, SEEK_SET);
+                        residency_record_before(&residency, fileno(fp), 0, file_size);
+                        struct pacer pacer;
+                        pacer_reset(&pacer, io_interarrival_time_ns, 0);
+                        uint64_t t1 = get_timestamp_us();
+                        if(!mmap_strategy_apply(strategy, mapping, file_size)){
+                            printf("madvise is not supported for \"%s\" on \"%s\": %s, skipping\n", mmap_strategy_names[strategy], target_file_path, strerror(errno));
+                            supported = false;
+                            munmap(mapping, file_size);
+                            break;
                         }
+                        for(size_t volume = 0; volume<file_size; volume+=io_size){
+                            uint64_t offset = access_pattern_offset(volume/io_size, file_size, io_size), length = io_size<file_size-offset ? io_size : file_size-offset;
+                            uint64_t t2 = pacer_intended_start(&pacer);
+                            memcpy(buffer, mapping+offset, length);
+                            latency_histogram_record(&histogram, get_timestamp_ns()-t2);
+                            event_trace_record(EVENT_READ, t2, offset, length, length);
+                            if(io_interarrival_time_ns!=0){
+                                read_duration += get_timestamp_us()-t1;
+                                pacer_wait(&pacer);
+                                t1 = get_timestamp_us();
+                            }
+                        }
+                        read_duration += get_timestamp_us()-t1;
+                        event_trace_flush();
+                        residency_record_after(&residency, fileno(fp), 0, file_size);
+                        munmap(mapping, file_size);
                     }
-                    read_duration += get_timestamp_us()-t1;
+                    if(supported){
+                        fprintf(output_file, "target='%s', category='mmap', label='%s', "
+                            #if OUTPUT_EXPERIMENT_DESCRIPTION
+                            "desc='The file is mapped, hinted with madvise, then read through page faults', "
+                            #endif
+                            "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f", target_file, mmap_strategy_labels[strategy], file_size, io_interarrival_time_ns, io_size,
+                            experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
+                        arrival_schedule_fprint(output_file, io_interarrival_time_ns);
+                        access_pattern_fprint(output_file);
+                        repetition_fprint(output_file, &repetition);
+                        residency_record_fprint(output_file, &residency);
+                        latency_histogram_fprint(output_file, &histogram);
+                    }
+                    free(buffer);
+                    fflush(output_file);
                 }
-                fprintf(output_file, "target='%s', category='Offline prefetch', label='Offline prefetch\\n(sync read)', "
-                    #if OUTPUT_EXPERIMENT_DESCRIPTION
-                    "desc='File was read once before the experiment', "
-                    #endif
-                    "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size,
-                    experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
-                free(buffer);
-                fflush(output_file);
             }
         }
+        fclose(fp);
+    }
+}
 
-        // Cached client-side only
+// Apply the hints a reader strategy gives before reading a range: access pattern, or JIT prefetch of the whole range
+static inline void reader_strategy_prepare(enum reader_strategy strategy, int fd, uint64_t offset, uint64_t length){
+    switch(strategy){
+        case READER_STRATEGY_SEQUENTIAL: posix_fadvise(fd, offset, length, POSIX_FADV_SEQUENTIAL); break;
+        case READER_STRATEGY_RANDOM: posix_fadvise(fd, offset, length, POSIX_FADV_RANDOM); break;
+        case READER_STRATEGY_JIT_FADVISE: client_cache_prefetch(fd, offset, length); break;
         #ifdef WITH_LUSTRE
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
+        case READER_STRATEGY_JIT_LADVISE: server_cache_prefetch(fd, offset, length); break;
+        #endif
+        default: break;
+    }
+}
 
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
+// Apply the hints an online reader strategy gives while reading
+static inline void reader_strategy_prefetch(enum reader_strategy strategy, int fd, struct io_uring_engine *engine, uint64_t offset, uint64_t length){
+    switch(strategy){
+        #ifdef WITH_LUSTRE
+        case READER_STRATEGY_ONLINE_LADVISE: server_cache_prefetch(fd, offset, length); break;
+        #endif
+        case READER_STRATEGY_ONLINE_FADVISE: client_cache_prefetch(fd, offset, length); break;
+        case READER_STRATEGY_ONLINE_AIO: aio_prefetch(fd, offset, length); break;
+        case READER_STRATEGY_ONLINE_IO_URING: io_uring_prefetch(engine, offset, length); break;
+        default: break;
+    }
+}
 
-                // Allocating the read buffer
-                char *buffer = malloc(sizeof(char)*io_size);
+// Tell whether a reader strategy prefetches while reading
+static inline bool reader_strategy_is_online(enum reader_strategy strategy){
+    #ifdef WITH_LUSTRE
+    if(strategy==READER_STRATEGY_ONLINE_LADVISE) return true;
+    #endif
+    return strategy==READER_STRATEGY_ONLINE_FADVISE || strategy==READER_STRATEGY_ONLINE_AIO || strategy==READER_STRATEGY_ONLINE_IO_URING;
+}
 
-                // Starting the campaign
-                int experiment_count;
-                uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
+// Body of a reader thread: hint its own region, wait for everyone, then read the region in the current access pattern
+static void *reader_thread_main(void *arg){
+    struct reader_thread *reader = arg;
+    int fd = fileno(reader->fp);
+    char *buffer = malloc(sizeof(char)*reader->io_size);
+    struct access_range *ranges = malloc(sizeof(struct access_range)*(MULTITHREAD_PREFETCH_SIZE/reader->io_size+1));
+    struct io_uring_engine engine;
+    event_trace_thread_start(1+reader->id);
+
+    // Applying the strategy hints to the region of this thread, before everyone starts reading at the same time
+    reader_strategy_prepare(reader->strategy, fd, reader->region_offset, reader->region_size);
+    if(reader->strategy==READER_STRATEGY_OFFLINE_PREFETCH){
+        fseek(reader->fp, reader->region_offset, SEEK_SET);
+        for(size_t volume = 0; volume<reader->region_size; volume+=reader->io_size){
+            int ret = fread(buffer, sizeof(char), reader->io_size, reader->fp);
+            if(__glibc_unlikely(ret < 0)){
+                printf("Error reading file \"%s\": %s\n", target_file_path, strerror(errno));
+                exit(0);
+            }
+        }
+    }
+    if(reader->strategy==READER_STRATEGY_ONLINE_IO_URING) io_uring_engine_init(&engine, fd, IO_URING_QUEUE_DEPTH, IO_URING_BUFFER_SIZE, false);
+    fseek(reader->fp, reader->region_offset, SEEK_SET);
+    pthread_barrier_wait(reader->barrier);
+
+    // Reading the region, and sometimes prefetching!
+    reader->read_duration = 0;
+    struct pacer pacer;
+    pacer_reset(&pacer, reader->io_interarrival_time_ns, reader->region_offset);
+    uint64_t t1 = get_timestamp_us();
+    for(size_t volume = 0; volume<reader->region_size; volume+=reader->io_size){
+        uint64_t offset = reader->region_offset+access_pattern_offset(volume/reader->io_size, reader->region_size, reader->io_size);
+        if(access_pattern!=ACCESS_PATTERN_FORWARD) fseek(reader->fp, offset, SEEK_SET);
+        uint64_t range_count = access_pattern_prefetch_ranges(ranges, volume/reader->io_size, reader->region_size, reader->io_size, MULTITHREAD_PREFETCH_SIZE);
+        for(uint64_t r = 0; r<range_count; r++) reader_strategy_prefetch(reader->strategy, fd, &engine, reader->region_offset+ranges[r].offset, ranges[r].length);
+        uint64_t t2 = pacer_intended_start(&pacer);
+        int ret = fread(buffer, sizeof(char), reader->io_size, reader->fp);
+        latency_histogram_record(&reader->histogram, get_timestamp_ns()-t2);
+        event_trace_record(EVENT_READ, t2, offset, reader->io_size, ret);
+        if(__glibc_unlikely(ret < 0)){
+            printf("Error reading file \"%s\": %s\n", target_file_path, strerror(errno));
+            exit(0);
+        }
+        if(reader->io_interarrival_time_ns!=0){
+            reader->read_duration += get_timestamp_us()-t1;
+            pacer_wait(&pacer);
+            t1 = get_timestamp_us();
+        }
+    }
+    reader->read_duration += get_timestamp_us()-t1;
+    reader->volume = reader->region_size;
 
-                    // Cleaning the cache at the beginning of each experiment
-                    #ifdef WITH_LUSTRE
-                    server_cache_evict(fileno(fp), 0, file_size);
-                    #endif
-                    client_cache_drop(fileno(fp));
-                    // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+    if(reader->strategy==READER_STRATEGY_ONLINE_IO_URING) io_uring_engine_destroy(&engine);
+    event_trace_thread_stop();
+    free(ranges);
+    free(buffer);
+    return NULL;
+}
 
-                    // Running the experimentation once: first a dummy read to have the file in cache, then the instrumented read
-                    fseek(fp, 0, SEEK_SET);
-                    for(size_t volume = 0; volume<file_size; volume+=io_size){
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                            exit(0);
+void perform_multithreaded_benchmark(char *target_file, FILE *output_file){
+    int thread_counts[64];
+    int thread_count_count = get_reader_thread_counts(thread_counts);
+
+    for(int h = 0; h<io_interarrival_time_count; h++){
+        uint64_t io_interarrival_time_ns = io_interarrival_times[h];
+        FILE *fp = fopen(target_file_path, "r");
+
+        for(int s = 0; s<READER_STRATEGY_COUNT; s++){
+            enum reader_strategy strategy = s;
+            bool online = reader_strategy_is_online(strategy);
+
+            for(int i = 0; i<file_size_count; i++){
+                uint64_t file_size = file_sizes[i];
+
+                for(int j = 0; j<io_size_count; j++){
+                    uint64_t io_size = io_sizes[j];
+                    if(io_size>file_size) continue;
+                    if(online && MULTITHREAD_PREFETCH_SIZE<=io_size) continue;
+
+                    for(int k = 0; k<thread_count_count; k++){
+                        int thread_count = thread_counts[k];
+
+                        char strategy_name[64];
+                        snprintf(strategy_name, sizeof(strategy_name), "multithreaded/%s", reader_strategy_names[strategy]);
+                        if(!configuration_selected(strategy_name, file_size)) continue;
+
+                        // Splitting the file in equal regions made of whole I/Os. The tail of the file might be left unread
+                        uint64_t region_size = file_size/thread_count/io_size*io_size;
+                        if(region_size==0) continue;
+
+                        // Each thread gets its own open file description, so that fadvise access patterns do not leak between threads
+                        struct reader_thread *readers = calloc(thread_count, sizeof(struct reader_thread));
+                        pthread_barrier_t barrier;
+                        for(int r = 0; r<thread_count; r++){
+                            readers[r].barrier = &barrier;
+                            readers[r].fp = fopen(target_file_path, "r");
+                            if(readers[r].fp == NULL){
+                                printf("Error opening file \"%s\": %s\n", target_file_path, strerror(errno));
+                                exit(0);
+                            }
+                            readers[r].id = r;
+                            readers[r].strategy = strategy;
+                            readers[r].region_offset = r*region_size;
+                            readers[r].region_size = region_size;
+                            readers[r].io_size = io_size;
+                            readers[r].io_interarrival_time_ns = io_interarrival_time_ns;
                         }
-                    }
-                    server_cache_evict(fileno(fp), 0, file_size);
-                    
-                    fseek(fp, 0, SEEK_SET);
-                    uint64_t t1 = get_timestamp_us();
-                    for(size_t volume = 0; volume<file_size; volume+=io_size){
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                            exit(0);
+
+                        // Starting the campaign. The aggregate throughput is computed against the slowest reader of each experiment
+                        struct residency_record residency;
+                        residency_record_reset(&residency, RESIDENCY_COLD);
+                        int experiment_count;
+                        struct repetition repetition;
+                        repetition_reset(&repetition);
+                        uint64_t read_duration = 0, total_volume = 0;
+                        for(experiment_count=0; repetition_continue(&repetition, total_volume, read_duration); experiment_count++){
+
+                            // Cleaning the cache at the beginning of each experiment
+                            #ifdef WITH_LUSTRE
+                            server_cache_evict(fileno(fp), 0, file_size);
+                            #endif
+                            client_cache_drop(fileno(fp));
+                            // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+
+                            // Running the experimentation once, with all the threads at the same time. Residency is checked before they apply their hints
+                            residency_record_before(&residency, fileno(fp), 0, file_size);
+                            pthread_barrier_init(&barrier, NULL, thread_count);
+                            for(int r = 0; r<thread_count; r++){
+                                int ret = pthread_create(&readers[r].thread, NULL, reader_thread_main, &readers[r]);
+                                if(ret){
+                                    printf("Could not create reader thread: %s\n", strerror(ret));
+                                    exit(0);
+                                }
+                            }
+                            uint64_t slowest_read_duration = 0;
+                            for(int r = 0; r<thread_count; r++){
+                                pthread_join(readers[r].thread, NULL);
+                                readers[r].total_read_duration += readers[r].read_duration;
+                                readers[r].total_volume += readers[r].volume;
+                                total_volume += readers[r].volume;
+                                if(readers[r].read_duration>slowest_read_duration) slowest_read_duration = readers[r].read_duration;
+                            }
+                            pthread_barrier_destroy(&barrier);
+                            read_duration += slowest_read_duration;
+                            residency_record_after(&residency, fileno(fp), 0, file_size);
                         }
-                        if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
+
+                        // Per-thread throughputs over the whole campaign, and latencies of every thread
+                        double min_thread_throughput = INFINITY, max_thread_throughput = 0, mean_thread_throughput = 0;
+                        struct latency_histogram histogram;
+                        latency_histogram_reset(&histogram);
+                        for(int r = 0; r<thread_count; r++){
+                            latency_histogram_merge(&histogram, &readers[r].histogram);
+                            double thread_throughput = readers[r].total_volume/(readers[r].total_read_duration*1e-6)/(1ul << 30);
+                            if(thread_throughput<min_thread_throughput) min_thread_throughput = thread_throughput;
+                            if(thread_throughput>max_thread_throughput) max_thread_throughput = thread_throughput;
+                            mean_thread_throughput += thread_throughput/thread_count;
+                            fclose(readers[r].fp);
                         }
+                        free(readers);
+
+                        fprintf(output_file, "target='%s', category='Multi-threaded', label='%s', "
+                            #if OUTPUT_EXPERIMENT_DESCRIPTION
+                            "desc='The file is split in one region per thread, and each thread applies the strategy to its own region', "
+                            #endif
+                            "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, thread_count=%d, throughput_gb_per_second=%.3f, "
+                            "mean_thread_throughput_gb_per_second=%.3f, min_thread_throughput_gb_per_second=%.3f, max_thread_throughput_gb_per_second=%.3f",
+                            target_file, reader_strategy_labels[strategy], file_size, io_interarrival_time_ns, io_size, thread_count,
+                            total_volume/(read_duration*1e-6)/(1ul << 30), mean_thread_throughput, min_thread_throughput, max_thread_throughput);
+                        arrival_schedule_fprint(output_file, io_interarrival_time_ns);
+                        access_pattern_fprint(output_file);
+                        repetition_fprint(output_file, &repetition);
+                        residency_record_fprint(output_file, &residency);
+                        latency_histogram_fprint(output_file, &histogram);
+                        fflush(output_file);
                     }
-                    read_duration += get_timestamp_us()-t1;
                 }
-                fprintf(output_file, "target='%s', category='Offline prefetch', label='Offline client-side prefetch\\n(sync read + ladvise evict)', "
-                    #if OUTPUT_EXPERIMENT_DESCRIPTION
-                    "desc='File was read once before the experiment, but lla_ladvise was used to evict it from the server cache', "
-                    #endif
-                    "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size,
-                    experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
-                free(buffer);
-                fflush(output_file);
             }
         }
-        #endif
+        fclose(fp);
+    }
+}
 
-        // Cached server-side only (1)
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
+#ifdef WITH_MPI
+// Ranks of an MPI job read the shared file at the same time, each applying the strategy to the I/Os it reads. Cache resets are done
+// once per node, and experiments are timed from a barrier to the next one
+void perform_mpi_benchmark(char *target_file, FILE *output_file){
 
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
+    for(int h = 0; h<io_interarrival_time_count; h++){
+        uint64_t io_interarrival_time_ns = io_interarrival_times[h];
 
-                // Allocating the read buffer
-                char *buffer = malloc(sizeof(char)*io_size);
+        for(int l = 0; l<mpi_layout_count; l++){
+            enum mpi_layout layout = mpi_layouts[l];
 
-                // Starting the campaign
-                int experiment_count;
-                uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
+            for(int s = 0; s<READER_STRATEGY_COUNT; s++){
+                enum reader_strategy strategy = s;
+                bool online = reader_strategy_is_online(strategy);
 
-                    // Cleaning the cache at the beginning of each experiment
-                    #ifdef WITH_LUSTRE
-                    server_cache_evict(fileno(fp), 0, file_size);
-                    #endif
-                    client_cache_drop(fileno(fp));
-                    // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+                for(int i = 0; i<file_size_count; i++){
+                    uint64_t file_size = file_sizes[i];
 
-                    // Running the experimentation once: first a dummy read to have the file in cache, then the instrumented read
-                    fseek(fp, 0, SEEK_SET);
-                    for(size_t volume = 0; volume<file_size; volume+=io_size){
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
+                    for(int j = 0; j<io_size_count; j++){
+                        uint64_t io_size = io_sizes[j];
+                        if(io_size>file_size) continue;
+                        if(online && MPI_PREFETCH_SIZE<=io_size) continue;
+
+                        char strategy_name[64];
+                        snprintf(strategy_name, sizeof(strategy_name), "mpi/%s", reader_strategy_names[strategy]);
+                        if(!configuration_selected(strategy_name, file_size)) continue;
+
+                        // Every rank decides alike, as they all see the same sweep
+                        uint64_t read_count = mpi_layout_read_count(file_size, io_size);
+                        if(read_count==0) continue;
+
+                        // Each rank opens the file on its own, and computes the offsets it reads
+                        FILE *fp = fopen(target_file_path, "r");
+                        if(fp == NULL){
+                            printf("Error opening file \"%s\": %s\n", target_file_path, strerror(errno));
                             exit(0);
                         }
-                    }
-                    client_cache_drop(fileno(fp));
-                    
-                    fseek(fp, 0, SEEK_SET);
-                    uint64_t t1 = get_timestamp_us();
-                    for(size_t volume = 0; volume<file_size; volume+=io_size){
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                            exit(0);
+                        int fd = fileno(fp);
+                        char *buffer = malloc(sizeof(char)*io_size);
+                        uint64_t *offsets = malloc(sizeof(uint64_t)*read_count);
+                        mpi_layout_offsets(offsets, layout, file_size, io_size);
+                        struct access_range *ranges = malloc(sizeof(struct access_range)*(MPI_PREFETCH_SIZE/io_size+1));
+                        struct io_uring_engine engine;
+                        if(strategy==READER_STRATEGY_ONLINE_IO_URING) io_uring_engine_init(&engine, fd, IO_URING_QUEUE_DEPTH, IO_URING_BUFFER_SIZE, false);
+                        struct latency_histogram histogram;
+                        latency_histogram_reset(&histogram);
+                        // Rank 0 checks the residency of the whole file on its node. The offline prefetch warms it all only when the node holds
+                        // every rank and the layout reads every I/O, JIT hints may or may not be done by then, and the others start cold
+                        struct residency_record residency;
+                        enum residency_precondition precondition = RESIDENCY_COLD;
+                        if(strategy==READER_STRATEGY_OFFLINE_PREFETCH) precondition = mpi_node_count==1 && layout!=MPI_LAYOUT_RANDOM ? RESIDENCY_WARM : RESIDENCY_ANY;
+                        #ifdef WITH_LUSTRE
+                        if(strategy==READER_STRATEGY_JIT_LADVISE) precondition = RESIDENCY_ANY;
+                        #endif
+                        if(strategy==READER_STRATEGY_JIT_FADVISE) precondition = RESIDENCY_ANY;
+                        residency_record_reset(&residency, precondition);
+
+                        // Starting the campaign. Rank 0 keeps the totals of the whole job, and every rank its own
+                        int experiment_count;
+                        struct repetition repetition;
+                        repetition_reset(&repetition);
+                        uint64_t read_duration = 0, total_volume = 0;
+                        uint64_t rank_read_duration = 0, rank_volume = 0;
+                        for(experiment_count=0; mpi_repetition_continue(&repetition, total_volume, read_duration); experiment_count++){
+
+                            // Cleaning the cache at the beginning of each experiment, once per node, after every rank is done reading
+                            MPI_Barrier(MPI_COMM_WORLD);
+                            #ifdef WITH_LUSTRE
+                            if(mpi_rank==0) server_cache_evict(fd, 0, file_size);
+                            #endif
+                            if(mpi_node_rank==0) client_cache_drop(fd);
+                            // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+                            MPI_Barrier(MPI_COMM_WORLD);
+
+                            // Applying the strategy hints to the I/Os of this rank, one contiguous run of them at a time
+                            for(uint64_t r = 0; r<read_count;){
+                                uint64_t first = r++;
+                                while(r<read_count && offsets[r]==offsets[r-1]+io_size) r++;
+                                reader_strategy_prepare(strategy, fd, offsets[first], offsets[r-1]+io_size-offsets[first]);
+                                if(strategy==READER_STRATEGY_OFFLINE_PREFETCH){
+                                    fseek(fp, offsets[first], SEEK_SET);
+                                    for(uint64_t o = first; o<r; o++){
+                                        int ret = fread(buffer, sizeof(char), io_size, fp);
+                                        if(__glibc_unlikely(ret < 0)){
+                                            printf("Error reading file \"%s\": %s\n", target_file_path, strerror(errno));
+                                            exit(0);
+                                        }
+                                    }
+                                }
+                            }
+                            fseek(fp, offsets[0], SEEK_SET);
+
+                            // Snapshotting the residency once every rank applied its hints
+                            MPI_Barrier(MPI_COMM_WORLD);
+                            if(mpi_rank==0) residency_record_before(&residency, fd, 0, file_size);
+
+                            // Running the experimentation once, with every rank starting at the same time
+                            struct pacer pacer;
+                            pacer_reset(&pacer, io_interarrival_time_ns, mpi_rank);
+                            uint64_t experiment_read_duration = 0;
+                            MPI_Barrier(MPI_COMM_WORLD);
+                            uint64_t start_us = get_timestamp_us();
+                            uint64_t t1 = start_us;
+                            for(uint64_t r = 0; r<read_count; r++){
+                                uint64_t offset = offsets[r];
+                                if(r>0 && offset!=offsets[r-1]+io_size) fseek(fp, offset, SEEK_SET);
+                                if(online){
+                                    uint64_t range_count = mpi_prefetch_ranges(ranges, offsets, r, read_count, io_size, MPI_PREFETCH_SIZE);
+                                    for(uint64_t g = 0; g<range_count; g++) reader_strategy_prefetch(strategy, fd, &engine, ranges[g].offset, ranges[g].length);
+                                }
+                                uint64_t t2 = pacer_intended_start(&pacer);
+                                int ret = fread(buffer, sizeof(char), io_size, fp);
+                                latency_histogram_record(&histogram, get_timestamp_ns()-t2);
+                                event_trace_record(EVENT_READ, t2, offset, io_size, ret);
+                                if(__glibc_unlikely(ret < 0)){
+                                    printf("Error reading file \"%s\": %s\n", target_file_path, strerror(errno));
+                                    exit(0);
+                                }
+                                if(io_interarrival_time_ns!=0){
+                                    experiment_read_duration += get_timestamp_us()-t1;
+                                    pacer_wait(&pacer);
+                                    t1 = get_timestamp_us();
+                                }
+                            }
+                            experiment_read_duration += get_timestamp_us()-t1;
+                            MPI_Barrier(MPI_COMM_WORLD);
+                            uint64_t phase_duration = get_timestamp_us()-start_us;
+                            if(strategy==READER_STRATEGY_ONLINE_IO_URING) io_uring_engine_drain(&engine);
+                            if(strategy==READER_STRATEGY_ONLINE_AIO) aio_prefetches_cancel(); // Only one rank per node drops the cache
+                            event_trace_flush();
+
+                            // The job throughput covers the whole timed phase, up to the slowest rank, and the rank throughputs their reads only
+                            rank_read_duration += experiment_read_duration;
+                            rank_volume += read_count*io_size;
+                            uint64_t slowest_phase_duration = 0, volume = 0, rank_experiment_volume = read_count*io_size;
+                            MPI_Reduce(&phase_duration, &slowest_phase_duration, 1, MPI_UINT64_T, MPI_MAX, 0, MPI_COMM_WORLD);
+                            MPI_Reduce(&rank_experiment_volume, &volume, 1, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+                            read_duration += slowest_phase_duration;
+                            total_volume += volume;
+                            if(mpi_rank==0) residency_record_after(&residency, fd, 0, file_size);
                         }
-                        if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
+
+                        // Per-rank throughputs over the whole campaign, and latencies of every rank
+                        double rank_throughput = rank_volume/(rank_read_duration*1e-6)/(1ul << 30);
+                        double mean_rank_throughput, min_rank_throughput, max_rank_throughput;
+                        mpi_rank_throughputs_reduce(rank_throughput, &mean_rank_throughput, &min_rank_throughput, &max_rank_throughput);
+                        struct latency_histogram job_histogram;
+                        mpi_latency_histogram_reduce(&job_histogram, &histogram);
+                        if(strategy==READER_STRATEGY_ONLINE_IO_URING) io_uring_engine_destroy(&engine);
+                        free(ranges);
+                        free(offsets);
+                        free(buffer);
+                        fclose(fp);
+
+                        if(mpi_rank==0){
+                            fprintf(output_file, "target='%s', category='MPI', label='%s', "
+                                #if OUTPUT_EXPERIMENT_DESCRIPTION
+                                "desc='The ranks read the file at the same time, each applying the strategy to the I/Os it reads', "
+                                #endif
+                                "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, layout='%s', rank_count=%d, node_count=%d, throughput_gb_per_second=%.3f, "
+                                "mean_rank_throughput_gb_per_second=%.3f, min_rank_throughput_gb_per_second=%.3f, max_rank_throughput_gb_per_second=%.3f",
+                                target_file, reader_strategy_labels[strategy], file_size, io_interarrival_time_ns, io_size, mpi_layout_names[layout], mpi_rank_count,
+                                mpi_node_count, total_volume/(read_duration*1e-6)/(1ul << 30), mean_rank_throughput, min_rank_throughput, max_rank_throughput);
+                            arrival_schedule_fprint(output_file, io_interarrival_time_ns);
+                            repetition_fprint(output_file, &repetition);
+                            residency_record_fprint(output_file, &residency);
+                            latency_histogram_fprint(output_file, &job_histogram);
+                            fflush(output_file);
                         }
                     }
-                    read_duration += get_timestamp_us()-t1;
                 }
-                fprintf(output_file, "target='%s', category='Offline prefetch', label='Offline server-side prefetch\\n(sync read + drop_cache evict)', "
-                    #if OUTPUT_EXPERIMENT_DESCRIPTION
-                    "desc='File was read once before the experiment, but /proc/sys/vm/drop_caches was used to evict it from the client cache', "
-                    #endif
-                    "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size,
-                    experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
-                free(buffer);
-                fflush(output_file);
             }
         }
+    }
+}
 
-        // Cached server-side only (2)
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
-
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
-
-                // Allocating the read buffer
-                char *buffer = malloc(sizeof(char)*io_size);
-
-                // Starting the campaign
-                int experiment_count;
-                uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
+// The same layouts read through MPI-IO instead of POSIX reads, with and without MPI_Info hints. Rows have the columns of the
+// MPI benchmark, so that both can be compared, followed by the hints the MPI-IO implementation applied
+void perform_mpiio_benchmark(char *target_file, FILE *output_file){
 
-                    // Cleaning the cache at the beginning of each experiment
-                    #ifdef WITH_LUSTRE
-                    server_cache_evict(fileno(fp), 0, file_size);
-                    #endif
-                    client_cache_drop(fileno(fp));
-                    // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+    for(int h = 0; h<io_interarrival_time_count; h++){
+        uint64_t io_interarrival_time_ns = io_interarrival_times[h];
 
-                    // Running the experimentation once: first a dummy read to have the file in cache, then the instrumented read
-                    fseek(fp, 0, SEEK_SET);
-                    for(size_t volume = 0; volume<file_size; volume+=io_size){
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
+        for(int l = 0; l<mpi_layout_count; l++){
+            enum mpi_layout layout = mpi_layouts[l];
+
+            for(int s = 0; s<MPIIO_STRATEGY_COUNT; s++){
+                enum mpiio_strategy strategy = s;
+                bool shared = strategy==MPIIO_STRATEGY_SHARED || strategy==MPIIO_STRATEGY_SHARED_HINTS;
+                bool collective = strategy==MPIIO_STRATEGY_COLLECTIVE || strategy==MPIIO_STRATEGY_COLLECTIVE_HINTS;
+                bool hints = strategy==MPIIO_STRATEGY_INDEPENDENT_HINTS || strategy==MPIIO_STRATEGY_SHARED_HINTS || strategy==MPIIO_STRATEGY_COLLECTIVE_HINTS;
+                if(shared && layout!=MPI_LAYOUT_CONTIGUOUS) continue;
+
+                for(int i = 0; i<file_size_count; i++){
+                    uint64_t file_size = file_sizes[i];
+
+                    for(int j = 0; j<io_size_count; j++){
+                        uint64_t io_size = io_sizes[j];
+                        if(io_size>file_size) continue;
+
+                        char strategy_name[64];
+                        snprintf(strategy_name, sizeof(strategy_name), "mpiio/%s", mpiio_strategy_names[strategy]);
+                        if(!configuration_selected(strategy_name, file_size)) continue;
+                        uint64_t read_count = mpi_layout_read_count(file_size, io_size);
+                        if(read_count==0) continue;
+
+                        // The file is opened through MPI-IO for the reads, and with fopen for the cache resets
+                        FILE *fp = fopen(target_file_path, "r");
+                        if(fp == NULL){
+                            printf("Error opening file \"%s\": %s\n", target_file_path, strerror(errno));
                             exit(0);
                         }
-                    }
-                    client_cache_evict(fileno(fp), 0, file_size);
-                    
-                    fseek(fp, 0, SEEK_SET);
-                    uint64_t t1 = get_timestamp_us();
-                    for(size_t volume = 0; volume<file_size; volume+=io_size){
-                        int ret = fread(buffer, sizeof(char), io_size, fp);
-                        if(__glibc_unlikely(ret < 0)){
-                            printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                            exit(0);
+                        int fd = fileno(fp);
+                        MPI_Info info = hints ? mpiio_hints_create(layout) : MPI_INFO_NULL;
+                        MPI_File file;
+                        mpiio_check(MPI_File_open(MPI_COMM_WORLD, target_file_path, MPI_MODE_RDONLY, info, &file), "opening");
+                        if(hints) MPI_Info_free(&info);
+                        char *buffer = malloc(sizeof(char)*io_size);
+                        uint64_t *offsets = malloc(sizeof(uint64_t)*read_count);
+                        mpi_layout_offsets(offsets, layout, file_size, io_size);
+                        struct latency_histogram histogram;
+                        latency_histogram_reset(&histogram);
+                        // None of the MPI-IO strategies reads ahead before the timed phase, so they all start cold
+                        struct residency_record residency;
+                        residency_record_reset(&residency, RESIDENCY_COLD);
+
+                        // Starting the campaign. Rank 0 keeps the totals of the whole job, and every rank its own
+                        int experiment_count;
+                        struct repetition repetition;
+                        repetition_reset(&repetition);
+                        uint64_t read_duration = 0, total_volume = 0;
+                        uint64_t rank_read_duration = 0, rank_volume = 0;
+                        for(experiment_count=0; mpi_repetition_continue(&repetition, total_volume, read_duration); experiment_count++){
+
+                            // Cleaning the cache at the beginning of each experiment, once per node, after every rank is done reading
+                            MPI_Barrier(MPI_COMM_WORLD);
+                            #ifdef WITH_LUSTRE
+                            if(mpi_rank==0) server_cache_evict(fd, 0, file_size);
+                            #endif
+                            if(mpi_node_rank==0) client_cache_drop(fd);
+                            MPI_Barrier(MPI_COMM_WORLD);
+                            if(shared) MPI_File_seek_shared(file, 0, MPI_SEEK_SET);
+
+                            // Snapshotting the residency once every rank is set up, right before the timed phase
+                            MPI_Barrier(MPI_COMM_WORLD);
+                            if(mpi_rank==0) residency_record_before(&residency, fd, 0, file_size);
+
+                            // Running the experimentation once, with every rank starting at the same time
+                            struct pacer pacer;
+                            pacer_reset(&pacer, io_interarrival_time_ns, mpi_rank);
+                            uint64_t experiment_read_duration = 0;
+                            MPI_Barrier(MPI_COMM_WORLD);
+                            uint64_t start_us = get_timestamp_us();
+                            uint64_t t1 = start_us;
+                            for(uint64_t r = 0; r<read_count; r++){
+                                MPI_Status status;
+                                int ret;
+                                uint64_t t2 = pacer_intended_start(&pacer);
+                                if(shared) ret = MPI_File_read_shared(file, buffer, io_size, MPI_BYTE, &status);
+                                else if(collective) ret = MPI_File_read_at_all(file, offsets[r], buffer, io_size, MPI_BYTE, &status);
+                                else ret = MPI_File_read_at(file, offsets[r], buffer, io_size, MPI_BYTE, &status);
+                                latency_histogram_record(&histogram, get_timestamp_ns()-t2);
+                                mpiio_check(ret, "reading");
+                                int count;
+                                MPI_Get_count(&status, MPI_BYTE, &count);
+                                event_trace_record(EVENT_READ, t2, shared ? 0 : offsets[r], io_size, count); // The shared pointer decides the offsets, which are not known
+                                if(io_interarrival_time_ns!=0){
+                                    experiment_read_duration += get_timestamp_us()-t1;
+                                    pacer_wait(&pacer);
+                                    t1 = get_timestamp_us();
+                                }
+                            }
+                            experiment_read_duration += get_timestamp_us()-t1;
+                            MPI_Barrier(MPI_COMM_WORLD);
+                            uint64_t phase_duration = get_timestamp_us()-start_us;
+                            event_trace_flush();
+
+                            // The job throughput covers the whole timed phase, up to the slowest rank, and the rank throughputs their reads only
+                            rank_read_duration += experiment_read_duration;
+                            rank_volume += read_count*io_size;
+                            uint64_t slowest_phase_duration = 0, volume = 0, rank_experiment_volume = read_count*io_size;
+                            MPI_Reduce(&phase_duration, &slowest_phase_duration, 1, MPI_UINT64_T, MPI_MAX, 0, MPI_COMM_WORLD);
+                            MPI_Reduce(&rank_experiment_volume, &volume, 1, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+                            read_duration += slowest_phase_duration;
+                            total_volume += volume;
+                            if(mpi_rank==0) residency_record_after(&residency, fd, 0, file_size);
                         }
-                        if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
+
+                        // Per-rank throughputs over the whole campaign, and latencies of every rank
+                        double rank_throughput = rank_volume/(rank_read_duration*1e-6)/(1ul << 30);
+                        double mean_rank_throughput, min_rank_throughput, max_rank_throughput;
+                        mpi_rank_throughputs_reduce(rank_throughput, &mean_rank_throughput, &min_rank_throughput, &max_rank_throughput);
+                        struct latency_histogram job_histogram;
+                        mpi_latency_histogram_reduce(&job_histogram, &histogram);
+
+                        if(mpi_rank==0){
+                            fprintf(output_file, "target='%s', category='MPI-IO', label='%s', "
+                                #if OUTPUT_EXPERIMENT_DESCRIPTION
+                                "desc='The ranks read the file at the same time through MPI-IO, each reading the I/Os of its layout', "
+                                #endif
+                                "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, layout='%s', rank_count=%d, node_count=%d, throughput_gb_per_second=%.3f, "
+                                "mean_rank_throughput_gb_per_second=%.3f, min_rank_throughput_gb_per_second=%.3f, max_rank_throughput_gb_per_second=%.3f",
+                                target_file, mpiio_strategy_labels[strategy], file_size, io_interarrival_time_ns, io_size, mpi_layout_names[layout], mpi_rank_count,
+                                mpi_node_count, total_volume/(read_duration*1e-6)/(1ul << 30), mean_rank_throughput, min_rank_throughput, max_rank_throughput);
+                            arrival_schedule_fprint(output_file, io_interarrival_time_ns);
+                            mpiio_hints_fprint(output_file, file);
+                            repetition_fprint(output_file, &repetition);
+                            residency_record_fprint(output_file, &residency);
+                            latency_histogram_fprint(output_file, &job_histogram);
+                            fflush(output_file);
                         }
+                        MPI_File_close(&file);
+                        free(offsets);
+                        free(buffer);
+                        fclose(fp);
                     }
-                    read_duration += get_timestamp_us()-t1;
                 }
-                fprintf(output_file, "target='%s', category='Offline prefetch', label='Offline server-side prefetch\\n(sync read + fadvise evict)', "
-                    #if OUTPUT_EXPERIMENT_DESCRIPTION
-                    "desc='File was read once before the experiment, but fadvise was used to evict it from the client cache', "
-                    #endif
-                    "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size,
-                    experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
-                free(buffer);
-                fflush(output_file);
             }
         }
-        fclose(fp);
     }
 }
+#endif
 
-void perform_jit_prefetch_benchmark(char *target_file, FILE *output_file){
+void perform_interposer_benchmark(char *target_file, FILE *output_file){
 
     for(int h = 0; h<io_interarrival_time_count; h++){
         uint64_t io_interarrival_time_ns = io_interarrival_times[h];
-        FILE *fp = fopen(TARGET_FILE, "r");
+        int fd = open(target_file_path, O_RDONLY);
+        if(fd<0){
+            printf("Error opening file \"%s\": %s\n", target_file_path, strerror(errno));
+            exit(0);
+        }
 
-        // JIT prefetched both sides
-        #ifdef WITH_LUSTRE
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
+        // Running the plain reader with each of the interposer hints
+        for(int s = 0; s<INTERPOSER_STRATEGY_COUNT; s++){
+            enum interposer_strategy strategy = s;
 
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
-                
-                for(int k=0; k<jit_prefetch_delay_count; k++){
-                    int prefetch_delay = jit_prefetch_delays[k];
+            for(int i = 0; i<file_size_count; i++){
+                uint64_t file_size = file_sizes[i];
 
-                    // Allocating the read buffer
-                    char *buffer = malloc(sizeof(char)*io_size);
+                for(int j = 0; j<io_size_count; j++){
+                    uint64_t io_size = io_sizes[j];
+                    if(io_size>file_size) continue;
+
+                    if(!configuration_selected(interposer_strategy_names[strategy], file_size)) continue;
+                    struct residency_record residency;
+                    residency_record_reset(&residency, RESIDENCY_COLD);
 
                     // Starting the campaign
                     int experiment_count;
-                    uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                    for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
+                    struct repetition repetition;
+                    repetition_reset(&repetition);
+                    uint64_t read_duration = 0;
+                    for(experiment_count=0; repetition_continue(&repetition, experiment_count*file_size, read_duration); experiment_count++){
 
                         // Cleaning the cache at the beginning of each experiment
                         #ifdef WITH_LUSTRE
-                        server_cache_evict(fileno(fp), 0, file_size);
+                        server_cache_evict(fd, 0, file_size);
                         #endif
-                        client_cache_drop(fileno(fp));
+                        client_cache_drop(fd);
                         // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
 
-                        // Running the experimentation: prefetching, waiting for a bit, then reading!
-                        server_cache_prefetch(fileno(fp), 0, file_size);
-                        client_cache_prefetch(fileno(fp), 0, file_size);
-                        usleep(prefetch_delay);
-                        fseek(fp, 0, SEEK_SET);
+                        // Running the experimentation once: the reader times its reads itself, so process startup is left out
+                        residency_record_before(&residency, fd, 0, file_size);
+                        read_duration += plain_reader_run(strategy, file_size, io_size, io_interarrival_time_ns);
+                        residency_record_after(&residency, fd, 0, file_size);
+                    }
+                    fprintf(output_file, "target='%s', category='Interposer', label='%s', "
+                        #if OUTPUT_EXPERIMENT_DESCRIPTION
+                        "desc='An unmodified reader runs in its own process, with or without the LD_PRELOAD interposer hinting the streams it detects', "
+                        #endif
+                        "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f", target_file, interposer_strategy_labels[strategy], file_size, io_interarrival_time_ns, io_size,
+                        experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
+                    arrival_schedule_fprint(output_file, io_interarrival_time_ns);
+                    access_pattern_fprint(output_file);
+                    repetition_fprint(output_file, &repetition);
+                    residency_record_fprint(output_file, &residency);
+                    fprintf(output_file, "\n");
+                    fflush(output_file);
+                }
+            }
+        }
+        close(fd);
+    }
+}
+
+void perform_trace_replay_benchmark(char *target_file, FILE *output_file){
+    if(trace_file_path==NULL) return;
+
+    // The trace is loaded once, during the dry run that estimates the campaign
+    static struct trace trace;
+    if(trace.records==NULL) trace_load(trace_file_path, &trace);
+
+    int fd = open(target_file_path, O_RDONLY);
+    if(fd<0){
+        printf("Error opening file \"%s\": %s\n", target_file_path, strerror(errno));
+        exit(0);
+    }
+    for(int s = 0; s<READER_STRATEGY_COUNT; s++){
+        enum reader_strategy strategy = s;
+        char strategy_name[64];
+        snprintf(strategy_name, sizeof(strategy_name), "replay/%s", reader_strategy_names[strategy]);
+        if(!configuration_selected(strategy_name, trace.end)) continue;
+
+        // Allocating the read buffer, and the io_uring instance when needed
+        char *buffer = malloc(sizeof(char)*trace.largest_size);
+        struct latency_histogram histogram;
+        latency_histogram_reset(&histogram);
+        struct io_uring_engine engine;
+        if(strategy==READER_STRATEGY_ONLINE_IO_URING) io_uring_engine_init(&engine, fd, IO_URING_QUEUE_DEPTH, IO_URING_BUFFER_SIZE, false);
+
+        // Offline and JIT strategies only warm part of the range the trace touches, so only the other ones have an expected state
+        struct residency_record residency;
+        bool warmed = strategy==READER_STRATEGY_OFFLINE_PREFETCH || strategy==READER_STRATEGY_JIT_FADVISE;
+        #ifdef WITH_LUSTRE
+        warmed = warmed || strategy==READER_STRATEGY_JIT_LADVISE;
+        #endif
+        residency_record_reset(&residency, warmed ? RESIDENCY_ANY : RESIDENCY_COLD);
+
+        // Starting the campaign
+        int experiment_count;
+        struct repetition repetition;
+        repetition_reset(&repetition);
+        uint64_t read_duration = 0, total_volume = 0;
+        for(experiment_count=0; repetition_continue(&repetition, total_volume, read_duration); experiment_count++){
+
+            // Cleaning the cache at the beginning of each experiment
+            #ifdef WITH_LUSTRE
+            server_cache_evict(fd, trace.start, trace.end-trace.start);
+            #endif
+            client_cache_drop(fd);
+            // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+
+            // Running the experimentation once: hinting the range touched by the trace, then replaying it
+            reader_strategy_prepare(strategy, fd, trace.start, trace.end-trace.start);
+            if(strategy==READER_STRATEGY_OFFLINE_PREFETCH){
+                for(uint64_t r = 0; r<trace.record_count; r++){
+                    if(__glibc_unlikely(pread(fd, buffer, trace.records[r].size, trace.records[r].offset) < 0)){
+                        printf("Error reading file \"%s\": %s\n", target_file_path, strerror(errno));
+                        exit(0);
+                    }
+                }
+            }
+            uint64_t window_start = 0, window_end = 0;
+            residency_record_before(&residency, fd, trace.start, trace.end-trace.start);
+            uint64_t replay_start_ns = get_timestamp_ns();
+            uint64_t t1 = get_timestamp_us();
+            for(uint64_t r = 0; r<trace.record_count; r++){
+                struct trace_record *record = &trace.records[r];
+
+                // Honouring the trace timestamps. As with inter arrival times, waiting is not accounted as reading
+                uint64_t due_ns = trace_speed>0 ? replay_start_ns + record->timestamp_ns/trace_speed : 0;
+                if(get_timestamp_ns()<due_ns){
+                    read_duration += get_timestamp_us()-t1;
+                    sleep_until_ns(due_ns);
+                    t1 = get_timestamp_us();
+                }
+
+                // Online strategies prefetch a window starting at the current access whenever an access leaves the previous window
+                if(reader_strategy_is_online(strategy) && (record->offset<window_start || record->offset+record->size>window_end)){
+                    window_start = record->offset;
+                    window_end = record->offset+TRACE_PREFETCH_SIZE;
+                    reader_strategy_prefetch(strategy, fd, &engine, window_start, TRACE_PREFETCH_SIZE);
+                }
+                uint64_t t2 = get_timestamp_ns();
+                if(due_ns!=0 && due_ns<t2) t2 = due_ns; // Late records are timed from their timestamp, like paced reads
+                ssize_t ret = pread(fd, buffer, record->size, record->offset);
+                latency_histogram_record(&histogram, get_timestamp_ns()-t2);
+                event_trace_record(EVENT_READ, t2, record->offset, record->size, ret);
+                if(__glibc_unlikely(ret < 0)){
+                    printf("Error reading file \"%s\": %s\n", target_file_path, strerror(errno));
+                    exit(0);
+                }
+                total_volume += ret;
+            }
+            read_duration += get_timestamp_us()-t1;
+            event_trace_flush();
+            residency_record_after(&residency, fd, trace.start, trace.end-trace.start);
+
+            // Prefetches still in flight must not leak into the next experiment
+            if(strategy==READER_STRATEGY_ONLINE_IO_URING) io_uring_engine_drain(&engine);
+        }
+        if(strategy==READER_STRATEGY_ONLINE_IO_URING) io_uring_engine_destroy(&engine);
+        fprintf(output_file, "target='%s', category='Trace replay', label='%s', "
+            #if OUTPUT_EXPERIMENT_DESCRIPTION
+            "desc='The accesses of a trace are replayed while the strategy hints the range they touch', "
+            #endif
+            "trace='%s', record_count=%llu, trace_speed=%.3f, throughput_gb_per_second=%.3f",
+            target_file, reader_strategy_labels[strategy], trace_file_path, trace.record_count, trace_speed, total_volume/(read_duration*1e-6)/(1ul << 30));
+        repetition_fprint(output_file, &repetition);
+        residency_record_fprint(output_file, &residency);
+        latency_histogram_fprint(output_file, &histogram);
+        free(buffer);
+        fflush(output_file);
+    }
+    close(fd);
+}
+
+void perform_write_hints_benchmark(char *target_file, FILE *output_file){
+    char *write_target = write_target_file_path;
+    if(write_target==NULL){
+        write_target = malloc(strlen(target_file_path)+strlen(WRITE_TARGET_SUFFIX)+1);
+        sprintf(write_target, "%s%s", target_file_path, WRITE_TARGET_SUFFIX);
+    }
+    bool written = false;
+
+    for(int h = 0; h<io_interarrival_time_count; h++){
+        uint64_t io_interarrival_time_ns = io_interarrival_times[h];
+
+        // Writing the scratch file with each of the write strategies
+        for(int s = 0; s<WRITE_STRATEGY_COUNT; s++){
+            enum write_strategy strategy = s;
+
+            for(int i = 0; i<file_size_count; i++){
+                uint64_t file_size = file_sizes[i];
+
+                for(int j = 0; j<io_size_count; j++){
+                    uint64_t io_size = io_sizes[j];
+                    if(io_size>file_size) continue;
+
+                    if(!configuration_selected(write_strategy_names[strategy], file_size)) continue;
+
+                    // Opening the scratch file, readable so that mincore can map it without cachestat. Direct I/Os must cover whole logical blocks
+                    int fd = open(write_target, O_RDWR | O_CREAT | (strategy==WRITE_STRATEGY_O_DIRECT ? O_DIRECT : 0), 0644);
+                    if(fd<0){
+                        printf("Error opening file \"%s\": %s\n", write_target, strerror(errno));
+                        exit(0);
+                    }
+                    written = true;
+                    uint64_t write_size = io_size;
+                    if(strategy==WRITE_STRATEGY_O_DIRECT){
+                        uint64_t block_size = get_logical_block_size(fd);
+                        write_size = (io_size+block_size-1)/block_size*block_size;
+                    }
+
+                    // Writes are write_size apart so that direct ones stay aligned, and the last one may end past the file size
+                    uint64_t experiment_volume = (file_size+write_size-1)/write_size*write_size;
+
+                    // Allocating the aligned write buffer, filled with something else than zeros
+                    char *buffer;
+                    if(posix_memalign((void **)&buffer, sysconf(_SC_PAGESIZE), write_size)){
+                        printf("Could not allocate the write buffer: %s\n", strerror(errno));
+                        exit(0);
+                    }
+                    memset(buffer, 0xa5, write_size);
+                    struct latency_histogram histogram;
+                    latency_histogram_reset(&histogram);
+                    struct write_cache_record cache;
+                    write_cache_record_reset(&cache);
+
+                    // Starting the campaign
+                    int experiment_count;
+                    struct repetition repetition;
+                    repetition_reset(&repetition);
+                    uint64_t write_duration = 0;
+                    for(experiment_count=0; repetition_continue(&repetition, experiment_count*experiment_volume, write_duration); experiment_count++){
+
+                        // Each experiment writes a new file, whose pages are all gone from the page cache with the previous one
+                        if(ftruncate(fd, 0)<0){
+                            printf("Error truncating file \"%s\": %s\n", write_target, strerror(errno));
+                            exit(0);
+                        }
+
+                        // Running the experimentation once: the writes are timed on their own, then the final flush
+                        struct pacer pacer;
+                        pacer_reset(&pacer, io_interarrival_time_ns, 0);
+                        uint64_t window_offset = 0, previous_window_offset = 0, previous_window_length = 0;
                         uint64_t t1 = get_timestamp_us();
-                        for(size_t volume = 0; volume<file_size; volume+=io_size){
-                            int ret = fread(buffer, sizeof(char), io_size, fp);
+                        for(size_t volume = 0; volume<file_size; volume+=write_size){
+                            uint64_t t2 = pacer_intended_start(&pacer);
+                            ssize_t ret = pwrite(fd, buffer, write_size, volume);
+                            latency_histogram_record(&histogram, get_timestamp_ns()-t2);
+                            event_trace_record(EVENT_WRITE, t2, volume, write_size, ret);
                             if(__glibc_unlikely(ret < 0)){
-                                printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
+                                printf("Error writing file \"%s\": %s\n", write_target, strerror(errno));
                                 exit(0);
                             }
+                            if((strategy==WRITE_STRATEGY_WRITE_BEHIND || strategy==WRITE_STRATEGY_DROP_BEHIND) && volume+write_size-window_offset>=WRITE_BEHIND_WINDOW_SIZE){
+                                write_behind(fd, window_offset, volume+write_size-window_offset, previous_window_offset, previous_window_length, strategy==WRITE_STRATEGY_DROP_BEHIND);
+                                previous_window_offset = window_offset;
+                                previous_window_length = volume+write_size-window_offset;
+                                window_offset = volume+write_size;
+                            }
                             if(io_interarrival_time_ns!=0){
-                                read_duration += get_timestamp_us()-t1;
-                                nsleep(io_interarrival_time_ns);
+                                write_duration += get_timestamp_us()-t1;
+                                pacer_wait(&pacer);
                                 t1 = get_timestamp_us();
                             }
                         }
-                        read_duration += get_timestamp_us()-t1;
+                        write_duration += get_timestamp_us()-t1;
+                        write_cache_record_after_write(&cache, fd, 0, experiment_volume);
+                        t1 = get_timestamp_us();
+                        uint64_t start_ns = event_trace_now();
+                        int ret = fdatasync(fd);
+                        event_trace_record(EVENT_FDATASYNC, start_ns, 0, experiment_volume, ret);
+                        if(ret<0){
+                            printf("Error flushing file \"%s\": %s\n", write_target, strerror(errno));
+                            exit(0);
+                        }
+                        if(strategy==WRITE_STRATEGY_DROP_BEHIND) client_cache_evict(fd, previous_window_offset, 0);
+                        cache.sync_duration += get_timestamp_us()-t1;
+                        event_trace_flush();
+                        write_cache_record_after_sync(&cache, fd, 0, experiment_volume);
                     }
-                    fprintf(output_file, "target='%s', category='JIT prefetch', label='JIT fadvise+ladvise prefetch of the whole file', "
+                    close(fd);
+                    fprintf(output_file, "target='%s', category='Write hints', label='%s', "
                         #if OUTPUT_EXPERIMENT_DESCRIPTION
-                        "desc='File was prefetched to the server page cache using llu_ladvise and to the client page cache using fadvise %d seconds before the reading started', "
+                        "desc='A new file is written with the hints of the strategy, then flushed with fdatasync', "
                         #endif
-                        "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, prefetch_delay=%d, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size, prefetch_delay,
-                        prefetch_delay, experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
+                        "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, throughput_gb_per_second=%.3f", write_target, write_strategy_labels[strategy], file_size, io_interarrival_time_ns, io_size,
+                        experiment_count*experiment_volume/(write_duration*1e-6)/(1ul << 30));
+                    arrival_schedule_fprint(output_file, io_interarrival_time_ns);
+                    repetition_fprint(output_file, &repetition);
+                    write_cache_record_fprint(output_file, &cache, experiment_count*experiment_volume, write_duration);
+                    latency_histogram_fprint(output_file, &histogram);
                     free(buffer);
                     fflush(output_file);
                 }
             }
         }
+    }
+
+    // The scratch file is only useful while it is being written
+    if(written) unlink(write_target);
+    if(write_target!=write_target_file_path) free(write_target);
+}
+
+// Run every benchmark of this binary. In dry-run mode, configurations are only counted
+static void perform_campaign(FILE *output_file){
+    configuration_count = 0;
+
+    // MPI builds only run the MPI benchmark, the others being single-process ones
+    #ifdef WITH_MPI
+    access_pattern = ACCESS_PATTERN_FORWARD;
+    interleaved_stream_count = 1;
+    perform_mpi_benchmark(target_file_path, output_file);
+    perform_mpiio_benchmark(target_file_path, output_file);
+    #else
+    for(int p = 0; p<access_pattern_count; p++){
+        access_pattern = access_patterns[p];
+        int stream_count_count = access_pattern==ACCESS_PATTERN_INTERLEAVED ? interleaved_stream_count_count : 1;
+        for(int c = 0; c<stream_count_count; c++){
+            interleaved_stream_count = access_pattern==ACCESS_PATTERN_INTERLEAVED ? interleaved_stream_counts[c] : 1;
+            perform_registered_benchmark(target_file_path, output_file);
+            perform_online_prefetch_benchmark(target_file_path, output_file);
+            perform_mmap_benchmark(target_file_path, output_file);
+            perform_multithreaded_benchmark(target_file_path, output_file);
+            perform_interposer_benchmark(target_file_path, output_file);
+        }
+    }
+
+    // Replayed traces come with their own access pattern, and writes always go forward
+    perform_trace_replay_benchmark(target_file_path, output_file);
+    perform_write_hints_benchmark(target_file_path, output_file);
+    #endif
+}
+
+int main(int argc, char **argv){
+    parse_arguments(argc, argv);
+    uint64_t largest_file_size = 0;
+    for(int i = 0; i<file_size_count; i++) if(file_sizes[i]>largest_file_size) largest_file_size = file_sizes[i];
+
+    // Generator mode: only create a target file big enough for the largest file size
+    if(generate_target){
+        generate_target_file(target_file_path, largest_file_size);
+        return 0;
+    }
+
+    // Plain reader mode, run by the interposer strategies
+    if(plain_reader){
+        perform_plain_read();
+        return 0;
+    }
+
+    #ifdef WITH_MPI
+    mpi_start(&argc, &argv);
+    #endif
+
+    // Combinations needing more data than the target file holds are skipped, so we need its size
+    struct stat st;
+    if(stat(target_file_path, &st)<0){
+        printf("Error opening file \"%s\": %s\n", target_file_path, strerror(errno));
+        exit(0);
+    }
+    target_file_size = st.st_size;
+    if(largest_file_size>target_file_size && mpi_rank==0){
+        printf("\"%s\" only holds %.3f GB, so file sizes above that are skipped. Use --generate to create a big enough one\n", target_file_path,
+            target_file_size/(double)(1ul << 30));
+    }
+
+    // Holes are read as zeros without touching the disk, which would inflate read throughputs
+    uint64_t tested_size = largest_file_size<target_file_size ? largest_file_size : target_file_size;
+    int fd = open(target_file_path, O_RDONLY);
+    off_t hole = fd<0 ? -1 : lseek(fd, 0, SEEK_HOLE);
+    if(fd>=0) close(fd);
+    if(hole>=0 && (uint64_t)hole<tested_size){
+        printf("\"%s\" is sparse: only its first %.3f GB out of %.3f GB are allocated. Use --generate to fill it\n", target_file_path,
+            hole/(double)(1ul << 30), tested_size/(double)(1ul << 30));
+        exit(0);
+    }
+
+    // Estimating the campaign duration, and shrinking the duration of each configuration to fit in the budget
+    bool list_only = dry_run;
+    dry_run = true;
+    perform_campaign(NULL);
+    dry_run = list_only;
+    if(configuration_count==0){
+        printf("No configuration left to run: check the selected strategies and that \"%s\" is big enough\n", target_file_path);
+        exit(0);
+    }
+    planned_configuration_count = configuration_count;
+    requested_duration_us = duration_per_experiment_us;
+    if(campaign_budget_us!=0 && configuration_count*duration_per_experiment_us>campaign_budget_us){
+        duration_per_experiment_us = campaign_budget_us/configuration_count;
+        if(duration_per_experiment_us==0) duration_per_experiment_us = 1;
+        if(mpi_rank==0) printf("Shrinking the duration of each configuration to %.3f s to fit in the campaign budget\n", duration_per_experiment_us*1e-6);
+    }
+    uint64_t estimate_s = configuration_count*duration_per_experiment_us/(uint64_t)1e6;
+    // Only an approximation: the cache drops and the preparation of each experiment are not counted, while the confidence
+    // interval can end the repetitions early. The budget, when there is one, is what caps the campaign
+    if(mpi_rank==0) printf("Campaign: %llu configurations x %.3f s, estimated to take about %lluh%02llum%02llus%s\n", configuration_count,
+        duration_per_experiment_us*1e-6, estimate_s/3600, estimate_s/60%60, estimate_s%60, campaign_budget_us!=0 ? ", capped by the budget" : "");
+    if(dry_run){
+        #ifdef WITH_MPI
+        MPI_Finalize();
         #endif
-        
-        // JIT prefetched client-side
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
+        return 0;
+    }
 
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
-                
-                for(int k=0; k<jit_prefetch_delay_count; k++){
-                    int prefetch_delay = jit_prefetch_delays[k];
+    // Only rank 0 writes the output file, and every rank its own event trace
+    FILE *log_file = NULL;
+    if(mpi_rank==0){
+        log_file = fopen(output_file_path, "w");
+        if(log_file == NULL){
+            printf("Error opening file \"%s\": %s\n", output_file_path, strerror(errno));
+            exit(0);
+        }
+    }
+    if(event_trace_path && mpi_rank_count>1){
+        char *rank_event_trace_path;
+        asprintf(&rank_event_trace_path, "%s.%d", event_trace_path, mpi_rank);
+        event_trace_path = rank_event_trace_path;
+    }
+    if(event_trace_path) event_trace_open(event_trace_path);
+    campaign_start_us = get_timestamp_us();
+    perform_campaign(log_file);
+    if(event_trace_path) event_trace_close();
+    if(log_file) fclose(log_file);
+    #ifdef WITH_MPI
+    MPI_Finalize();
+    #endif
+    if(budget_skipped_count>0 && mpi_rank==0) printf("%llu configurations were skipped, the campaign budget being spent\n", budget_skipped_count);
+    if(cache_drop_fallback_count>0) printf("%llu of the %llu cache resets could not evict the file alone, and dropped the whole page cache\n", cache_drop_fallback_count, cache_drop_count);
+}
+
+// Used for throughput instrumentation 
+static inline uint64_t get_timestamp_us(){
+    return get_timestamp_ns()/1000;
+}
+
+// Evict a file from the client page cache, falling back to /proc/sys/vm/drop_caches only when some of it stays resident
+static inline void client_cache_drop(int fd){
+
+    // Asynchronous prefetches still in flight would bring the file back
+    aio_prefetches_cancel();
+
+    // Dirty pages cannot be evicted, and pages still being read by a previous prefetch may come back: a few attempts are made
+    cache_drop_count++;
+    fdatasync(fd);
+    // An eviction that cannot be verified is not trusted, and the whole page cache is dropped instead
+    for(int attempt = 0; attempt<CACHE_EVICT_ATTEMPTS; attempt++){
+        client_cache_evict(fd, 0, 0);
+        uint64_t resident_pages = client_cache_resident_pages(fd, 0, 0);
+        if(resident_pages==0) return;
+        if(resident_pages==RESIDENT_PAGES_UNKNOWN) break;
+    }
+    cache_drop_fallback_count++;
+    client_cache_drop_global(fd);
+}
+
+// Use /proc/sys/vm/drop_caches to drop the whole client page cache 
+static inline void client_cache_drop_global(int fd){
+    sync();
+    char *data = "3";
+    int fd2 = open("/proc/sys/vm/drop_caches", O_WRONLY);
+    if(fd2<0){
+        printf("Could not open file \"/proc/sys/vm/drop_caches\": %s\n", strerror(errno));
+        exit(0);
+    }
+    int ret = write(fd2, data, sizeof(char));
+    if(ret<0){
+        printf("Could not write in file \"/proc/sys/vm/drop_caches\": %s\n", strerror(errno));
+        exit(0);
+    }
+    close(fd2);
+
+    #ifndef WITH_LUSTRE
+    char *buffer = malloc(SECONDARY_IO_SIZE);
+    for(int i = 0; i<SECONDARY_IO_COUNT; i++){
+        read(fd, buffer, SECONDARY_IO_SIZE);
+    }
+    free(buffer);
+    #endif
+    sync();
+}
+
+// Use fadvise to evict some data from the client page cache 
+static inline void client_cache_evict(int fd, uint64_t offset, uint64_t length){
+    iohints_client_evict(fd, offset, length);
+}
+
+// Count the pages of a range that are resident in the client page cache, using cachestat or mincore on older kernels. A length of 0 means up to the end of the file.
+// Returns RESIDENT_PAGES_UNKNOWN when they could not be counted
+static inline uint64_t client_cache_resident_pages(int fd, uint64_t offset, uint64_t length){
+    struct cachestat_range range = {offset, length};
+    struct cachestat stat;
+    if(syscall(__NR_cachestat, fd, &range, &stat, 0)==0) return stat.nr_cache;
+
+    // mincore only works on mappings, which must start on a page boundary
+    struct stat file_stat;
+    if(fstat(fd, &file_stat)<0) return RESIDENT_PAGES_UNKNOWN;
+    if(offset>=(uint64_t)file_stat.st_size) return 0;
+    if(length==0 || offset+length>(uint64_t)file_stat.st_size) length = file_stat.st_size-offset;
+    uint64_t page_size = sysconf(_SC_PAGESIZE);
+    uint64_t map_offset = offset/page_size*page_size, map_length = offset+length-map_offset;
+    uint64_t page_count = (map_length+page_size-1)/page_size, resident_pages = 0;
+    char *mapping = mmap(NULL, map_length, PROT_READ, MAP_SHARED, fd, map_offset);
+    if(mapping==MAP_FAILED) return RESIDENT_PAGES_UNKNOWN;
+    unsigned char *residency = malloc(page_count);
+    if(mincore(mapping, map_length, residency)==0){
+        for(uint64_t i = 0; i<page_count; i++) resident_pages += residency[i]&1;
+    }
+    else resident_pages = RESIDENT_PAGES_UNKNOWN;
+    free(residency);
+    munmap(mapping, map_length);
+    return resident_pages;
+}
+
+// Use lla_ladvise to evict some data from the server page cache
+#ifdef WITH_LUSTRE
+static inline void server_cache_evict(int fd, uint64_t offset, uint64_t length){
+    aio_prefetches_cancel();
+    iohints_server_evict(fd, offset, length);
+}
+#endif
+
+// Use fadvise to prefetch some data to the client page cache  
+static inline void client_cache_prefetch(int fd, uint64_t offset, uint64_t length){
+    uint64_t start_ns = event_trace_now();
+    int ret = iohints_client_prefetch(fd, offset, length);
+    event_trace_record(EVENT_HINT_FADVISE, start_ns, offset, length, ret);
+}
+
+// Use lla_ladvise to prefetch some data to the server page cache
+#ifdef WITH_LUSTRE
+static inline void server_cache_prefetch(int fd, uint64_t offset, uint64_t length){
+    uint64_t start_ns = event_trace_now();
+    int ret = iohints_server_prefetch(fd, offset, length);
+    event_trace_record(EVENT_HINT_LADVISE, start_ns, offset, length, ret);
+}
+#endif
+
+// Use asynchronous I/O to forcefully prefetch some data. The handle is kept, so that the prefetch can be cancelled before the next cache drop
+static inline void aio_prefetch(int fd, uint64_t offset, uint64_t length){
+    pthread_mutex_lock(&aio_prefetch_mutex);
+    if(aio_prefetch_count==IOHINTS_PREFETCH_MAX_REQUESTS) aio_prefetches_reap();
+    struct iohints_prefetch *prefetch;
+    uint64_t start_ns = event_trace_now();
+    int ret = iohints_aio_prefetch(fd, offset, length, &prefetch);
+    event_trace_record(EVENT_HINT_AIO, start_ns, offset, length, ret);
+    if(ret==0) aio_prefetches[aio_prefetch_count++] = prefetch;
+    pthread_mutex_unlock(&aio_prefetch_mutex);
+}
+
+// Give back the handles of the asynchronous prefetches that are over, or wait for the oldest one when none is. Called with aio_prefetch_mutex held
+static inline void aio_prefetches_reap(){
+    int kept_count = 0;
+    for(int p = 0; p<aio_prefetch_count; p++){
+        if(iohints_prefetch_poll(aio_prefetches[p])==EINPROGRESS) aio_prefetches[kept_count++] = aio_prefetches[p];
+        else iohints_prefetch_release(aio_prefetches[p]);
+    }
+    aio_prefetch_count = kept_count;
+    if(aio_prefetch_count==IOHINTS_PREFETCH_MAX_REQUESTS){
+        iohints_prefetch_wait(aio_prefetches[0]);
+        iohints_prefetch_release(aio_prefetches[0]);
+        memmove(aio_prefetches, aio_prefetches+1, sizeof(struct iohints_prefetch *)*--aio_prefetch_count);
+    }
+}
+
+// Cancel the asynchronous prefetches still in flight and wait for them to be over
+static inline void aio_prefetches_cancel(){
+    pthread_mutex_lock(&aio_prefetch_mutex);
+    for(int p = 0; p<aio_prefetch_count; p++) iohints_prefetch_cancel(aio_prefetches[p]);
+    for(int p = 0; p<aio_prefetch_count; p++){
+        iohints_prefetch_wait(aio_prefetches[p]);
+        iohints_prefetch_release(aio_prefetches[p]);
+    }
+    aio_prefetch_count = 0;
+    pthread_mutex_unlock(&aio_prefetch_mutex);
+}
+
+// Create an io_uring instance, register buffer_count aligned buffers of buffer_size bytes and the target file descriptor
+static inline void io_uring_engine_init(struct io_uring_engine *engine, int fd, unsigned buffer_count, uint64_t buffer_size, bool sqpoll){
+    memset(engine, 0, sizeof(struct io_uring_engine));
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(struct io_uring_params));
+    if(sqpoll){
+        params.flags |= IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = IO_URING_SQPOLL_IDLE_MS;
+    }
+    engine->ring_fd = syscall(__NR_io_uring_setup, buffer_count, &params);
+    if(engine->ring_fd<0){
+        printf("Could not create io_uring instance: %s\n", strerror(errno));
+        exit(0);
+    }
+    engine->sqpoll = sqpoll;
+    engine->entries = params.sq_entries;
+
+    // Mapping the submission and completion rings, which share a single mapping on recent kernels
+    engine->sq_ring_size = params.sq_off.array + params.sq_entries*sizeof(unsigned);
+    engine->cq_ring_size = params.cq_off.cqes + params.cq_entries*sizeof(struct io_uring_cqe);
+    if(params.features & IORING_FEAT_SINGLE_MMAP){
+        if(engine->cq_ring_size > engine->sq_ring_size) engine->sq_ring_size = engine->cq_ring_size;
+        engine->cq_ring_size = engine->sq_ring_size;
+    }
+    engine->sq_ring = mmap(0, engine->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, engine->ring_fd, IORING_OFF_SQ_RING);
+    if(engine->sq_ring == MAP_FAILED){
+        printf("Could not map io_uring submission ring: %s\n", strerror(errno));
+        exit(0);
+    }
+    if(params.features & IORING_FEAT_SINGLE_MMAP){
+        engine->cq_ring = engine->sq_ring;
+    }else{
+        engine->cq_ring = mmap(0, engine->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, engine->ring_fd, IORING_OFF_CQ_RING);
+        if(engine->cq_ring == MAP_FAILED){
+            printf("Could not map io_uring completion ring: %s\n", strerror(errno));
+            exit(0);
+        }
+    }
+    engine->sqes = mmap(0, params.sq_entries*sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, engine->ring_fd, IORING_OFF_SQES);
+    if(engine->sqes == MAP_FAILED){
+        printf("Could not map io_uring submission entries: %s\n", strerror(errno));
+        exit(0);
+    }
+    engine->sq_head = engine->sq_ring + params.sq_off.head;
+    engine->sq_tail = engine->sq_ring + params.sq_off.tail;
+    engine->sq_mask = engine->sq_ring + params.sq_off.ring_mask;
+    engine->sq_flags = engine->sq_ring + params.sq_off.flags;
+    engine->sq_array = engine->sq_ring + params.sq_off.array;
+    engine->cq_head = engine->cq_ring + params.cq_off.head;
+    engine->cq_tail = engine->cq_ring + params.cq_off.tail;
+    engine->cq_mask = engine->cq_ring + params.cq_off.ring_mask;
+    engine->cqes = engine->cq_ring + params.cq_off.cqes;
+
+    // Registering the buffers and the file, so that the kernel does not have to pin pages and take file references on every read.
+    // Buffers are page aligned, which also satisfies the logical block size alignment required by O_DIRECT
+    engine->buffer_count = buffer_count;
+    engine->buffer_size = buffer_size;
+    engine->buffers = malloc(sizeof(struct iovec)*buffer_count);
+    for(unsigned i = 0; i<buffer_count; i++){
+        if(posix_memalign(&engine->buffers[i].iov_base, sysconf(_SC_PAGESIZE), buffer_size)){
+            printf("Could not allocate io_uring buffer: %s\n", strerror(errno));
+            exit(0);
+        }
+        engine->buffers[i].iov_len = buffer_size;
+    }
+    if(syscall(__NR_io_uring_register, engine->ring_fd, IORING_REGISTER_BUFFERS, engine->buffers, buffer_count)<0){
+        printf("Could not register io_uring buffers: %s\n", strerror(errno));
+        exit(0);
+    }
+    if(syscall(__NR_io_uring_register, engine->ring_fd, IORING_REGISTER_FILES, &fd, 1)<0){
+        printf("Could not register file in io_uring: %s\n", strerror(errno));
+        exit(0);
+    }
+}
+
+// Unregister everything and tear down the io_uring instance
+static inline void io_uring_engine_destroy(struct io_uring_engine *engine){
+    io_uring_engine_drain(engine);
+    syscall(__NR_io_uring_register, engine->ring_fd, IORING_UNREGISTER_FILES, NULL, 0);
+    syscall(__NR_io_uring_register, engine->ring_fd, IORING_UNREGISTER_BUFFERS, NULL, 0);
+    munmap(engine->sqes, engine->entries*sizeof(struct io_uring_sqe));
+    if(engine->cq_ring != engine->sq_ring) munmap(engine->cq_ring, engine->cq_ring_size);
+    munmap(engine->sq_ring, engine->sq_ring_size);
+    close(engine->ring_fd);
+    for(unsigned i = 0; i<engine->buffer_count; i++) free(engine->buffers[i].iov_base);
+    free(engine->buffers);
+}
+
+// Block in io_uring_enter until at least min_complete completions are available
+static inline void io_uring_engine_enter_wait(struct io_uring_engine *engine, unsigned min_complete){
+    int ret = syscall(__NR_io_uring_enter, engine->ring_fd, 0, min_complete, IORING_ENTER_GETEVENTS, NULL, 0);
+    if(ret<0 && errno!=EINTR){
+        printf("Could not wait for io_uring completions: %s\n", strerror(errno));
+        exit(0);
+    }
+}
+
+// Consume the available completions without looking at them, blocking until at least min_complete of them were seen
+static inline void io_uring_engine_reap(struct io_uring_engine *engine, unsigned min_complete){
+    unsigned reaped = 0;
+    for(;;){
+        unsigned head = *engine->cq_head;
+        unsigned tail = __atomic_load_n(engine->cq_tail, __ATOMIC_ACQUIRE);
+        reaped += tail-head;
+        engine->inflight -= tail-head;
+        __atomic_store_n(engine->cq_head, tail, __ATOMIC_RELEASE);
+        if(reaped>=min_complete || engine->inflight==0) return;
+        io_uring_engine_enter_wait(engine, min_complete-reaped);
+    }
+}
+
+// Wait for a single completion and consume it
+static inline void io_uring_engine_wait(struct io_uring_engine *engine, struct io_uring_cqe *cqe){
+    for(;;){
+        unsigned head = *engine->cq_head;
+        if(head != __atomic_load_n(engine->cq_tail, __ATOMIC_ACQUIRE)){
+            *cqe = engine->cqes[head & *engine->cq_mask];
+            __atomic_store_n(engine->cq_head, head+1, __ATOMIC_RELEASE);
+            engine->inflight--;
+            return;
+        }
+        io_uring_engine_enter_wait(engine, 1);
+    }
+}
+
+// Hand the queued reads over to the kernel, either directly or by waking up the SQ polling thread
+static inline void io_uring_engine_submit(struct io_uring_engine *engine){
+    unsigned flags = 0;
+    if(engine->sqpoll){
+        if(!(__atomic_load_n(engine->sq_flags, __ATOMIC_ACQUIRE) & IORING_SQ_NEED_WAKEUP)){
+            engine->queued = 0;
+            return;
+        }
+        flags |= IORING_ENTER_SQ_WAKEUP;
+    }
+    int ret = syscall(__NR_io_uring_enter, engine->ring_fd, engine->sqpoll ? 0 : engine->queued, 0, flags, NULL, 0);
+    if(ret<0){
+        printf("Could not submit io_uring reads: %s\n", strerror(errno));
+        exit(0);
+    }
+    engine->queued = 0;
+}
+
+// Queue a read of the registered file into a registered buffer. The buffer index is given back as the completion user_data
+static inline void io_uring_engine_queue_read(struct io_uring_engine *engine, unsigned buffer_index, uint64_t offset, uint64_t length){
+
+    // The SQ ring is full: handing it over to the kernel before queuing more
+    unsigned tail = *engine->sq_tail;
+    if(tail-__atomic_load_n(engine->sq_head, __ATOMIC_ACQUIRE) >= engine->entries){
+        io_uring_engine_submit(engine);
+        while(tail-__atomic_load_n(engine->sq_head, __ATOMIC_ACQUIRE) >= engine->entries) io_uring_engine_reap(engine, 1);
+    }
+
+    unsigned index = tail & *engine->sq_mask;
+    struct io_uring_sqe *sqe = &engine->sqes[index];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    sqe->opcode = IORING_OP_READ_FIXED;
+    sqe->flags = IOSQE_FIXED_FILE;
+    sqe->fd = 0; // Index in the registered files table
+    sqe->off = offset;
+    sqe->buf_index = buffer_index;
+    sqe->addr = (uint64_t)engine->buffers[buffer_index].iov_base;
+    sqe->len = length;
+    sqe->user_data = buffer_index;
+    engine->sq_array[index] = index;
+    __atomic_store_n(engine->sq_tail, tail+1, __ATOMIC_RELEASE);
+    engine->queued++;
+    engine->inflight++;
+}
+
+// Wait for every in-flight read to complete
+static inline void io_uring_engine_drain(struct io_uring_engine *engine){
+    if(engine->queued>0) io_uring_engine_submit(engine);
+    while(engine->inflight>0) io_uring_engine_reap(engine, engine->inflight);
+}
+
+// Run the experiments of a configuration of a registered strategy, and print its row
+static void registered_strategy_run(const struct iohints_strategy *strategy, struct iohints_strategy_run *run, char *target_file, FILE *output_file, uint64_t io_size, uint64_t io_interarrival_time_ns){
+    bool prefetch_size_sweep = (strategy->flags & IOHINTS_STRATEGY_PREFETCH_SIZES)!=0;
+    bool prefetch_delay_sweep = (strategy->flags & IOHINTS_STRATEGY_PREFETCH_DELAYS)!=0;
+    bool direct_io = (strategy->flags & IOHINTS_STRATEGY_DIRECT_IO)!=0;
+    uint64_t file_size = run->file_size;
+
+    // Opening the file for this configuration only, so that the advice a strategy gives does not outlive it
+    FILE *fp = NULL;
+    if(direct_io) run->fd = open(target_file_path, O_RDONLY | O_DIRECT);
+    else if((fp = fopen(target_file_path, "r"))) run->fd = fileno(fp);
+    if(run->fd<0){
+        printf("Error opening file \"%s\"%s: %s\n", target_file_path, direct_io ? " with O_DIRECT" : "", strerror(errno));
+        exit(0);
+    }
+
+    // Computing the offsets of the reads for the strategy to know them
+    run->read_count = (file_size+run->io_size-1)/run->io_size;
+    uint64_t *offsets = malloc(sizeof(uint64_t)*run->read_count);
+    for(uint64_t r = 0; r<run->read_count; r++) offsets[r] = access_pattern_offset(r, file_size, run->io_size);
+    run->offsets = offsets;
+    if(strategy->prepare && strategy->prepare(run)!=0){
+        free(offsets);
+        if(fp) fclose(fp);
+        else close(run->fd);
+        return;
+    }
+
+    // Allocating the read buffer, or for direct reads the aligned buffer pool: one registered buffer per read in flight
+    char *buffer = NULL;
+    struct io_uring_engine engine;
+    uint64_t *submit_times = NULL, *submit_offsets = NULL;
+    if(direct_io){
+        io_uring_engine_init(&engine, run->fd, run->queue_depth, run->io_size, false);
+        submit_times = malloc(sizeof(uint64_t)*run->queue_depth);
+        submit_offsets = malloc(sizeof(uint64_t)*run->queue_depth);
+    }
+    else buffer = malloc(sizeof(char)*run->io_size);
+    struct latency_histogram histogram;
+    latency_histogram_reset(&histogram);
+    struct residency_record residency;
+    residency_record_reset(&residency, (strategy->flags & IOHINTS_STRATEGY_CACHED) ? RESIDENCY_WARM : prefetch_delay_sweep ? RESIDENCY_ANY : RESIDENCY_COLD);
+    struct residency_sampler sampler;
+    residency_sampler_reset(&sampler);
+
+    // Starting the campaign
+    int experiment_count;
+    struct repetition repetition;
+    repetition_reset(&repetition);
+    uint64_t read_duration = 0;
+    for(experiment_count=0; repetition_continue(&repetition, experiment_count*file_size, read_duration); experiment_count++){
+
+        // Cleaning the cache at the beginning of each experiment
+        #ifdef WITH_LUSTRE
+        server_cache_evict(run->fd, 0, file_size);
+        #endif
+        client_cache_drop(run->fd);
+        // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+
+        // Letting the strategy load the file and evict some of it, then waiting for a bit. A side thread follows the prefetches
+        // given that time meanwhile
+        if(prefetch_delay_sweep) residency_sampler_start(&sampler, run->fd, file_size, run->io_size);
+        if(strategy->prefetch) strategy->prefetch(run);
+        if(strategy->evict) strategy->evict(run);
+        if(prefetch_delay_sweep) usleep(run->prefetch_delay);
+
+        // Running the experimentation: reading, and letting the strategy hint before each read
+        if(fp) fseek(fp, 0, SEEK_SET);
+        residency_record_before(&residency, run->fd, 0, file_size);
+        if(prefetch_delay_sweep) residency_sampler_reader_start(&sampler);
+        struct pacer pacer;
+        pacer_reset(&pacer, io_interarrival_time_ns, 0);
+        uint64_t t1 = get_timestamp_us();
+        if(strategy->pre_read) strategy->pre_read(run);
+        if(direct_io){
+
+            // Filling the queue, then issuing a new read each time one completes
+            uint64_t next_read = 0;
+            for(unsigned b = 0; b<run->queue_depth && next_read<run->read_count; b++, next_read++){
+                if(strategy->on_read) strategy->on_read(run, next_read, offsets[next_read], run->io_size);
+                submit_times[b] = get_timestamp_ns();
+                submit_offsets[b] = offsets[next_read];
+                io_uring_engine_queue_read(&engine, b, offsets[next_read], run->io_size);
+            }
+            io_uring_engine_submit(&engine);
+            while(engine.inflight>0){
+                struct io_uring_cqe cqe;
+                io_uring_engine_wait(&engine, &cqe);
+                latency_histogram_record(&histogram, get_timestamp_ns()-submit_times[cqe.user_data]);
+                event_trace_record(EVENT_READ, submit_times[cqe.user_data], submit_offsets[cqe.user_data], run->io_size, cqe.res);
+                if(__glibc_unlikely(cqe.res < 0)){
+                    printf("Error reading file \"%s\": %s\n", target_file_path, strerror(-cqe.res));
+                    exit(0);
+                }
+                if(next_read>=run->read_count) continue;
+                if(io_interarrival_time_ns!=0){
+                    read_duration += get_timestamp_us()-t1;
+                    pacer_wait(&pacer);
+                    t1 = get_timestamp_us();
+                }
+                if(strategy->on_read) strategy->on_read(run, next_read, offsets[next_read], run->io_size);
+                submit_times[cqe.user_data] = pacer_intended_start(&pacer);
+                submit_offsets[cqe.user_data] = offsets[next_read];
+                io_uring_engine_queue_read(&engine, cqe.user_data, offsets[next_read++], run->io_size);
+                io_uring_engine_submit(&engine);
+            }
+        }
+        else{
+            for(uint64_t r = 0; r<run->read_count; r++){
+                uint64_t offset = offsets[r];
+                if(access_pattern!=ACCESS_PATTERN_FORWARD) fseek(fp, offset, SEEK_SET);
+                if(strategy->on_read) strategy->on_read(run, r, offset, run->io_size);
+                uint64_t t2 = pacer_intended_start(&pacer);
+                int ret = fread(buffer, sizeof(char), run->io_size, fp);
+                latency_histogram_record(&histogram, get_timestamp_ns()-t2);
+                event_trace_record(EVENT_READ, t2, offset, run->io_size, ret);
+                if(prefetch_delay_sweep) residency_sampler_progress(&sampler, access_pattern_offset(r+1, file_size, run->io_size));
+                if(__glibc_unlikely(ret < 0)){
+                    printf("Error reading file \"%s\": %s\n", target_file_path, strerror(errno));
+                    exit(0);
+                }
+                if(io_interarrival_time_ns!=0){
+                    read_duration += get_timestamp_us()-t1;
+                    pacer_wait(&pacer);
+                    t1 = get_timestamp_us();
+                }
+            }
+        }
+        read_duration += get_timestamp_us()-t1;
+        event_trace_flush();
+        residency_record_after(&residency, run->fd, 0, file_size);
+        if(prefetch_delay_sweep) residency_sampler_stop(&sampler);
+    }
+    if(strategy->teardown) strategy->teardown(run);
+    fprintf(output_file, "target='%s', category='%s', label='%s', "
+        #if OUTPUT_EXPERIMENT_DESCRIPTION
+        "desc='%s', "
+        #endif
+        "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, ", target_file, strategy->category, strategy->label,
+        #if OUTPUT_EXPERIMENT_DESCRIPTION
+        strategy->description,
+        #endif
+        file_size, io_interarrival_time_ns, io_size);
+    if(prefetch_size_sweep) fprintf(output_file, "prefetch_size=%llu, ", run->prefetch_size);
+    if(prefetch_delay_sweep) fprintf(output_file, "prefetch_delay=%llu, ", run->prefetch_delay);
+    if(direct_io) fprintf(output_file, "queue_depth=%u, ", run->queue_depth);
+    fprintf(output_file, "throughput_gb_per_second=%.3f", experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
+    arrival_schedule_fprint(output_file, io_interarrival_time_ns);
+    access_pattern_fprint(output_file);
+    repetition_fprint(output_file, &repetition);
+    residency_record_fprint(output_file, &residency);
+    if(prefetch_delay_sweep) residency_sampler_fprint(output_file, &sampler);
+    latency_histogram_fprint(output_file, &histogram);
+    if(direct_io){
+        io_uring_engine_destroy(&engine);
+        free(submit_times);
+        free(submit_offsets);
+    }
+    free(buffer);
+    free(offsets);
+    if(fp) fclose(fp);
+    else close(run->fd);
+    fflush(output_file);
+}
+
+// Hooks of the built-in strategies driven by perform_registered_benchmark
+static int baseline_sequential_prepare(struct iohints_strategy_run *run){
+    posix_fadvise(run->fd, 0, run->file_size, POSIX_FADV_SEQUENTIAL);
+    return 0;
+}
+
+static int baseline_random_prepare(struct iohints_strategy_run *run){
+    posix_fadvise(run->fd, 0, run->file_size, POSIX_FADV_RANDOM);
+    return 0;
+}
+
+// Offline strategies read the whole file before each experiment, io size at a time
+static int offline_prepare(struct iohints_strategy_run *run){
+    run->data = malloc(sizeof(char)*run->io_size);
+    return 0;
+}
+
+static void offline_prefetch(struct iohints_strategy_run *run){
+    for(uint64_t offset = 0; offset<run->file_size; offset+=run->io_size){
+        if(__glibc_unlikely(pread(run->fd, run->data, run->io_size, offset) < 0)){
+            printf("Error reading file \"%s\": %s\n", target_file_path, strerror(errno));
+            exit(0);
+        }
+    }
+}
+
+#ifdef WITH_LUSTRE
+static void offline_ladvise_evict(struct iohints_strategy_run *run){
+    server_cache_evict(run->fd, 0, run->file_size);
+}
+#endif
+
+static void offline_drop_cache_evict(struct iohints_strategy_run *run){
+    client_cache_drop(run->fd);
+}
+
+static void offline_fadvise_evict(struct iohints_strategy_run *run){
+    client_cache_evict(run->fd, 0, run->file_size);
+}
+
+// JIT strategies prefetch the whole file prefetch_delay us before the reads
+#ifdef WITH_LUSTRE
+static void jit_fadvise_ladvise_prefetch(struct iohints_strategy_run *run){
+    server_cache_prefetch(run->fd, 0, run->file_size);
+    client_cache_prefetch(run->fd, 0, run->file_size);
+}
+
+static void jit_ladvise_prefetch(struct iohints_strategy_run *run){
+    server_cache_prefetch(run->fd, 0, run->file_size);
+}
+#endif
+
+static void jit_fadvise_prefetch(struct iohints_strategy_run *run){
+    client_cache_prefetch(run->fd, 0, run->file_size);
+}
+
+static void jit_aio_prefetch(struct iohints_strategy_run *run){
+    aio_prefetch(run->fd, 0, run->file_size);
+}
+
+// Online strategies keep the ranges to prefetch before each read
+static int online_prepare(struct iohints_strategy_run *run){
+    run->data = malloc(sizeof(struct access_range)*(run->prefetch_size/run->io_size+1));
+    return 0;
+}
+
+static void online_fadvise_read(struct iohints_strategy_run *run, uint64_t read, uint64_t offset, uint64_t length){
+    struct access_range *ranges = run->data;
+    uint64_t range_count = access_pattern_prefetch_ranges(ranges, read, run->file_size, run->io_size, run->prefetch_size);
+    for(uint64_t r = 0; r<range_count; r++) client_cache_prefetch(run->fd, ranges[r].offset, ranges[r].length);
+}
+
+static void online_aio_read(struct iohints_strategy_run *run, uint64_t read, uint64_t offset, uint64_t length){
+    struct access_range *ranges = run->data;
+    uint64_t range_count = access_pattern_prefetch_ranges(ranges, read, run->file_size, run->io_size, run->prefetch_size);
+    for(uint64_t r = 0; r<range_count; r++) aio_prefetch(run->fd, ranges[r].offset, ranges[r].length);
+}
+
+#ifdef WITH_LUSTRE
+static void online_ladvise_read(struct iohints_strategy_run *run, uint64_t read, uint64_t offset, uint64_t length){
+    struct access_range *ranges = run->data;
+    uint64_t range_count = access_pattern_prefetch_ranges(ranges, read, run->file_size, run->io_size, run->prefetch_size);
+    for(uint64_t r = 0; r<range_count; r++) server_cache_prefetch(run->fd, ranges[r].offset, ranges[r].length);
+}
+
+static void online_fadvise_ladvise_read(struct iohints_strategy_run *run, uint64_t read, uint64_t offset, uint64_t length){
+    struct access_range *ranges = run->data;
+    uint64_t range_count = access_pattern_prefetch_ranges(ranges, read, run->file_size, run->io_size, run->prefetch_size);
+    for(uint64_t r = 0; r<range_count; r++){
+        server_cache_prefetch(run->fd, ranges[r].offset, ranges[r].length);
+        client_cache_prefetch(run->fd, ranges[r].offset, ranges[r].length);
+    }
+}
+
+static void online_aio_ladvise_read(struct iohints_strategy_run *run, uint64_t read, uint64_t offset, uint64_t length){
+    struct access_range *ranges = run->data;
+    uint64_t range_count = access_pattern_prefetch_ranges(ranges, read, run->file_size, run->io_size, run->prefetch_size);
+    for(uint64_t r = 0; r<range_count; r++){
+        server_cache_prefetch(run->fd, ranges[r].offset, ranges[r].length);
+        aio_prefetch(run->fd, ranges[r].offset, ranges[r].length);
+    }
+}
+#endif
+
+// Strategies that allocated run->data in prepare free it once the configuration is over
+static void run_data_teardown(struct iohints_strategy_run *run){
+    free(run->data);
+}
+
+// Use io_uring to forcefully prefetch some data, without going through the glibc aio thread pool
+static inline void io_uring_prefetch(struct io_uring_engine *engine, uint64_t offset, uint64_t length){
+    uint64_t start_ns = event_trace_now();
+    io_uring_engine_reap(engine, 0);
+    for(uint64_t chunk = 0; chunk<length; chunk+=engine->buffer_size){
+
+        // We keep at most twice the queue depth of reads in flight. Past that, we wait for the oldest ones
+        if(engine->inflight >= 2*engine->entries){
+            io_uring_engine_submit(engine);
+            io_uring_engine_reap(engine, 1);
+        }
+
+        // The buffer content is never looked at, so buffers are simply used in a round-robin way
+        io_uring_engine_queue_read(engine, engine->next_buffer, offset+chunk, length-chunk < engine->buffer_size ? length-chunk : engine->buffer_size);
+        engine->next_buffer = (engine->next_buffer+1)%engine->buffer_count;
+    }
+    io_uring_engine_submit(engine);
+    event_trace_record(EVENT_HINT_IO_URING, start_ns, offset, length, 0);
+}
+
+// Find the logical block size of the device backing a file, which O_DIRECT offsets, sizes and buffers must be aligned to
+static inline uint64_t get_logical_block_size(int fd){
+    struct stat st;
+    if(fstat(fd, &st)<0){
+        printf("Could not stat file \"%s\": %s\n", target_file_path, strerror(errno));
+        exit(0);
+    }
+
+    // The queue directory only exists for whole disks, so partitions have to look at their parent
+    const char *candidates[] = {"/sys/dev/block/%u:%u/queue/logical_block_size", "/sys/dev/block/%u:%u/../queue/logical_block_size"};
+    for(int i = 0; i<2; i++){
+        char path[128];
+        snprintf(path, sizeof(path), candidates[i], major(st.st_dev), minor(st.st_dev));
+        FILE *fp = fopen(path, "r");
+        if(fp == NULL) continue;
+        unsigned long long block_size = 0;
+        int ret = fscanf(fp, "%llu", &block_size);
+        fclose(fp);
+        if(ret == 1 && block_size > 0) return block_size;
+    }
+
+    // Network file systems (Lustre, GPFS...) have no backing block device, but accept page aligned direct I/Os
+    return sysconf(_SC_PAGESIZE);
+}
+
+// Fill thread_counts with 1, 2, 4... up to the number of online cores (included), and return how many counts were written
+static inline int get_reader_thread_counts(int *thread_counts){
+    int core_count = sysconf(_SC_NPROCESSORS_ONLN);
+    if(core_count<1) core_count = 1;
+    int count = 0;
+    for(int thread_count = 1; thread_count<core_count; thread_count*=2) thread_counts[count++] = thread_count;
+    thread_counts[count++] = core_count;
+    return count;
+}
+
+// Parse a size such as 4096, 64K, 16M or 1G
+static uint64_t parse_size(const char *value){
+    char *end;
+    uint64_t size = strtoull(value, &end, 10);
+    switch(*end){
+        case 'T': case 't': size <<= 10; // fallthrough
+        case 'G': case 'g': size <<= 10; // fallthrough
+        case 'M': case 'm': size <<= 10; // fallthrough
+        case 'K': case 'k': size <<= 10; end++; break;
+        default: break;
+    }
+    if(end==value || (*end!='\0' && strcmp(end, "B")!=0 && strcmp(end, "iB")!=0)){
+        printf("Invalid size \"%s\"\n", value);
+        exit(0);
+    }
+    return size;
+}
+
+// Parse a duration such as 15, 15s, 20m or 2h into microseconds. Plain numbers are seconds
+static uint64_t parse_duration_us(const char *value){
+    char *end;
+    double duration = strtod(value, &end);
+    if(end==value || duration<0){
+        printf("Invalid duration \"%s\"\n", value);
+        exit(0);
+    }
+    if(strcmp(end, "h")==0) duration *= 3600;
+    else if(strcmp(end, "m")==0 || strcmp(end, "min")==0) duration *= 60;
+    else if(strcmp(end, "ms")==0) duration *= 1e-3;
+    else if(strcmp(end, "us")==0) duration *= 1e-6;
+    else if(*end!='\0' && strcmp(end, "s")!=0){
+        printf("Invalid duration \"%s\"\n", value);
+        exit(0);
+    }
+    return duration*1e6;
+}
+
+// Parse a comma separated list of sizes (or plain integers) into values, and return how many were found
+static int parse_size_list(const char *name, const char *list, uint64_t *values){
+    char *copy = strdup(list), *saveptr = NULL;
+    int count = 0;
+    for(char *token = strtok_r(copy, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)){
+        if(count==MAX_SWEEP_VALUES){
+            printf("Too many values for --%s (at most %d)\n", name, MAX_SWEEP_VALUES);
+            exit(0);
+        }
+        values[count++] = parse_size(token);
+    }
+    free(copy);
+    if(count==0){
+        printf("Empty list for --%s\n", name);
+        exit(0);
+    }
+    return count;
+}
+
+// Memory the page cache can grow to: MemTotal, or the memory limit of our cgroup when it is lower
+static uint64_t get_page_cache_capacity(){
+    uint64_t capacity = 0, limit;
+    char line[256];
+    FILE *fp = fopen("/proc/meminfo", "r");
+    if(fp == NULL){
+        printf("Error opening file \"/proc/meminfo\": %s\n", strerror(errno));
+        exit(0);
+    }
+    while(fgets(line, sizeof(line), fp)) if(sscanf(line, "MemTotal: %llu kB", &capacity)==1) break;
+    fclose(fp);
+    capacity *= 1024;
+    fp = fopen("/sys/fs/cgroup/memory.max", "r");
+    if(fp){
+        if(fscanf(fp, "%llu", &limit)==1 && limit<capacity) capacity = limit; // "max" means no limit
+        fclose(fp);
+    }
+    if(capacity==0){
+        printf("Could not find out how much memory the page cache can use\n");
+        exit(0);
+    }
+    return capacity;
+}
+
+// Parse a list of multiples of the page cache capacity, e.g. 0.25,1,4, into file sizes rounded down to whole MBs
+static int parse_memory_ratio_list(const char *list, uint64_t *values){
+    uint64_t capacity = get_page_cache_capacity();
+    char *copy = strdup(list), *saveptr = NULL;
+    int count = 0;
+    for(char *token = strtok_r(copy, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)){
+        char *end;
+        double ratio = strtod(token, &end);
+        if(end==token || *end!='\0' || ratio<=0){
+            printf("Invalid memory ratio \"%s\"\n", token);
+            exit(0);
+        }
+        if(count==MAX_SWEEP_VALUES){
+            printf("Too many values for --memory-ratios (at most %d)\n", MAX_SWEEP_VALUES);
+            exit(0);
+        }
+        values[count] = (uint64_t)(ratio*capacity) & ~((1ul << 20)-1);
+        if(values[count]==0) values[count] = 1ul << 20;
+        count++;
+    }
+    free(copy);
+    if(count==0){
+        printf("Empty list for --memory-ratios\n");
+        exit(0);
+    }
+    printf("Sizing files after a page cache capacity of %.3f GB\n", capacity/(double)(1ul << 30));
+    return count;
+}
+
+// Tell whether a strategy is known. Strategies can be named individually ("online/aio") or by category ("online")
+static bool strategy_exists(const char *name){
+    size_t length = strlen(name);
+    for(int i = 0; strategy_names[i]; i++){
+        if(strcmp(strategy_names[i], name)==0) return true;
+        if(strncmp(strategy_names[i], name, length)==0 && strategy_names[i][length]=='/') return true;
+    }
+    const struct iohints_strategy *const *strategies = iohints_strategy_registry();
+    for(int i = 0; strategies[i]; i++){
+        if(strcmp(strategies[i]->name, name)==0) return true;
+        if(strncmp(strategies[i]->name, name, length)==0 && strategies[i]->name[length]=='/') return true;
+    }
+    return false;
+}
+
+// Add a strategy to the registry of libiohints, refusing the names of the strategies with a benchmark loop of their own
+static void strategy_register(const struct iohints_strategy *strategy){
+    for(int i = 0; strategy->name && strategy_names[i]; i++){
+        if(strcmp(strategy_names[i], strategy->name)==0){
+            printf("Strategy \"%s\" is registered twice\n", strategy->name);
+            exit(0);
+        }
+    }
+    if(iohints_strategy_register(strategy)==0) return;
+    if(errno==EINVAL) printf("Invalid strategy \"%s\": strategies need a \"category/strategy\" name, a category and a label\n", strategy->name ? strategy->name : "");
+    else if(errno==EEXIST) printf("Strategy \"%s\" is registered twice\n", strategy->name);
+    else printf("Too many registered strategies (at most %d)\n", IOHINTS_STRATEGY_MAX_REGISTERED);
+    exit(0);
+}
 
-                    // Allocating the read buffer
-                    char *buffer = malloc(sizeof(char)*io_size);
+// Load a strategy module, and register the strategies it returns
+static void strategy_module_load(const char *path){
+    const struct iohints_strategy *const *strategies = iohints_strategy_module_load(path);
+    if(strategies == NULL){
+        if(errno==ENOTSUP) printf("Error loading strategy module \"%s\": version %d of the strategy interface is not supported\n", path, IOHINTS_STRATEGY_API_VERSION);
+        else printf("Error loading strategy module \"%s\": %s\n", path, dlerror());
+        exit(0);
+    }
+    for(int i = 0; strategies[i]; i++) strategy_register(strategies[i]);
+}
 
-                    // Starting the campaign
-                    int experiment_count;
-                    uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                    for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
+// Tell whether a strategy was selected on the command line
+static inline bool strategy_selected(const char *strategy){
+    if(selected_strategy_count==0) return true;
+    for(int i = 0; i<selected_strategy_count; i++){
+        size_t length = strlen(selected_strategies[i]);
+        if(strcmp(strategy, selected_strategies[i])==0) return true;
+        if(strncmp(strategy, selected_strategies[i], length)==0 && strategy[length]=='/') return true;
+    }
+    return false;
+}
 
-                        // Cleaning the cache at the beginning of each experiment
-                        #ifdef WITH_LUSTRE
-                        server_cache_evict(fileno(fp), 0, file_size);
-                        #endif
-                        client_cache_drop(fileno(fp));
-                        // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+// Tell whether a configuration of the sweep should run, and count it towards the campaign estimate
+static inline bool configuration_selected(const char *strategy, uint64_t file_size){
+    if(!strategy_selected(strategy)) return false;
+    if(file_size>target_file_size) return false;
+    configuration_count++;
+    if(dry_run) return false;
+
+    // The budget is enforced as the campaign goes: each configuration gets its share of what is left of it, and none starts
+    // once it is spent, so that long experiments and cache resets are made up for by the configurations after them
+    if(campaign_budget_us!=0){
+        uint64_t elapsed_us = get_timestamp_us()-campaign_start_us;
+        uint64_t remaining_count = planned_configuration_count>=configuration_count ? planned_configuration_count-configuration_count+1 : 1;
+        uint64_t share_us = elapsed_us<campaign_budget_us ? (campaign_budget_us-elapsed_us)/remaining_count : 0;
+        if(elapsed_us<campaign_budget_us && share_us==0) share_us = 1;
+        duration_per_experiment_us = share_us<requested_duration_us ? share_us : requested_duration_us;
+        #ifdef WITH_MPI
+        MPI_Bcast(&duration_per_experiment_us, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD); // Ranks must agree on which configurations run
+        #endif
+        if(duration_per_experiment_us==0){
+            budget_skipped_count++;
+            return false;
+        }
+    }
+    return true;
+}
 
-                        // Running the experimentation: prefetching, waiting for a bit, then reading!
-                        client_cache_prefetch(fileno(fp), 0, file_size);
-                        usleep(prefetch_delay);
-                        fseek(fp, 0, SEEK_SET);
-                        uint64_t t1 = get_timestamp_us();
-                        for(size_t volume = 0; volume<file_size; volume+=io_size){
-                            int ret = fread(buffer, sizeof(char), io_size, fp);
-                            if(__glibc_unlikely(ret < 0)){
-                                printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                                exit(0);
-                            }
-                            if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
-                        }
-                        }
-                        read_duration += get_timestamp_us()-t1;
-                    }
-                    fprintf(output_file, "target='%s', category='JIT prefetch', label='JIT fadvise prefetch of the whole file', "
-                        #if OUTPUT_EXPERIMENT_DESCRIPTION
-                        "desc='File was prefetched to the client page cache using fadvise %d seconds before the reading started', "
-                        #endif
-                        "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, prefetch_delay=%d, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size, prefetch_delay,
-                        prefetch_delay, experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
-                    free(buffer);
-                    fflush(output_file);
+static void print_usage(const char *program){
+    printf("Usage: %s [options]\n"
+        "  -t, --target=PATH               file to read (default: %s)\n"
+        "  -o, --output=PATH               output csv (default: %s)\n"
+        "  -s, --strategies=LIST           strategies or categories to run, e.g. baseline,online/aio (default: all)\n"
+        "  -l, --list                      list the available strategies\n"
+        "      --file-sizes=LIST           file sizes to test, e.g. 64M,1G,16G\n"
+        "      --memory-ratios[=LIST]      file sizes to test as multiples of the page cache capacity (default: %s)\n"
+        "      --io-sizes=LIST             I/O sizes to test, e.g. 4K,1M\n"
+        "      --prefetch-delays=LIST      delays between JIT prefetches and reads, in us\n"
+        "      --interarrival-times=LIST   inter arrival times between I/Os, in ns\n"
+        "      --arrivals=SCHEDULE         constant or poisson arrivals of the paced I/Os (default: constant)\n"
+        "      --queue-depths=LIST         numbers of O_DIRECT reads in flight\n"
+        "      --patterns=LIST             orders to read the file in: forward, backward, strided or interleaved (default: forward)\n"
+        "      --stride=COUNT              the strided pattern reads one I/O out of every COUNT, in COUNT passes (default: %d)\n"
+        "      --streams=LIST              numbers of streams of the interleaved pattern (default: 2,4,8,16)\n"
+        "      --trace=PATH                trace to replay with every replay/ strategy\n"
+        "      --trace-speed=FACTOR        replay the trace FACTOR times faster, 0 ignores its timestamps (default: 1)\n"
+        "  -d, --duration=TIME             time spent on each configuration, e.g. 15s (default: %llus)\n"
+        "  -b, --budget=TIME               time budget of the whole campaign, e.g. 20m. Shrinks --duration if needed\n"
+        "      --ci-width=FRACTION         stop repeating a configuration once its 95%% confidence interval is within FRACTION of the mean\n"
+        "                                  throughput, 0 always runs for --duration (default: %g)\n"
+        "      --min-repetitions=COUNT     experiments run before trusting the confidence interval (default: %d)\n"
+        "      --max-repetitions=COUNT     experiments after which a configuration stops anyway, 0 means no limit (default: %d)\n"
+        "  -c, --config=PATH               read options from a file, one \"option = value\" per line\n"
+        "      --event-trace=PATH          record every read and hint to a binary event trace, see event-trace-decoder\n"
+        "      --write-target=PATH         scratch file of the write/ strategies, overwritten then deleted (default: target path + %s)\n"
+        "      --interposer=PATH           LD_PRELOAD interposer of the interposer/ strategies (default: %s)\n"
+        "      --plain-reader              read the first file size with plain reads of the first I/O size and pattern, print the read\n"
+        "                                  time in us and exit, as the interposer/ strategies do\n"
+        "      --strategy-modules=LIST     shared objects to load strategies from, see iohints-strategy.h\n"
+        "      --residency-sampling        follow how fast JIT prefetches make the file resident. The sampling thread slows the\n"
+        "                                  reads down, so the throughputs and latencies of these runs are not comparable\n"
+        #ifdef WITH_MPI
+        "      --mpi-layouts=LIST          how the ranks share the file: contiguous, strided or random (default: all)\n"
+        #endif
+        "  -n, --dry-run                   only print the campaign estimate\n"
+        "  -g, --generate                  create the target file, big enough for the largest file size, and exit\n"
+        "  -h, --help                      print this help\n",
+        program, TARGET_FILE, OUTPUT_FILE, MEMORY_RATIOS, ACCESS_PATTERN_STRIDE, DURATION_PER_EXPERIMENT_US/(uint64_t)1e6, REPETITION_CI_WIDTH, REPETITION_MIN_COUNT, REPETITION_MAX_COUNT,
+        WRITE_TARGET_SUFFIX, IOHINTS_PRELOAD_PATH);
+}
+
+static const struct option long_options[] = {
+    {"target", required_argument, 0, 't'},
+    {"output", required_argument, 0, 'o'},
+    {"strategies", required_argument, 0, 's'},
+    {"list", no_argument, 0, 'l'},
+    {"file-sizes", required_argument, 0, 1},
+    {"memory-ratios", optional_argument, 0, 13},
+    {"io-sizes", required_argument, 0, 2},
+    {"prefetch-delays", required_argument, 0, 3},
+    {"interarrival-times", required_argument, 0, 4},
+    {"arrivals", required_argument, 0, 8},
+    {"queue-depths", required_argument, 0, 5},
+    {"patterns", required_argument, 0, 14},
+    {"stride", required_argument, 0, 15},
+    {"streams", required_argument, 0, 16},
+    {"trace", required_argument, 0, 6},
+    {"trace-speed", required_argument, 0, 7},
+    {"duration", required_argument, 0, 'd'},
+    {"budget", required_argument, 0, 'b'},
+    {"ci-width", required_argument, 0, 9},
+    {"min-repetitions", required_argument, 0, 10},
+    {"max-repetitions", required_argument, 0, 11},
+    {"config", required_argument, 0, 'c'},
+    {"event-trace", required_argument, 0, 12},
+    {"write-target", required_argument, 0, 17},
+    {"interposer", required_argument, 0, 18},
+    {"plain-reader", no_argument, 0, 19},
+    #ifdef WITH_MPI
+    {"mpi-layouts", required_argument, 0, 21},
+    #endif
+    {"strategy-modules", required_argument, 0, 20},
+    {"residency-sampling", no_argument, 0, 22},
+    {"dry-run", no_argument, 0, 'n'},
+    {"generate", no_argument, 0, 'g'},
+    {"help", no_argument, 0, 'h'},
+    {0, 0, 0, 0}
+};
+
+static void parse_config_file(const char *path);
+
+// Apply a single option, given either on the command line or in a config file
+static void apply_option(int option, const char *value){
+    uint64_t values[MAX_SWEEP_VALUES];
+    switch(option){
+        case 't':
+            target_file_path = strdup(value);
+            break;
+        case 'o':
+            output_file_path = strdup(value);
+            break;
+        case 's': {
+            char *copy = strdup(value), *saveptr = NULL;
+            selected_strategy_count = 0;
+            for(char *token = strtok_r(copy, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)){
+                if(selected_strategy_count==MAX_SWEEP_VALUES){
+                    printf("Too many values for --strategies (at most %d)\n", MAX_SWEEP_VALUES);
+                    exit(0);
                 }
+                selected_strategies[selected_strategy_count++] = token;
             }
+            break;
         }
+        case 'l':
+            list_strategies = true;
+            break;
+        case 1:
+            file_size_count = parse_size_list("file-sizes", value, file_sizes);
+            break;
+        case 13:
+            file_size_count = parse_memory_ratio_list(value==NULL || *value=='\0' ? MEMORY_RATIOS : value, file_sizes);
+            break;
+        case 2:
+            io_size_count = parse_size_list("io-sizes", value, io_sizes);
+            break;
+        case 3:
+            jit_prefetch_delay_count = parse_size_list("prefetch-delays", value, jit_prefetch_delays);
+            break;
+        case 4:
+            io_interarrival_time_count = parse_size_list("interarrival-times", value, io_interarrival_times);
+            break;
+        case 5:
+            direct_io_queue_depth_count = parse_size_list("queue-depths", value, values);
+            for(int i = 0; i<direct_io_queue_depth_count; i++) direct_io_queue_depths[i] = values[i];
+            break;
+        case 14: {
+            char *copy = strdup(value), *saveptr = NULL;
+            access_pattern_count = 0;
+            for(char *token = strtok_r(copy, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)){
+                int p;
+                for(p = 0; p<ACCESS_PATTERN_COUNT && strcmp(access_pattern_names[p], token)!=0; p++);
+                if(p==ACCESS_PATTERN_COUNT){
+                    printf("Unknown access pattern \"%s\", expected forward, backward, strided or interleaved\n", token);
+                    exit(0);
+                }
+                if(access_pattern_count==ACCESS_PATTERN_COUNT){
+                    printf("Too many values for --patterns (at most %d)\n", ACCESS_PATTERN_COUNT);
+                    exit(0);
+                }
+                access_patterns[access_pattern_count++] = p;
+            }
+            free(copy);
+            if(access_pattern_count==0){
+                printf("Empty list for --patterns\n");
+                exit(0);
+            }
+            break;
+        }
+        case 15: {
+            char *end;
+            access_pattern_stride = strtoull(value, &end, 10);
+            if(end==value || *end!='\0' || access_pattern_stride==0){
+                printf("Invalid stride \"%s\"\n", value);
+                exit(0);
+            }
+            break;
+        }
+        case 16:
+            interleaved_stream_count_count = parse_size_list("streams", value, interleaved_stream_counts);
+            for(int i = 0; i<interleaved_stream_count_count; i++){
+                if(interleaved_stream_counts[i]==0){
+                    printf("Interleaved patterns need at least one stream\n");
+                    exit(0);
+                }
+            }
+            break;
+        case 6:
+            trace_file_path = strdup(value);
+            break;
+        case 7: {
+            char *end;
+            trace_speed = strtod(value, &end);
+            if(end==value || *end!='\0' || trace_speed<0){
+                printf("Invalid trace speed \"%s\"\n", value);
+                exit(0);
+            }
+            break;
+        }
+        case 8:
+            if(strcmp(value, "constant")==0) arrival_schedule = ARRIVAL_CONSTANT;
+            else if(strcmp(value, "poisson")==0) arrival_schedule = ARRIVAL_POISSON;
+            else{
+                printf("Unknown arrival schedule \"%s\", expected constant or poisson\n", value);
+                exit(0);
+            }
+            break;
+        case 'd':
+            duration_per_experiment_us = parse_duration_us(value);
+            if(duration_per_experiment_us==0){
+                printf("The duration of each configuration must not be zero\n");
+                exit(0);
+            }
+            break;
+        case 'b':
+            campaign_budget_us = parse_duration_us(value);
+            break;
+        case 9: {
+            char *end;
+            repetition_ci_width = strtod(value, &end);
+            if(end==value || *end!='\0' || repetition_ci_width<0){
+                printf("Invalid confidence interval width \"%s\"\n", value);
+                exit(0);
+            }
+            break;
+        }
+        case 10:
+        case 11: {
+            char *end;
+            uint64_t count = strtoull(value, &end, 10);
+            if(end==value || *end!='\0'){
+                printf("Invalid number of repetitions \"%s\"\n", value);
+                exit(0);
+            }
+            if(option==10) repetition_min_count = count;
+            else repetition_max_count = count;
+            break;
+        }
+        case 12:
+            event_trace_path = strdup(value);
+            break;
+        case 17:
+            write_target_file_path = strdup(value);
+            break;
+        case 18:
+            interposer_path = strdup(value);
+            break;
+        case 19:
+            plain_reader = true;
+            break;
+        case 22:
+            residency_sampling = true;
+            break;
+        case 20: {
+            char *copy = strdup(value), *saveptr = NULL;
+            for(char *token = strtok_r(copy, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)) strategy_module_load(token);
+            free(copy);
+            break;
+        }
+        #ifdef WITH_MPI
+        case 21: {
+            char *copy = strdup(value), *saveptr = NULL;
+            mpi_layout_count = 0;
+            for(char *token = strtok_r(copy, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)){
+                int l;
+                for(l = 0; l<MPI_LAYOUT_COUNT && strcmp(mpi_layout_names[l], token)!=0; l++);
+                if(l==MPI_LAYOUT_COUNT){
+                    printf("Unknown MPI layout \"%s\", expected contiguous, strided or random\n", token);
+                    exit(0);
+                }
+                if(mpi_layout_count==MPI_LAYOUT_COUNT){
+                    printf("Too many values for --mpi-layouts (at most %d)\n", MPI_LAYOUT_COUNT);
+                    exit(0);
+                }
+                mpi_layouts[mpi_layout_count++] = l;
+            }
+            free(copy);
+            if(mpi_layout_count==0){
+                printf("Empty list for --mpi-layouts\n");
+                exit(0);
+            }
+            break;
+        }
+        #endif
+        case 'c':
+            parse_config_file(value);
+            break;
+        case 'n':
+            dry_run = true;
+            break;
+        case 'g':
+            generate_target = true;
+            break;
+        default:
+            exit(0);
+    }
+}
 
-        // JIT prefetched server-side
-        #ifdef WITH_LUSTRE
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
-
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
-                
-                for(int k=0; k<jit_prefetch_delay_count; k++){
-                    int prefetch_delay = jit_prefetch_delays[k];
+// Remove leading and trailing white spaces
+static char *trim(char *text){
+    while(isspace((unsigned char)*text)) text++;
+    char *end = text+strlen(text);
+    while(end>text && isspace((unsigned char)end[-1])) *--end = '\0';
+    return text;
+}
 
-                    // Allocating the read buffer
-                    char *buffer = malloc(sizeof(char)*io_size);
+// Read options from a file, one "option = value" (or "option" for flags) per line. Lines starting with # are ignored
+static void parse_config_file(const char *path){
+    FILE *fp = fopen(path, "r");
+    if(fp == NULL){
+        printf("Error opening file \"%s\": %s\n", path, strerror(errno));
+        exit(0);
+    }
+    char line[4096];
+    int line_number = 0;
+    while(fgets(line, sizeof(line), fp)){
+        line_number++;
+
+        // Stripping comments, then splitting on '='
+        char *comment = strchr(line, '#');
+        if(comment) *comment = '\0';
+        char *separator = strchr(line, '=');
+        if(separator) *separator = '\0';
+        char *name = trim(line), *value = separator ? trim(separator+1) : NULL;
+        if(*name=='\0') continue;
+
+        const struct option *option = NULL;
+        for(int i = 0; long_options[i].name; i++) if(strcmp(long_options[i].name, name)==0) option = &long_options[i];
+        if(option==NULL || (option->has_arg==required_argument && (value==NULL || *value=='\0'))){
+            printf("%s:%d: invalid option \"%s\"\n", path, line_number, name);
+            exit(0);
+        }
+        apply_option(option->val, value);
+    }
+    fclose(fp);
+}
 
-                    // Starting the campaign
-                    int experiment_count;
-                    uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                    for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
+// Parse the command line (and the config files it points to) into the sweep parameters
+static void parse_arguments(int argc, char **argv){
 
-                        // Cleaning the cache at the beginning of each experiment
-                        #ifdef WITH_LUSTRE
-                        server_cache_evict(fileno(fp), 0, file_size);
-                        #endif
-                        client_cache_drop(fileno(fp));
-                        // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+    // The built-in strategies come first in the registry, before those of the strategy modules the options load
+    for(int i = 0; builtin_strategies[i]; i++) strategy_register(builtin_strategies[i]);
+    int option;
+    while((option = getopt_long(argc, argv, "t:o:s:ld:b:c:ngh", long_options, NULL)) != -1){
+        if(option=='h' || option=='?'){
+            print_usage(argv[0]);
+            exit(0);
+        }
+        apply_option(option, optarg);
+    }
+    if(optind<argc){
+        print_usage(argv[0]);
+        exit(0);
+    }
 
-                        // Running the experimentation: prefetching, waiting for a bit, then reading!
-                        server_cache_prefetch(fileno(fp), 0, file_size);
-                        usleep(prefetch_delay);
-                        fseek(fp, 0, SEEK_SET);
-                        uint64_t t1 = get_timestamp_us();
-                        for(size_t volume = 0; volume<file_size; volume+=io_size){
-                            int ret = fread(buffer, sizeof(char), io_size, fp);
-                            if(__glibc_unlikely(ret < 0)){
-                                printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                                exit(0);
-                            }
-                            if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
-                        }
-                        }
-                        read_duration += get_timestamp_us()-t1;
-                    }
-                    fprintf(output_file, "target='%s', category='JIT prefetch', label='JIT ladvise prefetch of the whole file', "
-                        #if OUTPUT_EXPERIMENT_DESCRIPTION
-                        "desc='File was prefetched to the server page cache using llu_ladvise %d seconds before the reading started', "
-                        #endif
-                        "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, prefetch_delay=%d, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size, prefetch_delay,
-                        prefetch_delay, experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
-                    free(buffer);
-                    fflush(output_file);
-                }
-            }
+    // Strategy modules may come after --strategies or --list, so strategies are only looked up once every option is known
+    for(int i = 0; i<selected_strategy_count; i++){
+        if(!strategy_exists(selected_strategies[i])){
+            printf("Unknown strategy \"%s\", use --list to see the available ones\n", selected_strategies[i]);
+            exit(0);
         }
-        #endif
+    }
+    if(list_strategies){
+        for(int i = 0; strategy_names[i]; i++) printf("%s\n", strategy_names[i]);
+        const struct iohints_strategy *const *strategies = iohints_strategy_registry();
+        for(int i = 0; strategies[i]; i++) printf("%s\n", strategies[i]->name);
+        exit(0);
+    }
+}
 
-        // JIT forcefully prefetched using async-io
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
+// Used for per-I/O latency instrumentation
+static inline uint64_t get_timestamp_ns(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return ts.tv_sec*(uint64_t)1e9+ts.tv_nsec;
+}
 
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
-                
-                for(int k=0; k<jit_prefetch_delay_count; k++){
-                    int prefetch_delay = jit_prefetch_delays[k];
+// Wait until a timestamp given by get_timestamp_ns
+static inline void sleep_until_ns(uint64_t due_ns){
+    uint64_t now = get_timestamp_ns();
+    if(due_ns>now+PACER_SPIN_THRESHOLD_NS){
+        uint64_t delay = due_ns-now-PACER_SPIN_THRESHOLD_NS;
+        struct timespec ts = {delay/(uint64_t)1e9, delay%(uint64_t)1e9};
+        while(nanosleep(&ts, &ts)==-1 && errno==EINTR);
+    }
+    while(get_timestamp_ns()<due_ns);
+}
 
-                    // Allocating the read buffer
-                    char *buffer = malloc(sizeof(char)*io_size);
+// Start a new schedule of reads, one every interarrival_ns on average. Streams of the same schedule draw different gaps
+static inline void pacer_reset(struct pacer *pacer, uint64_t interarrival_ns, uint64_t stream){
+    pacer->interarrival_ns = interarrival_ns;
+    pacer->due_ns = 0;
+    pacer->rng_state = PACER_SEED^(stream*0xbf58476d1ce4e5b9ull);
+    if(pacer->rng_state==0) pacer->rng_state = PACER_SEED;
+}
 
-                    // Starting the campaign
-                    int experiment_count;
-                    uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                    for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
+// When the next read should have started. Latencies measured from there include the time the read spent waiting for the previous ones
+static inline uint64_t pacer_intended_start(struct pacer *pacer){
+    uint64_t now = get_timestamp_ns();
+    if(pacer->interarrival_ns==0) return now;
+    if(pacer->due_ns==0) pacer->due_ns = now;
+    return pacer->due_ns<now ? pacer->due_ns : now;
+}
 
-                        // Cleaning the cache at the beginning of each experiment
-                        #ifdef WITH_LUSTRE
-                        server_cache_evict(fileno(fp), 0, file_size);
-                        #endif
-                        client_cache_drop(fileno(fp));
-                        // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+// Wait for the next read to be due. Late reads are not waited for, and the schedule does not shift to make up for them
+static inline void pacer_wait(struct pacer *pacer){
+    uint64_t gap = pacer->interarrival_ns;
+    if(arrival_schedule==ARRIVAL_POISSON){
+        pacer->rng_state ^= pacer->rng_state >> 12;
+        pacer->rng_state ^= pacer->rng_state << 25;
+        pacer->rng_state ^= pacer->rng_state >> 27;
+        double uniform = 1.0-((pacer->rng_state*0x2545f4914f6cdd1dull) >> 11)*0x1.0p-53; // In (0, 1]
+        gap = -log(uniform)*pacer->interarrival_ns;
+    }
+    if(pacer->due_ns==0) pacer->due_ns = get_timestamp_ns();
+    pacer->due_ns += gap;
+    sleep_until_ns(pacer->due_ns);
+}
 
-                        // Running the experimentation: prefetching, waiting for a bit, then reading!
-                        aio_prefetch(fileno(fp), 0, file_size);
-                        usleep(prefetch_delay);
-                        fseek(fp, 0, SEEK_SET);
-                        uint64_t t1 = get_timestamp_us();
-                        for(size_t volume = 0; volume<file_size; volume+=io_size){
-                            int ret = fread(buffer, sizeof(char), io_size, fp);
-                            if(__glibc_unlikely(ret < 0)){
-                                printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                                exit(0);
-                            }
-                            if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
-                        }
-                        }
-                        read_duration += get_timestamp_us()-t1;
-                    }
-                    fprintf(output_file, "target='%s', category='JIT prefetch', label='JIT async-io prefetch of the whole file', "
-                        #if OUTPUT_EXPERIMENT_DESCRIPTION
-                        "desc='File was prefetched to the server page cache using llu_ladvise %d seconds before the reading started', "
-                        #endif
-                        "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, prefetch_delay=%d, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size, prefetch_delay,
-                        prefetch_delay, experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
-                    free(buffer);
-                    fflush(output_file);
-                }
-            }
-        }
-        fclose(fp);
+// Print the arrival schedule column of paced configurations
+static inline void arrival_schedule_fprint(FILE *output_file, uint64_t interarrival_ns){
+    fprintf(output_file, ", arrival_schedule='%s'", interarrival_ns==0 ? "back_to_back" : arrival_schedule_names[arrival_schedule]);
+}
+
+// Start repeating a configuration
+static inline void repetition_reset(struct repetition *repetition){
+    memset(repetition, 0, sizeof(struct repetition));
+    repetition->start_us = get_timestamp_us();
+}
+
+// Record the experiment that just ended from the running totals of the loop, and tell whether another one is needed
+static inline bool repetition_continue(struct repetition *repetition, uint64_t volume, uint64_t read_duration){
+    if(read_duration>repetition->last_read_duration){
+        double throughput = (volume-repetition->last_volume)/((read_duration-repetition->last_read_duration)*1e-6)/(1ul << 30);
+        repetition->count++;
+        double delta = throughput-repetition->mean;
+        repetition->mean += delta/repetition->count;
+        repetition->m2 += delta*(throughput-repetition->mean);
+        repetition->last_volume = volume;
+        repetition->last_read_duration = read_duration;
     }
+    if(get_timestamp_us()-repetition->start_us>=duration_per_experiment_us) return false;
+    if(campaign_budget_us!=0 && repetition->count>0 && get_timestamp_us()-campaign_start_us>=campaign_budget_us) return false;
+    if(repetition_max_count!=0 && repetition->count>=repetition_max_count) return false;
+    if(repetition_ci_width>0 && repetition->count>=repetition_min_count && repetition->count>=2 &&
+        repetition_ci(repetition)<=repetition_ci_width*repetition->mean) return false;
+    return true;
 }
 
-void perform_online_prefetch_benchmark(char *target_file, FILE *output_file){
+// Half width of the 95% confidence interval of the mean throughput
+static inline double repetition_ci(const struct repetition *repetition){
+    // Two-sided 95% quantiles of Student's t distribution, by degrees of freedom. The normal quantile is close enough past 30
+    static const double t_quantiles[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228, 2.201, 2.179, 2.160, 2.145, 2.131,
+        2.120, 2.110, 2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if(repetition->count<2) return 0;
+    uint64_t freedom = repetition->count-1;
+    double quantile = freedom<=30 ? t_quantiles[freedom-1] : 1.960;
+    return quantile*sqrt(repetition->m2/freedom/repetition->count);
+}
 
-    for(int h = 0; h<io_interarrival_time_count; h++){
-        uint64_t io_interarrival_time_ns = io_interarrival_times[h];
-        FILE *fp = fopen(TARGET_FILE, "r");
+// Print the repetition columns of a configuration
+static inline void repetition_fprint(FILE *output_file, const struct repetition *repetition){
+    fprintf(output_file, ", throughput_mean_gb_per_second=%.3f, throughput_stddev_gb_per_second=%.3f, throughput_ci95_gb_per_second=%.3f, experiment_count=%llu",
+        repetition->mean, repetition->count>1 ? sqrt(repetition->m2/(repetition->count-1)) : 0, repetition_ci(repetition), repetition->count);
+}
 
-        // Dynamic fadvise + ladvise prefetching
-        #ifdef WITH_LUSTRE
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
+// Event trace file shared by every thread, and events lost because a ring filled up between two flushes
+static FILE *event_trace_file = NULL;
+static pthread_mutex_t event_trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t event_trace_overwritten = 0;
+static __thread struct event_ring *event_ring = NULL;
+
+// Create the event trace file, and start recording the events of the main thread
+static void event_trace_open(const char *path){
+    event_trace_file = fopen(path, "wb");
+    if(event_trace_file==NULL){
+        printf("Error opening file \"%s\": %s\n", path, strerror(errno));
+        exit(0);
+    }
+    fwrite(EVENT_TRACE_MAGIC, sizeof(char), 8, event_trace_file);
+    event_trace_thread_start(0);
+}
 
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
-                
-                for(int k=0; k<io_size_count; k++){
-                    uint64_t prefetch_size = io_sizes[k];
-                    if(prefetch_size<=io_size) continue;
+// Flush the events of the main thread and close the event trace file
+static void event_trace_close(){
+    event_trace_thread_stop();
+    fclose(event_trace_file);
+    event_trace_file = NULL;
+    if(event_trace_overwritten>0) printf("%llu events were overwritten before being written to the event trace\n", event_trace_overwritten);
+}
 
-                    // Allocating the read buffer
-                    char *buffer = malloc(sizeof(char)*io_size);
+// Start recording the events of the calling thread, if the event trace is enabled
+static void event_trace_thread_start(uint16_t thread){
+    if(event_trace_file==NULL) return;
+    event_ring = malloc(sizeof(struct event_ring));
+    event_ring->records = malloc(sizeof(struct event_record)*EVENT_TRACE_RING_CAPACITY);
+    memset(event_ring->records, 0, sizeof(struct event_record)*EVENT_TRACE_RING_CAPACITY); // Faulting the ring in now rather than while timing
+    event_ring->head = 0;
+    event_ring->thread = thread;
+}
 
-                    // Starting the campaign
-                    int experiment_count;
-                    uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                    for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
+// Flush the events of the calling thread and stop recording them
+static void event_trace_thread_stop(){
+    if(event_ring==NULL) return;
+    event_trace_flush();
+    free(event_ring->records);
+    free(event_ring);
+    event_ring = NULL;
+}
 
-                        // Cleaning the cache at the beginning of each experiment
-                        #ifdef WITH_LUSTRE
-                        server_cache_evict(fileno(fp), 0, file_size);
-                        #endif
-                        client_cache_drop(fileno(fp));
-                        // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+// Timestamp to start an event with, only taken when the calling thread records events
+static inline uint64_t event_trace_now(){
+    return event_ring==NULL ? 0 : get_timestamp_ns();
+}
 
-                        // Running the experimentation: reading, and sometimes prefetching!
-                        fseek(fp, 0, SEEK_SET);
-                        uint64_t t1 = get_timestamp_us();
-                        for(size_t volume = 0; volume<file_size; volume+=io_size){
-                            if(volume%prefetch_size==0){
-                                server_cache_prefetch(fileno(fp), volume, prefetch_size);
-                                client_cache_prefetch(fileno(fp), volume, prefetch_size);
-                            }
-                            int ret = fread(buffer, sizeof(char), io_size, fp);
-                            if(__glibc_unlikely(ret < 0)){
-                                printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                                exit(0);
-                            }
-                            if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
-                        }
-                        }
-                        read_duration += get_timestamp_us()-t1;
-                    }
-                    fprintf(output_file, "target='%s', category='Online prefetch', label='fadvise+ladvise online prefetching', "
-                        #if OUTPUT_EXPERIMENT_DESCRIPTION
-                        "desc='The file is prefetched using %llu bytes llu_ladvise AND fadvise prefetches', "
-                        #endif
-                        "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, prefetch_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size, prefetch_size, 
-                        prefetch_size, experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
-                    free(buffer);
-                    fflush(output_file);
-                }
-            }
-        }
-        #endif
+// Record an event that started at start_ns and ends now, if the calling thread records events
+static inline void event_trace_record(enum event_type type, uint64_t start_ns, uint64_t offset, uint64_t size, int64_t result){
+    if(__glibc_likely(event_ring==NULL)) return;
+    struct event_record *record = &event_ring->records[event_ring->head++%EVENT_TRACE_RING_CAPACITY];
+    record->start_ns = start_ns;
+    record->end_ns = get_timestamp_ns();
+    record->offset = offset;
+    record->size = size;
+    record->result = result;
+    record->configuration = configuration_count;
+    record->thread = event_ring->thread;
+    record->type = type;
+}
 
-        // Dynamic aio_read + ladvise prefetching
-        #ifdef WITH_LUSTRE
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
+// Write the events recorded by the calling thread to the event trace file. Only call it outside of timed regions
+static void event_trace_flush(){
+    if(event_ring==NULL || event_ring->head==0) return;
+    uint64_t count = event_ring->head<EVENT_TRACE_RING_CAPACITY ? event_ring->head : EVENT_TRACE_RING_CAPACITY;
+    uint64_t first = (event_ring->head-count)%EVENT_TRACE_RING_CAPACITY;
+    pthread_mutex_lock(&event_trace_mutex);
+    uint64_t tail = first+count<=EVENT_TRACE_RING_CAPACITY ? count : EVENT_TRACE_RING_CAPACITY-first; // Oldest events, up to the end of the ring
+    fwrite(&event_ring->records[first], sizeof(struct event_record), tail, event_trace_file);
+    fwrite(event_ring->records, sizeof(struct event_record), count-tail, event_trace_file);
+    event_trace_overwritten += event_ring->head-count;
+    pthread_mutex_unlock(&event_trace_mutex);
+    event_ring->head = 0;
+}
 
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
-                
-                for(int k=0; k<io_size_count; k++){
-                    uint64_t prefetch_size = io_sizes[k];
-                    if(prefetch_size<=io_size) continue;
+// Empty a latency histogram
+static inline void latency_histogram_reset(struct latency_histogram *histogram){
+    memset(histogram, 0, sizeof(struct latency_histogram));
+}
 
-                    // Allocating the read buffer
-                    char *buffer = malloc(sizeof(char)*io_size);
+// Record a single latency, in ns
+static inline void latency_histogram_record(struct latency_histogram *histogram, uint64_t latency_ns){
+    unsigned index = latency_ns;
+    if(latency_ns >= 1u << LATENCY_HISTOGRAM_SUB_BUCKET_BITS){
 
-                    // Starting the campaign
-                    int experiment_count;
-                    uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                    for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
+        // Buckets are powers of two, and sub-buckets the bits right after the most significant one
+        unsigned magnitude = 63-__builtin_clzll(latency_ns)-LATENCY_HISTOGRAM_SUB_BUCKET_BITS;
+        unsigned sub_bucket = (latency_ns >> magnitude) & ((1u << LATENCY_HISTOGRAM_SUB_BUCKET_BITS)-1);
+        index = ((magnitude+1) << LATENCY_HISTOGRAM_SUB_BUCKET_BITS) | sub_bucket;
+    }
+    histogram->counts[index]++;
+    histogram->count++;
+    if(latency_ns>histogram->max) histogram->max = latency_ns;
+}
 
-                        // Cleaning the cache at the beginning of each experiment
-                        #ifdef WITH_LUSTRE
-                        server_cache_evict(fileno(fp), 0, file_size);
-                        #endif
-                        client_cache_drop(fileno(fp));
-                        // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+// Add every value of source to destination
+static inline void latency_histogram_merge(struct latency_histogram *destination, const struct latency_histogram *source){
+    for(int i = 0; i<LATENCY_HISTOGRAM_BUCKET_COUNT; i++) destination->counts[i] += source->counts[i];
+    destination->count += source->count;
+    if(source->max>destination->max) destination->max = source->max;
+}
+
+// Highest latency (in ns) that falls in the same bucket as the given percentile
+static inline uint64_t latency_histogram_percentile(const struct latency_histogram *histogram, double percentile){
+    if(histogram->count==0) return 0;
+    uint64_t rank = ceil(percentile/100*histogram->count), seen = 0;
+    if(rank==0) rank = 1;
+    for(unsigned index = 0; index<LATENCY_HISTOGRAM_BUCKET_COUNT; index++){
+        seen += histogram->counts[index];
+        if(seen<rank) continue;
+        unsigned magnitude = index >> LATENCY_HISTOGRAM_SUB_BUCKET_BITS;
+        if(magnitude==0) return index;
+        uint64_t sub_bucket = (index & ((1u << LATENCY_HISTOGRAM_SUB_BUCKET_BITS)-1)) | (1u << LATENCY_HISTOGRAM_SUB_BUCKET_BITS);
+        uint64_t highest = ((sub_bucket+1) << (magnitude-1))-1;
+        return highest<histogram->max ? highest : histogram->max;
+    }
+    return histogram->max;
+}
+
+// Print the p50/p90/p99/p99.9/max latency columns (in us), and end the output line
+static inline void latency_histogram_fprint(FILE *output_file, const struct latency_histogram *histogram){
+    fprintf(output_file, ", latency_p50_us=%.3f, latency_p90_us=%.3f, latency_p99_us=%.3f, latency_p999_us=%.3f, latency_max_us=%.3f\n",
+        latency_histogram_percentile(histogram, 50)*1e-3, latency_histogram_percentile(histogram, 90)*1e-3,
+        latency_histogram_percentile(histogram, 99)*1e-3, latency_histogram_percentile(histogram, 99.9)*1e-3, histogram->max*1e-3);
+}
+
+// Load a trace, either binary (TRACE_BINARY_MAGIC followed by trace_record structures) or text ("timestamp_s offset size" per line)
+static void trace_load(const char *path, struct trace *trace){
+    FILE *fp = fopen(path, "r");
+    if(fp == NULL){
+        printf("Error opening file \"%s\": %s\n", path, strerror(errno));
+        exit(0);
+    }
+    memset(trace, 0, sizeof(struct trace));
+    uint64_t capacity = 0, line_number = 0;
+    char magic[sizeof(TRACE_BINARY_MAGIC)-1];
+    bool binary = fread(magic, 1, sizeof(magic), fp)==sizeof(magic) && memcmp(magic, TRACE_BINARY_MAGIC, sizeof(magic))==0;
+    if(!binary) rewind(fp);
+    for(;;){
+        struct trace_record record;
+        if(binary){
+            if(fread(&record, sizeof(struct trace_record), 1, fp)!=1) break;
+        }else{
+
+            // Text traces have one "timestamp_s offset size" access per line, separated by spaces or commas. # starts a comment
+            char line[1024];
+            if(!fgets(line, sizeof(line), fp)) break;
+            line_number++;
+            char *comment = strchr(line, '#');
+            if(comment) *comment = '\0';
+            for(char *c = line; *c; c++) if(*c==',') *c = ' ';
+            double timestamp_s;
+            unsigned long long offset, size;
+            int fields = sscanf(line, "%lf %llu %llu", &timestamp_s, &offset, &size);
+            if(fields==EOF) continue;
+            if(fields!=3 || timestamp_s<0){
+                printf("%s:%llu: expected \"timestamp_s offset size\"\n", path, line_number);
+                exit(0);
+            }
+            record.timestamp_ns = timestamp_s*1e9;
+            record.offset = offset;
+            record.size = size;
+        }
+        if(record.size==0) continue;
+        if(trace->record_count==capacity){
+            capacity = capacity ? 2*capacity : 4096;
+            trace->records = realloc(trace->records, sizeof(struct trace_record)*capacity);
+        }
+        trace->records[trace->record_count++] = record;
+    }
+    fclose(fp);
+    if(trace->record_count==0){
+        printf("Trace \"%s\" holds no access\n", path);
+        exit(0);
+    }
 
-                        // Running the experimentation: reading, and sometimes prefetching!
-                        fseek(fp, 0, SEEK_SET);
-                        uint64_t t1 = get_timestamp_us();
-                        for(size_t volume = 0; volume<file_size; volume+=io_size){
-                            if(volume%prefetch_size==0){
-                                server_cache_prefetch(fileno(fp), volume, prefetch_size);
-                                aio_prefetch(fileno(fp), volume, prefetch_size);
-                            }
-                            int ret = fread(buffer, sizeof(char), io_size, fp);
-                            if(__glibc_unlikely(ret < 0)){
-                                printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                                exit(0);
-                            }
-                            if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
-                        }
-                        }
-                        read_duration += get_timestamp_us()-t1;
-                    }
-                    fprintf(output_file, "target='%s', category='Online prefetch', label='aio_read+ladvise online prefetching', "
-                        #if OUTPUT_EXPERIMENT_DESCRIPTION
-                        "desc='The file is prefetched using %llu bytes llu_ladvise AND fadvise prefetches', "
-                        #endif
-                        "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, prefetch_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size, prefetch_size, 
-                        prefetch_size, experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
-                    free(buffer);
-                    fflush(output_file);
-                }
+    // Making timestamps relative to the first record, and finding the range of the file the trace touches
+    uint64_t first_timestamp_ns = trace->records[0].timestamp_ns;
+    trace->start = UINT64_MAX;
+    for(uint64_t r = 0; r<trace->record_count; r++){
+        struct trace_record *record = &trace->records[r];
+        record->timestamp_ns = record->timestamp_ns>first_timestamp_ns ? record->timestamp_ns-first_timestamp_ns : 0;
+        if(record->offset<trace->start) trace->start = record->offset;
+        if(record->offset+record->size>trace->end) trace->end = record->offset+record->size;
+        if(record->size>trace->largest_size) trace->largest_size = record->size;
+    }
+}
+
+// Forget everything an adaptive prefetcher learnt, starting again from the smallest window and distance
+static inline void adaptive_prefetcher_reset(struct adaptive_prefetcher *prefetcher){
+    memset(prefetcher, 0, sizeof(struct adaptive_prefetcher));
+    prefetcher->window = ADAPTIVE_PREFETCH_MIN_SIZE;
+    prefetcher->distance = ADAPTIVE_PREFETCH_MIN_SIZE;
+}
+
+// Feed an upcoming access to an adaptive prefetcher: learn the stride, and fadvise the accesses ahead once it is confirmed
+static inline void adaptive_prefetcher_access(struct adaptive_prefetcher *prefetcher, int fd, uint64_t offset, uint64_t size){
+
+    // Learning the stride and the pace of the reader. A broken stride invalidates what was prefetched ahead
+    uint64_t now_ns = get_timestamp_ns();
+    int64_t stride = (int64_t)(offset-prefetcher->last_offset);
+    if(prefetcher->last_access_ns!=0){
+        double interarrival_ns = now_ns-prefetcher->last_access_ns;
+        prefetcher->interarrival_ns = prefetcher->interarrival_ns==0 ? interarrival_ns : 0.875*prefetcher->interarrival_ns+0.125*interarrival_ns;
+        if(stride!=0 && stride==prefetcher->stride){
+            if(prefetcher->stride_confirmations<ADAPTIVE_PREFETCH_STRIDE_CONFIRMATIONS) prefetcher->stride_confirmations++;
+        }else{
+            prefetcher->stride = stride;
+            prefetcher->stride_confirmations = 0;
+            prefetcher->covered_accesses = 0;
+        }
+    }
+    prefetcher->last_offset = offset;
+    prefetcher->last_access_ns = now_ns;
+    prefetcher->predicted = prefetcher->covered_accesses>0;
+    if(prefetcher->covered_accesses>0) prefetcher->covered_accesses--;
+    if(prefetcher->stride_confirmations<ADAPTIVE_PREFETCH_STRIDE_CONFIRMATIONS) return;
+
+    // Prefetching windows of upcoming accesses until they cover the prefetch distance. Contiguous accesses are merged into a single fadvise
+    if(prefetcher->window<size) prefetcher->window = size;
+    uint64_t step = prefetcher->stride<0 ? -prefetcher->stride : prefetcher->stride;
+    while(prefetcher->covered_accesses*step<prefetcher->distance){
+        uint64_t count = prefetcher->window/size>0 ? prefetcher->window/size : 1, issued;
+        int64_t range_start = 0, range_end = 0;
+        for(issued = 0; issued<count; issued++){
+            int64_t access_offset = (int64_t)offset+(int64_t)(prefetcher->covered_accesses+issued+1)*prefetcher->stride;
+            if(access_offset<0) break;
+            if(range_end>range_start && access_offset<=range_end && access_offset+(int64_t)size>=range_start){
+                if(access_offset<range_start) range_start = access_offset;
+                if(access_offset+(int64_t)size>range_end) range_end = access_offset+size;
+            }else{
+                if(range_end>range_start) client_cache_prefetch(fd, range_start, range_end-range_start);
+                range_start = access_offset;
+                range_end = access_offset+size;
             }
         }
-        #endif
+        if(range_end>range_start) client_cache_prefetch(fd, range_start, range_end-range_start);
+        if(issued==0) break;
+        prefetcher->covered_accesses += issued;
+        prefetcher->prefetch_count++;
+        prefetcher->window_sum += prefetcher->window;
+    }
+}
 
-        // Dynamic fadvise prefetching
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
+// Read an access through an adaptive prefetcher, growing or shrinking its window and distance depending on whether the data was resident
+static inline ssize_t adaptive_prefetcher_read(struct adaptive_prefetcher *prefetcher, FILE *fp, char *buffer, uint64_t offset, uint64_t size){
+
+    // Non-blocking reads of the first and last bytes only succeed when the access is already resident, i.e. when the prefetch was early
+    // enough. The access itself is then read with fread, like the fixed-size sweep it is compared against
+    char byte;
+    bool resident = preadv2(fileno(fp), &(struct iovec){&byte, 1}, 1, offset, RWF_NOWAIT)==1
+        && preadv2(fileno(fp), &(struct iovec){&byte, 1}, 1, offset+size-1, RWF_NOWAIT)==1;
+    uint64_t t = get_timestamp_ns();
+    size_t done = fread(buffer, sizeof(char), size, fp);
+    if(ferror(fp)) return -1;
+    if(resident){
+        prefetcher->hits++;
+
+        // Shrinking back slowly while everything is resident, but never below the distance the reader covers during a miss
+        if(++prefetcher->consecutive_hits>=ADAPTIVE_PREFETCH_SHRINK_PERIOD){
+            prefetcher->consecutive_hits = 0;
+            uint64_t step = prefetcher->stride<0 ? -prefetcher->stride : prefetcher->stride;
+            uint64_t distance_floor = prefetcher->interarrival_ns>0 ? prefetcher->miss_latency_ns/prefetcher->interarrival_ns*step : 0;
+            prefetcher->window -= prefetcher->window/4;
+            prefetcher->distance -= prefetcher->distance/4;
+            if(prefetcher->distance<distance_floor) prefetcher->distance = distance_floor;
+            if(prefetcher->window<ADAPTIVE_PREFETCH_MIN_SIZE) prefetcher->window = ADAPTIVE_PREFETCH_MIN_SIZE;
+            if(prefetcher->distance<ADAPTIVE_PREFETCH_MIN_SIZE) prefetcher->distance = ADAPTIVE_PREFETCH_MIN_SIZE;
+            if(prefetcher->distance>ADAPTIVE_PREFETCH_MAX_SIZE) prefetcher->distance = ADAPTIVE_PREFETCH_MAX_SIZE;
+        }
+        return done;
+    }
 
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
-                
-                for(int k=0; k<io_size_count; k++){
-                    uint64_t prefetch_size = io_sizes[k];
-                    if(prefetch_size<=io_size) continue;
+    // Keeping track of how long a miss takes
+    double miss_latency_ns = get_timestamp_ns()-t;
+    prefetcher->miss_latency_ns = prefetcher->miss_latency_ns==0 ? miss_latency_ns : 0.875*prefetcher->miss_latency_ns+0.125*miss_latency_ns;
+    prefetcher->misses++;
+    prefetcher->consecutive_hits = 0;
 
-                    // Allocating the read buffer
-                    char *buffer = malloc(sizeof(char)*io_size);
+    // A miss on an access that was prefetched means the prefetch was late: looking further ahead, with bigger prefetches
+    if(prefetcher->predicted){
+        prefetcher->window = 2*prefetcher->window<ADAPTIVE_PREFETCH_MAX_SIZE ? 2*prefetcher->window : ADAPTIVE_PREFETCH_MAX_SIZE;
+        prefetcher->distance = 2*prefetcher->distance<ADAPTIVE_PREFETCH_MAX_SIZE ? 2*prefetcher->distance : ADAPTIVE_PREFETCH_MAX_SIZE;
+    }
+    return done;
+}
 
-                    // Starting the campaign
-                    int experiment_count;
-                    uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                    for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
+// Give the madvise hint of an mmap strategy on a whole mapping. Returns false when the kernel does not support it
+static inline bool mmap_strategy_apply(enum mmap_strategy strategy, char *mapping, uint64_t length){
+    int advice;
+    switch(strategy){
+        case MMAP_STRATEGY_SEQUENTIAL: advice = MADV_SEQUENTIAL; break;
+        case MMAP_STRATEGY_RANDOM: advice = MADV_RANDOM; break;
+        case MMAP_STRATEGY_WILLNEED: advice = MADV_WILLNEED; break;
+        case MMAP_STRATEGY_POPULATE_READ: advice = MADV_POPULATE_READ; break;
+        case MMAP_STRATEGY_HUGEPAGE: advice = MADV_HUGEPAGE; break;
+        default: return true;
+    }
+    uint64_t start_ns = event_trace_now();
+    int ret = madvise(mapping, length, advice);
+    event_trace_record(EVENT_HINT_MADVISE, start_ns, 0, length, ret);
+    return ret==0;
+}
 
-                        // Cleaning the cache at the beginning of each experiment
-                        #ifdef WITH_LUSTRE
-                        server_cache_evict(fileno(fp), 0, file_size);
-                        #endif
-                        client_cache_drop(fileno(fp));
-                        // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
-                        
+// Fraction of the pages of a range that are resident in the client page cache, -1 when it could not be measured
+static inline double client_cache_resident_fraction(int fd, uint64_t offset, uint64_t length){
+    struct stat file_stat;
+    if(fstat(fd, &file_stat)<0) return -1;
+    if(offset>=(uint64_t)file_stat.st_size) return 0;
+    if(length==0 || offset+length>(uint64_t)file_stat.st_size) length = file_stat.st_size-offset;
+    uint64_t page_size = sysconf(_SC_PAGESIZE);
+    uint64_t page_count = (offset+length+page_size-1)/page_size - offset/page_size;
+    uint64_t resident_pages = client_cache_resident_pages(fd, offset, length);
+    return resident_pages==RESIDENT_PAGES_UNKNOWN ? -1 : (double)resident_pages/page_count;
+}
 
-                        // Running the experimentation: reading, and sometimes prefetching!
-                        fseek(fp, 0, SEEK_SET);
-                        uint64_t t1 = get_timestamp_us();
-                        for(size_t volume = 0; volume<file_size; volume+=io_size){
-                            if(volume%prefetch_size==0) client_cache_prefetch(fileno(fp), volume, prefetch_size);
-                            int ret = fread(buffer, sizeof(char), io_size, fp);
-                            if(__glibc_unlikely(ret < 0)){
-                                printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                                exit(0);
-                            }
-                            if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
-                        }
-                        }
-                        read_duration += get_timestamp_us()-t1;
-                    }
-                    fprintf(output_file, "target='%s', category='Online prefetch', label='fadvise online prefetching', "
-                        #if OUTPUT_EXPERIMENT_DESCRIPTION
-                        "desc='The file is prefetched using %llu bytes fadvise prefetches', "
-                        #endif
-                        "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, prefetch_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size, prefetch_size, 
-                        prefetch_size, experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
-                    free(buffer);
-                    fflush(output_file);
-                }
-            }
-        }
+// Start recording the residency of a new configuration, whose timed loops should start in the given state
+static inline void residency_record_reset(struct residency_record *record, enum residency_precondition precondition){
+    memset(record, 0, sizeof(struct residency_record));
+    record->precondition = precondition;
+}
 
-        // Dynamic llapi_ladvise prefetching
-        #ifdef WITH_LUSTRE
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
+// Snapshot the residency of a range right before a timed loop, and check the precondition
+static inline void residency_record_before(struct residency_record *record, int fd, uint64_t offset, uint64_t length){
+    double fraction = client_cache_resident_fraction(fd, offset, length);
 
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
-                
-                for(int k=0; k<io_size_count; k++){
-                    uint64_t prefetch_size = io_sizes[k];
-                    if(prefetch_size<=io_size) continue;
+    // A residency that could not be measured cannot be trusted to meet the precondition
+    if(fraction<0){
+        record->failure_count++;
+        return;
+    }
+    record->before_sum += fraction;
+    record->before_count++;
+    if((record->precondition==RESIDENCY_COLD && fraction>RESIDENCY_TOLERANCE) || (record->precondition==RESIDENCY_WARM && fraction<1-RESIDENCY_TOLERANCE)){
+        record->failure_count++;
+    }
+}
 
-                    // Allocating the read buffer
-                    char *buffer = malloc(sizeof(char)*io_size);
+// Snapshot the residency of a range right after a timed loop
+static inline void residency_record_after(struct residency_record *record, int fd, uint64_t offset, uint64_t length){
+    double fraction = client_cache_resident_fraction(fd, offset, length);
+    if(fraction<0) return;
+    record->after_sum += fraction;
+    record->after_count++;
+}
 
-                    // Starting the campaign
-                    int experiment_count;
-                    uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                    for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
+// Print the mean resident fractions (-1 when none could be measured) and the precondition failures as columns
+static inline void residency_record_fprint(FILE *output_file, const struct residency_record *record){
+    fprintf(output_file, ", resident_before=%.3f, resident_after=%.3f, precondition='%s', precondition_failures=%d",
+        record->before_count ? record->before_sum/record->before_count : -1, record->after_count ? record->after_sum/record->after_count : -1,
+        residency_precondition_names[record->precondition], record->failure_count);
+}
 
-                        // Cleaning the cache at the beginning of each experiment
-                        #ifdef WITH_LUSTRE
-                        server_cache_evict(fileno(fp), 0, file_size);
-                        #endif
-                        client_cache_drop(fileno(fp));
-                        // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+// Forget the experiments a residency sampler followed
+static inline void residency_sampler_reset(struct residency_sampler *sampler){
+    memset(sampler, 0, sizeof(struct residency_sampler));
+}
 
-                        // Running the experimentation: reading, and sometimes prefetching!
-                        fseek(fp, 0, SEEK_SET);
-                        uint64_t t1 = get_timestamp_us();
-                        for(size_t volume = 0; volume<file_size; volume+=io_size){
-                            if(volume%prefetch_size==0) server_cache_prefetch(fileno(fp), volume, prefetch_size);
-                            int ret = fread(buffer, sizeof(char), io_size, fp);
-                            if(__glibc_unlikely(ret < 0)){
-                                printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                                exit(0);
-                            }
-                            if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
-                        }
-                        }
-                        read_duration += get_timestamp_us()-t1;
-                    }
-                    fprintf(output_file, "target='%s', category='Online prefetch', label='ladvise online prefetching', "
-                        #if OUTPUT_EXPERIMENT_DESCRIPTION
-                        "desc='The file is prefetched using %llu bytes llu_ladvise prefetches', "
-                        #endif
-                        "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, prefetch_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size, prefetch_size, 
-                        prefetch_size, experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
-                    free(buffer);
-                    fflush(output_file);
-                }
-            }
+// Body of the sampling thread: residency thresholds are timed until the range is fully resident, and the reader caught up if the data it is about to read is not
+static void *residency_sampler_main(void *arg){
+    struct residency_sampler *sampler = arg;
+    uint64_t page_size = sysconf(_SC_PAGESIZE);
+    uint64_t io_page_count = (sampler->io_size+page_size-1)/page_size;
+    while(!__atomic_load_n(&sampler->stop, __ATOMIC_ACQUIRE)){
+        double fraction = client_cache_resident_fraction(sampler->fd, 0, sampler->length);
+        uint64_t elapsed_ns = get_timestamp_ns()-sampler->hint_ns;
+        if(sampler->time_to_50_ns==0 && fraction>=0.5) sampler->time_to_50_ns = elapsed_ns;
+        if(sampler->time_to_90_ns==0 && fraction>=0.9) sampler->time_to_90_ns = elapsed_ns;
+        if(fraction>=1){
+            sampler->time_to_100_ns = elapsed_ns;
+            break;
         }
-        #endif
+        uint64_t position = __atomic_load_n(&sampler->reader_position, __ATOMIC_RELAXED);
+        if(sampler->catch_up_ns==0 && __atomic_load_n(&sampler->reader_start_ns, __ATOMIC_RELAXED)!=0 && position<sampler->length
+            && client_cache_resident_pages(sampler->fd, position, sampler->io_size)<io_page_count){
+            sampler->catch_up_ns = elapsed_ns;
+        }
+        usleep(RESIDENCY_SAMPLER_PERIOD_US);
+    }
+    return NULL;
+}
 
-        // Dynamic aio_read prefetching
-        for(int i = 0; i<file_size_count; i++){
-            uint64_t file_size = file_sizes[i];
+// Start following the first length bytes of a file, right before a prefetch hint is issued
+static inline void residency_sampler_start(struct residency_sampler *sampler, int fd, uint64_t length, uint64_t io_size){
+    if(!residency_sampling) return;
+    sampler->fd = fd;
+    sampler->length = length;
+    sampler->io_size = io_size;
+    sampler->reader_start_ns = 0;
+    sampler->reader_position = 0;
+    sampler->stop = false;
+    sampler->time_to_50_ns = sampler->time_to_90_ns = sampler->time_to_100_ns = sampler->catch_up_ns = 0;
+    sampler->hint_ns = get_timestamp_ns();
+    int ret = pthread_create(&sampler->thread, NULL, residency_sampler_main, sampler);
+    if(ret){
+        printf("Could not create residency sampler thread: %s\n", strerror(ret));
+        exit(0);
+    }
+}
 
-            for(int j = 0; j<io_size_count; j++){
-                uint64_t io_size = io_sizes[j];
-                if(io_size>file_size) continue;
-                
-                for(int k=0; k<io_size_count; k++){
-                    uint64_t prefetch_size = io_sizes[k];
-                    if(prefetch_size<=io_size) continue;
+// Tell the sampler that the reader starts reading
+static inline void residency_sampler_reader_start(struct residency_sampler *sampler){
+    if(!residency_sampling) return;
+    __atomic_store_n(&sampler->reader_start_ns, get_timestamp_ns(), __ATOMIC_RELAXED);
+}
 
-                    // Allocating the read buffer
-                    char *buffer = malloc(sizeof(char)*io_size);
+// Tell the sampler where the next read of the reader starts
+static inline void residency_sampler_progress(struct residency_sampler *sampler, uint64_t position){
+    if(!residency_sampling) return;
+    __atomic_store_n(&sampler->reader_position, position, __ATOMIC_RELAXED);
+}
 
-                    // Starting the campaign
-                    int experiment_count;
-                    uint64_t t0 = get_timestamp_us(), read_duration = 0;
-                    for(experiment_count=0; get_timestamp_us() - t0 < DURATION_PER_EXPERIMENT_US; experiment_count++){
+// Stop following the prefetch, and add the experiment to the sums
+static inline void residency_sampler_stop(struct residency_sampler *sampler){
+    if(!residency_sampling) return;
+    __atomic_store_n(&sampler->stop, true, __ATOMIC_RELEASE);
+    pthread_join(sampler->thread, NULL);
+    sampler->experiment_count++;
+    sampler->reader_start_sum += sampler->reader_start_ns-sampler->hint_ns;
+    if(sampler->time_to_50_ns){ sampler->time_to_50_sum += sampler->time_to_50_ns; sampler->time_to_50_count++; }
+    if(sampler->time_to_90_ns){ sampler->time_to_90_sum += sampler->time_to_90_ns; sampler->time_to_90_count++; }
+    if(sampler->time_to_100_ns){ sampler->time_to_100_sum += sampler->time_to_100_ns; sampler->time_to_100_count++; }
+    if(sampler->catch_up_ns){ sampler->catch_up_sum += sampler->catch_up_ns-(sampler->reader_start_ns-sampler->hint_ns); sampler->catch_up_count++; }
+}
 
-                        // Cleaning the cache at the beginning of each experiment
-                        #ifdef WITH_LUSTRE
-                        server_cache_evict(fileno(fp), 0, file_size);
-                        #endif
-                        client_cache_drop(fileno(fp));
-                        // sleep(CACHE_DROP_DELAY_SECONDS); // cache drops might be async, so we do a small sleep
+// Print the mean times to 50/90/100% resident, the prefetch bandwidth and when the reader caught up with the prefetch as columns. Thresholds never reached are printed as -1.
+// The sampler only sees pages become resident, so the bandwidth also counts the pages the reader loads itself once it caught up with the prefetch
+static inline void residency_sampler_fprint(FILE *output_file, const struct residency_sampler *sampler){
+    if(!residency_sampling) return;
+    double time_to_50_ms = sampler->time_to_50_count ? sampler->time_to_50_sum/sampler->time_to_50_count*1e-6 : -1;
+    double time_to_90_ms = sampler->time_to_90_count ? sampler->time_to_90_sum/sampler->time_to_90_count*1e-6 : -1;
+    double time_to_100_ms = sampler->time_to_100_count ? sampler->time_to_100_sum/sampler->time_to_100_count*1e-6 : -1;
+    double prefetch_bandwidth = time_to_100_ms>0 ? sampler->length/(time_to_100_ms*1e-3)/(1ul << 30)
+        : time_to_90_ms>0 ? 0.9*sampler->length/(time_to_90_ms*1e-3)/(1ul << 30)
+        : time_to_50_ms>0 ? 0.5*sampler->length/(time_to_50_ms*1e-3)/(1ul << 30) : -1;
+    fprintf(output_file, ", time_to_50_resident_ms=%.3f, time_to_90_resident_ms=%.3f, time_to_100_resident_ms=%.3f, prefetch_bandwidth_gb_per_second=%.3f, "
+        "reader_start_ms=%.3f, reader_catch_up_ms=%.3f, reader_catch_up_ratio=%.3f",
+        time_to_50_ms, time_to_90_ms, time_to_100_ms, prefetch_bandwidth,
+        sampler->experiment_count ? sampler->reader_start_sum/sampler->experiment_count*1e-6 : 0,
+        sampler->catch_up_count ? sampler->catch_up_sum/sampler->catch_up_count*1e-6 : -1,
+        sampler->experiment_count ? (double)sampler->catch_up_count/sampler->experiment_count : 0);
+}
 
-                        // Running the experimentation: reading, and sometimes prefetching!
-                        fseek(fp, 0, SEEK_SET);
-                        uint64_t t1 = get_timestamp_us();
-                        for(size_t volume = 0; volume<file_size; volume+=io_size){
-                            if(volume%prefetch_size==0) aio_prefetch(fileno(fp), volume, prefetch_size);
-                            int ret = fread(buffer, sizeof(char), io_size, fp);
-                            if(__glibc_unlikely(ret < 0)){
-                                printf("Error reading file \"%s\": %s\n", TARGET_FILE, strerror(errno));
-                                exit(0);
-                            }
-                            if(io_interarrival_time_ns!=0){
-                            read_duration += get_timestamp_us()-t1;
-                            nsleep(io_interarrival_time_ns);
-                            t1 = get_timestamp_us();
-                        }
-                        }
-                        read_duration += get_timestamp_us()-t1;
-                    }
-                    fprintf(output_file, "target='%s', category='Online prefetch', label='async-io online prefetching', "
-                        #if OUTPUT_EXPERIMENT_DESCRIPTION
-                        "desc='The file is prefetched using %llu bytes llu_ladvise prefetches', "
-                        #endif
-                        "file_size=%llu, interarrival_time_us=%llu, io_size=%llu, prefetch_size=%llu, throughput_gb_per_second=%.3f\n", target_file, file_size, io_interarrival_time_ns, io_size, prefetch_size, 
-                        prefetch_size, experiment_count*file_size/(read_duration*1e-6)/(1ul << 30));
-                    free(buffer);
-                    fflush(output_file);
-                }
+// Number of streams of the current access pattern: the passes of the strided pattern, the streams of the interleaved one
+static inline uint64_t access_pattern_stream_count(){
+    if(access_pattern==ACCESS_PATTERN_STRIDED) return access_pattern_stride;
+    if(access_pattern==ACCESS_PATTERN_INTERLEAVED) return interleaved_stream_count;
+    return 1;
+}
+
+// Where the read-th of read_count reads falls in the current access pattern: the stream it belongs to, and its position in that stream.
+// The first read_count%stream_count streams are one read longer than the others
+static inline void access_pattern_locate(uint64_t read, uint64_t read_count, uint64_t *stream, uint64_t *position){
+    uint64_t stream_count = access_pattern_stream_count(), per_stream = read_count/stream_count, longer = read_count%stream_count;
+    if(access_pattern==ACCESS_PATTERN_INTERLEAVED){
+        // One read of each stream in turn, the longer streams ending alone
+        *stream = read<per_stream*stream_count ? read%stream_count : read-per_stream*stream_count;
+        *position = read<per_stream*stream_count ? read/stream_count : per_stream;
+    }else if(read<longer*(per_stream+1)){
+        // One stream after the other
+        *stream = read/(per_stream+1);
+        *position = read%(per_stream+1);
+    }else{
+        *stream = longer+(read-longer*(per_stream+1))/per_stream;
+        *position = (read-longer*(per_stream+1))%per_stream;
+    }
+}
+
+// Index of the I/O of the file a read of a stream targets
+static inline uint64_t access_pattern_block(uint64_t stream, uint64_t position, uint64_t read_count){
+    uint64_t stream_count = access_pattern_stream_count(), per_stream = read_count/stream_count, longer = read_count%stream_count;
+    switch(access_pattern){
+        case ACCESS_PATTERN_BACKWARD: return read_count-1-position;
+        case ACCESS_PATTERN_STRIDED: return stream+position*stream_count;
+        case ACCESS_PATTERN_INTERLEAVED: return stream*per_stream+(stream<longer ? stream : longer)+position;
+        default: return position;
+    }
+}
+
+// Offset of the read-th read of a file_size range read io_size at a time in the current access pattern, or file_size past the last read
+static inline uint64_t access_pattern_offset(uint64_t read, uint64_t file_size, uint64_t io_size){
+    uint64_t read_count = (file_size+io_size-1)/io_size, stream, position;
+    if(read>=read_count) return file_size;
+    access_pattern_locate(read, read_count, &stream, &position);
+    return access_pattern_block(stream, position, read_count)*io_size;
+}
+
+// Fill ranges with the hints an online strategy gives before the read-th read, when it prefetches prefetch_size bytes ahead of the stream
+// being read, and return how many there are (0 when no hint is due). ranges must hold prefetch_size/io_size+1 of them
+static inline uint64_t access_pattern_prefetch_ranges(struct access_range *ranges, uint64_t read, uint64_t file_size, uint64_t io_size, uint64_t prefetch_size){
+    uint64_t read_count = (file_size+io_size-1)/io_size, stream, position;
+    if(read>=read_count) return 0;
+    access_pattern_locate(read, read_count, &stream, &position);
+    if(position*io_size%prefetch_size!=0) return 0;
+    uint64_t offset = access_pattern_block(stream, position, read_count)*io_size;
+    uint64_t stream_count = access_pattern_stream_count(), stream_length = read_count/stream_count+(stream<read_count%stream_count);
+    switch(access_pattern){
+        case ACCESS_PATTERN_BACKWARD: {
+            // The window ends with the current read
+            uint64_t end = offset+io_size<file_size ? offset+io_size : file_size;
+            ranges[0].offset = offset+io_size>prefetch_size ? offset+io_size-prefetch_size : 0;
+            ranges[0].length = end-ranges[0].offset;
+            return 1;
+        }
+        case ACCESS_PATTERN_STRIDED: {
+            // The reads of a pass are not contiguous, so each one gets its own hint
+            uint64_t count = 0;
+            for(uint64_t p = position; p<stream_length && (p-position)*io_size<prefetch_size; p++, count++){
+                ranges[count].offset = access_pattern_block(stream, p, read_count)*io_size;
+                ranges[count].length = ranges[count].offset+io_size<file_size ? io_size : file_size-ranges[count].offset;
             }
+            return count;
+        }
+        default: {
+            // The window starts with the current read, and stops at the end of its stream
+            uint64_t end = (access_pattern_block(stream, stream_length-1, read_count)+1)*io_size;
+            if(end>file_size) end = file_size;
+            if(end>offset+prefetch_size) end = offset+prefetch_size;
+            ranges[0].offset = offset;
+            ranges[0].length = end-offset;
+            return 1;
         }
-        fclose(fp);
     }
 }
 
-int main(int argc, char **argv){
-    #ifdef WITH_LUSTRE
-    FILE *log_file = fopen("output-lustre.csv", "w");
-    #else
-    FILE *log_file = fopen("output.csv", "w");
-    #endif
-    if(log_file < 0){
-        printf("Error opening file \"output.csv\": %s\n", strerror(errno));
-        exit(0);
+// Print the access pattern column of a configuration
+static inline void access_pattern_fprint(FILE *output_file){
+    fprintf(output_file, ", access_pattern='%s'", access_pattern_names[access_pattern]);
+    if(access_pattern==ACCESS_PATTERN_STRIDED) fprintf(output_file, ", stride=%llu", access_pattern_stride);
+    if(access_pattern==ACCESS_PATTERN_INTERLEAVED) fprintf(output_file, ", stream_count=%llu", interleaved_stream_count);
+}
+
+// Forget the experiments of a write cache record
+static inline void write_cache_record_reset(struct write_cache_record *record){
+    memset(record, 0, sizeof(struct write_cache_record));
+    record->dirty_known = true;
+    record->resident_known = true;
+}
+
+// Snapshot the dirty, under writeback and resident pages of a range right after the last write of an experiment
+static inline void write_cache_record_after_write(struct write_cache_record *record, int fd, uint64_t offset, uint64_t length){
+    uint64_t page_size = sysconf(_SC_PAGESIZE), page_count = (length+page_size-1)/page_size;
+    struct cachestat_range range = {offset, length};
+    struct cachestat stat;
+    if(syscall(__NR_cachestat, fd, &range, &stat, 0)==0){
+        record->dirty_sum += (double)stat.nr_dirty/page_count;
+        record->writeback_sum += (double)stat.nr_writeback/page_count;
+        record->resident_sum += (double)stat.nr_cache/page_count;
+    }else{
+        record->dirty_known = false;
+        double fraction = client_cache_resident_fraction(fd, offset, length);
+        if(fraction<0) record->resident_known = false;
+        record->resident_sum += fraction;
     }
-    perform_baseline_benchmark(TARGET_FILE, log_file);
-    perform_offline_prefetch_benchmark(TARGET_FILE, log_file);
-    perform_jit_prefetch_benchmark(TARGET_FILE, log_file);
-    perform_online_prefetch_benchmark(TARGET_FILE, log_file);
-    fclose(log_file);
+    record->count++;
 }
 
-// Used for throughput instrumentation 
-static inline uint64_t get_timestamp_us(){
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    return tv.tv_sec*(uint64_t)1e6+tv.tv_usec;
+// Snapshot the resident pages of a range once the experiment is flushed
+static inline void write_cache_record_after_sync(struct write_cache_record *record, int fd, uint64_t offset, uint64_t length){
+    double fraction = client_cache_resident_fraction(fd, offset, length);
+    if(fraction<0) record->resident_known = false;
+    record->resident_after_sync_sum += fraction;
 }
 
-// Use /proc/sys/vm/drop_caches to drop the client page cache 
-static inline void client_cache_drop(int fd){
-    sync();
-    char *data = "3";
-    int fd2 = open("/proc/sys/vm/drop_caches", O_WRONLY);
-    if(fd2<0){
-        printf("Could not open file \"/proc/sys/vm/drop_caches\": %s\n", strerror(errno));
+// Print the throughput including the final flush and the mean page cache fractions as columns. Dirty fractions are -1 without cachestat,
+// and resident ones when they could not be measured
+static inline void write_cache_record_fprint(FILE *output_file, const struct write_cache_record *record, uint64_t volume, uint64_t write_duration){
+    int count = record->count>0 ? record->count : 1;
+    fprintf(output_file, ", durable_throughput_gb_per_second=%.3f, sync_ms=%.3f, dirty_after_write=%.3f, writeback_after_write=%.3f, resident_after_write=%.3f, resident_after_sync=%.3f",
+        write_duration+record->sync_duration>0 ? volume/((write_duration+record->sync_duration)*1e-6)/(1ul << 30) : 0, record->sync_duration*1e-3/count,
+        record->dirty_known ? record->dirty_sum/count : -1, record->dirty_known ? record->writeback_sum/count : -1,
+        record->resident_known ? record->resident_sum/count : -1, record->resident_known ? record->resident_after_sync_sum/count : -1);
+}
+
+// Start writing back a window that was just written, then wait for the previous one to be on disk, and drop it from the page cache if asked
+static inline void write_behind(int fd, uint64_t offset, uint64_t length, uint64_t previous_offset, uint64_t previous_length, bool drop){
+    uint64_t start_ns = event_trace_now();
+    int ret = sync_file_range(fd, offset, length, SYNC_FILE_RANGE_WRITE);
+    event_trace_record(EVENT_HINT_SYNC_FILE_RANGE, start_ns, offset, length, ret);
+    if(previous_length==0) return;
+    start_ns = event_trace_now();
+    ret = sync_file_range(fd, previous_offset, previous_length, SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+    event_trace_record(EVENT_HINT_SYNC_FILE_RANGE, start_ns, previous_offset, previous_length, ret);
+    if(!drop) return;
+
+    // Clean pages can be dropped right away, while DONTNEED on dirty ones would be ignored
+    start_ns = event_trace_now();
+    ret = posix_fadvise(fd, previous_offset, previous_length, POSIX_FADV_DONTNEED);
+    event_trace_record(EVENT_HINT_FADVISE, start_ns, previous_offset, previous_length, ret);
+}
+
+// Create the target file, and fill its first file_size bytes with the deterministic content of the libiohints generator
+static void generate_target_file(const char *path, uint64_t file_size){
+    uint64_t t1 = get_timestamp_us();
+    int thread_count = iohints_generate_file(path, file_size);
+    if(thread_count<0){
+        printf("Error generating file \"%s\": %s\n", path, strerror(errno));
         exit(0);
     }
-    int ret = write(fd2, data, sizeof(char));
-    if(ret<0){
-        printf("Could not write in file \"/proc/sys/vm/drop_caches\": %s\n", strerror(errno));
-        exit(0);
+    uint64_t duration = get_timestamp_us()-t1;
+    printf("Generated \"%s\": %.3f GB in %.3f s (%.3f GB/s) with %d threads\n", path, file_size/(double)(1ul << 30), duration*1e-6,
+        file_size/(duration*1e-6)/(1ul << 30), thread_count);
+}
+
+#ifdef WITH_MPI
+// Number of I/Os each rank of the MPI benchmark reads. The tail of the file might be left unread
+static inline uint64_t mpi_layout_read_count(uint64_t file_size, uint64_t io_size){
+    return (file_size/io_size)/mpi_rank_count;
+}
+
+// Fill offsets with the offsets of the I/Os the calling rank reads in a layout, in the order it reads them
+static inline void mpi_layout_offsets(uint64_t *offsets, enum mpi_layout layout, uint64_t file_size, uint64_t io_size){
+    uint64_t io_count = file_size/io_size;
+    uint64_t read_count = mpi_layout_read_count(file_size, io_size);
+    uint64_t state = MPI_LAYOUT_SEED^(mpi_rank*0x9e3779b97f4a7c15ull); // Each rank draws its own offsets, the same ones in every run
+    for(uint64_t r = 0; r<read_count; r++){
+        switch(layout){
+            case MPI_LAYOUT_CONTIGUOUS: offsets[r] = (mpi_rank*read_count+r)*io_size; break; // A block of the file per rank
+            case MPI_LAYOUT_STRIDED: offsets[r] = (r*mpi_rank_count+mpi_rank)*io_size; break; // Ranks take the I/Os of the file in turn
+            default:{
+                uint64_t z = (state += 0x9e3779b97f4a7c15ull); // splitmix64
+                z = (z^(z >> 30))*0xbf58476d1ce4e5b9ull;
+                z = (z^(z >> 27))*0x94d049bb133111ebull;
+                offsets[r] = ((z^(z >> 31))%io_count)*io_size;
+            }
+        }
     }
-    close(fd2);
+}
 
-    #ifndef WITH_LUSTRE
-    char *buffer = malloc(SECONDARY_IO_SIZE);
-    for(int i = 0; i<SECONDARY_IO_COUNT; i++){
-        read(fd, buffer, SECONDARY_IO_SIZE);
+// Fill ranges with what to prefetch before the read-th I/O of a rank: nothing, unless it starts a window of prefetch size, in which
+// case the I/Os of the window, contiguous ones merged. Return how many ranges were written, at most prefetch_size/io_size
+static inline uint64_t mpi_prefetch_ranges(struct access_range *ranges, const uint64_t *offsets, uint64_t read, uint64_t read_count, uint64_t io_size, uint64_t prefetch_size){
+    uint64_t window = prefetch_size/io_size;
+    if(window==0 || read%window!=0) return 0;
+    uint64_t range_count = 0;
+    for(uint64_t r = read; r<read+window && r<read_count; r++){
+        if(range_count>0 && ranges[range_count-1].offset+ranges[range_count-1].length==offsets[r]) ranges[range_count-1].length += io_size;
+        else ranges[range_count++] = (struct access_range){offsets[r], io_size};
     }
-    free(buffer);
-    #endif
-    sync();
+    return range_count;
 }
 
-// Use fadvise to evict some data from the client page cache 
-static inline void client_cache_evict(int fd, uint64_t offset, uint64_t length){
-    posix_fadvise(fd, offset, offset+length, POSIX_FADV_DONTNEED);
+// Join the MPI job: find out the rank of this process, and which ranks share its node
+static void mpi_start(int *argc, char ***argv){
+    MPI_Init(argc, argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpi_rank_count);
+
+    // Ranks of a node share its page cache, which only one of them has to drop
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &mpi_node_comm);
+    MPI_Comm_rank(mpi_node_comm, &mpi_node_rank);
+    int node_leader = mpi_node_rank==0;
+    MPI_Allreduce(&node_leader, &mpi_node_count, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
 }
 
-// Use lla_ladvise to evict some data from the server page cache
-#ifdef WITH_LUSTRE
-static inline void server_cache_evict(int fd, uint64_t offset, uint64_t length){
-    struct llapi_lu_ladvise advises;
-    memset(&advises, 0, sizeof(struct llapi_lu_ladvise));
-    advises.lla_advice = LU_LADVISE_DONTNEED;
-    advises.lla_start = offset;
-    advises.lla_end = offset+length;
-    llapi_ladvise(fd, 0, 1, &advises);
+// Decide on rank 0 whether another experiment is needed, from the totals of every rank, and tell every rank
+static inline bool mpi_repetition_continue(struct repetition *repetition, uint64_t volume, uint64_t read_duration){
+    int again = 0;
+    if(mpi_rank==0) again = repetition_continue(repetition, volume, read_duration);
+    MPI_Bcast(&again, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    return again;
 }
-#endif
 
-// Use fadvise to prefetch some data to the client page cache  
-static inline void client_cache_prefetch(int fd, uint64_t offset, uint64_t length){
-    posix_fadvise(fd, offset, length, POSIX_FADV_WILLNEED);
+// Reduce the throughput of every rank to their mean, minimum and maximum on rank 0
+static inline void mpi_rank_throughputs_reduce(double rank_throughput, double *mean, double *min, double *max){
+    *mean = *min = *max = 0;
+    MPI_Reduce(&rank_throughput, min, 1, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&rank_throughput, max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&rank_throughput, mean, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    *mean /= mpi_rank_count;
 }
 
-// Use lla_ladvise to prefetch some data to the server page cache
-#ifdef WITH_LUSTRE
-static inline void server_cache_prefetch(int fd, uint64_t offset, uint64_t length){
-    struct llapi_lu_ladvise advises;
-    memset(&advises, 0, sizeof(struct llapi_lu_ladvise));
-    advises.lla_advice = LU_LADVISE_WILLREAD;
-    advises.lla_start = offset;
-    advises.lla_end = offset + length;
-    llapi_ladvise(fd, 0, 1, &advises);
+// Merge the latency histograms of every rank into destination on rank 0
+static inline void mpi_latency_histogram_reduce(struct latency_histogram *destination, const struct latency_histogram *source){
+    latency_histogram_reset(destination);
+    MPI_Reduce(source->counts, destination->counts, LATENCY_HISTOGRAM_BUCKET_COUNT, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&source->count, &destination->count, 1, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&source->max, &destination->max, 1, MPI_UINT64_T, MPI_MAX, 0, MPI_COMM_WORLD);
+}
+
+// Create the MPI_Info hints of the MPI-IO benchmark for a layout, to be freed with MPI_Info_free
+static MPI_Info mpiio_hints_create(enum mpi_layout layout){
+    MPI_Info info;
+    MPI_Info_create(&info);
+    MPI_Info_set(info, "access_style", layout==MPI_LAYOUT_RANDOM ? "read_once,random" : "read_once,sequential");
+    MPI_Info_set(info, "romio_cb_read", MPIIO_HINT_ROMIO_CB_READ);
+    MPI_Info_set(info, "cb_buffer_size", MPIIO_HINT_CB_BUFFER_SIZE);
+    char cb_nodes[16];
+    snprintf(cb_nodes, sizeof(cb_nodes), "%d", mpi_node_count);
+    MPI_Info_set(info, "cb_nodes", cb_nodes);
+    MPI_Info_set(info, "romio_ds_read", MPIIO_HINT_ROMIO_DS_READ);
+    return info;
+}
+
+// Exit with an error message when an MPI-IO call on the target file did not succeed. action is e.g. "opening" or "reading"
+static inline void mpiio_check(int ret, const char *action){
+    if(__glibc_likely(ret==MPI_SUCCESS)) return;
+    char message[MPI_MAX_ERROR_STRING];
+    int length;
+    MPI_Error_string(ret, message, &length);
+    printf("Error %s file \"%s\": %s\n", action, target_file_path, message);
+    exit(0);
+}
+
+// Print the mpiio_hint_keys hints of an opened file, as the MPI-IO implementation applied them ('' when it ignored them)
+static void mpiio_hints_fprint(FILE *output_file, MPI_File file){
+    MPI_Info info;
+    MPI_File_get_info(file, &info);
+    for(size_t k = 0; k<sizeof(mpiio_hint_keys)/sizeof(mpiio_hint_keys[0]); k++){
+        char value[MPI_MAX_INFO_VAL+1] = "";
+        int flag;
+        MPI_Info_get(info, mpiio_hint_keys[k], MPI_MAX_INFO_VAL, value, &flag);
+        fprintf(output_file, ", %s='%s'", mpiio_hint_keys[k], flag ? value : "");
+    }
+    MPI_Info_free(&info);
 }
 #endif
 
-// Use asynchronous I/O to forcefully prefetch some data 
-static inline void aio_prefetch(int fd, uint64_t offset, uint64_t length){
-    static char *buffer = 0;
-    if(buffer == 0) buffer = malloc(sizeof(char)*file_sizes[file_size_count-1]);
-    off_t current_offset = lseek(fd, 0, SEEK_CUR);
-    struct aiocb aiocbp;
-    memset(&aiocbp, 0, sizeof(struct aiocb));
-    aiocbp.aio_fildes = fd;
-    aiocbp.aio_buf = buffer;
-    aiocbp.aio_nbytes = length;
-    aiocbp.aio_offset = offset; // No need to lseek
-    aiocbp.aio_sigevent.sigev_notify = SIGEV_NONE;
-    aio_read(&aiocbp);
-    lseek(fd, current_offset, SEEK_SET);
+// Plain reader mode: read the target with read() calls and print the read time, which the interposer strategies collect
+static void perform_plain_read(){
+    uint64_t file_size = file_sizes[0], io_size = io_sizes[0], io_interarrival_time_ns = io_interarrival_times[0];
+    access_pattern = access_patterns[0];
+    interleaved_stream_count = access_pattern==ACCESS_PATTERN_INTERLEAVED ? interleaved_stream_counts[0] : 1;
+    int fd = open(target_file_path, O_RDONLY);
+    if(fd<0){
+        printf("Error opening file \"%s\": %s\n", target_file_path, strerror(errno));
+        exit(0);
+    }
+    char *buffer = malloc(sizeof(char)*io_size);
+
+    // Forward reads go on from the previous one, as most applications read files. The other patterns seek first
+    struct pacer pacer;
+    pacer_reset(&pacer, io_interarrival_time_ns, 0);
+    uint64_t read_duration = 0, t1 = get_timestamp_us();
+    for(size_t volume = 0; volume<file_size; volume+=io_size){
+        uint64_t offset = access_pattern_offset(volume/io_size, file_size, io_size), length = io_size<file_size-offset ? io_size : file_size-offset;
+        if(access_pattern!=ACCESS_PATTERN_FORWARD) lseek(fd, offset, SEEK_SET);
+        if(__glibc_unlikely(read(fd, buffer, length) < 0)){
+            printf("Error reading file \"%s\": %s\n", target_file_path, strerror(errno));
+            exit(0);
+        }
+        if(io_interarrival_time_ns!=0){
+            read_duration += get_timestamp_us()-t1;
+            pacer_wait(&pacer);
+            t1 = get_timestamp_us();
+        }
+    }
+    read_duration += get_timestamp_us()-t1;
+    printf("%llu\n", read_duration);
+    free(buffer);
+    close(fd);
+}
+
+// Run the plain reader in a new process, with the interposer preloaded when the strategy hints
+static uint64_t plain_reader_run(enum interposer_strategy strategy, uint64_t file_size, uint64_t io_size, uint64_t io_interarrival_time_ns){
+    int pipe_fds[2];
+    if(pipe(pipe_fds)<0){
+        printf("Could not create a pipe for the plain reader: %s\n", strerror(errno));
+        exit(0);
+    }
+    fflush(stdout);
+    pid_t pid = fork();
+    if(pid<0){
+        printf("Could not start the plain reader: %s\n", strerror(errno));
+        exit(0);
+    }
+    if(pid==0){
+        // The reader prints its read time, or what went wrong, on its standard output
+        dup2(pipe_fds[1], STDOUT_FILENO);
+        close(pipe_fds[0]);
+        close(pipe_fds[1]);
+        char *arguments[11] = {"prefetch-benchmark", "--plain-reader"};
+        asprintf(&arguments[2], "--target=%s", target_file_path);
+        asprintf(&arguments[3], "--file-sizes=%llu", file_size);
+        asprintf(&arguments[4], "--io-sizes=%llu", io_size);
+        asprintf(&arguments[5], "--interarrival-times=%llu", io_interarrival_time_ns);
+        asprintf(&arguments[6], "--arrivals=%s", arrival_schedule_names[arrival_schedule]);
+        asprintf(&arguments[7], "--patterns=%s", access_pattern_names[access_pattern]);
+        asprintf(&arguments[8], "--stride=%llu", access_pattern_stride);
+        asprintf(&arguments[9], "--streams=%llu", interleaved_stream_count);
+        arguments[10] = NULL;
+        if(interposer_strategy_hints[strategy]==NULL) unsetenv("LD_PRELOAD");
+        else{
+            setenv("LD_PRELOAD", interposer_path, 1);
+            setenv("IOHINTS_PRELOAD_HINT", interposer_strategy_hints[strategy], 1);
+            // Debug builds link the address sanitizer, which otherwise refuses to come after a preloaded library
+            setenv("ASAN_OPTIONS", "verify_asan_link_order=0", 1);
+        }
+        execv("/proc/self/exe", arguments);
+        printf("Could not run the plain reader: %s\n", strerror(errno));
+        fflush(stdout);
+        _exit(0); // The buffers of the output files belong to the parent
+    }
+
+    close(pipe_fds[1]);
+    char output[4096];
+    size_t length = 0;
+    ssize_t ret;
+    while(length<sizeof(output)-1 && (ret = read(pipe_fds[0], output+length, sizeof(output)-1-length))>0) length += ret;
+    output[length] = 0;
+    close(pipe_fds[0]);
+    waitpid(pid, NULL, 0);
+    unsigned long long read_duration;
+    if(sscanf(output, "%llu", &read_duration)!=1){
+        printf("The plain reader failed: %s\n", output);
+        exit(0);
+    }
+    return read_duration;
 }